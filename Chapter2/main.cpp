@@ -10,6 +10,23 @@
 #include <GraphicsAPI_OpenGL.h>
 //#include <GraphicsAPI_OpenGL_ES.h>
 //#include <GraphicsAPI_Vulkan.h>
+#include <AdaptiveQuality.h>
+#include <AssetArchive.h>
+#include <AutoTuner.h>
+#include <BatchRenderer.h>
+#include <FarFieldReprojection.h>
+#include <FixedTimestepSimulation.h>
+#include <FrameTrace.h>
+#include <HalfResolutionTransparency.h>
+#include <IdleTaskScheduler.h>
+#include <JustInTimeFrameStart.h>
+#include <PerfCounters.h>
+#include <PosePrefetcher.h>
+#include <SplitRendering.h>
+#include <StressScene.h>
+#include <TemporalUpscaler.h>
+#include <VideoLayer.h>
+#include <ViewOverlap.h>
 #include <OpenXRDebugUtils.h>
 #include <memory>
 
@@ -28,6 +45,72 @@ public:
 	}
 	~OpenXRTutorial() = default;
 
+	// Renders the views on a split rendering server instead of locally. Call before Run().
+	void SetSplitRenderingServer(const std::string& address)
+	{
+		m_splitRenderingAddress = address;
+	}
+
+	// Renders content beyond the far field distance once and reprojects it into each view. Call before Run().
+	void SetFarFieldEnabled(bool enabled)
+	{
+		m_farFieldEnabled = enabled;
+	}
+
+	// Renders transparent content at half resolution and upsamples it over each view. Call before Run().
+	void SetHalfResolutionTransparencyEnabled(bool enabled)
+	{
+		m_halfResolutionTransparencyEnabled = enabled;
+	}
+
+	// Renders the views at a reduced resolution and temporally upscales them. Call before Run().
+	void SetTemporalUpscalingEnabled(bool enabled)
+	{
+		m_temporalUpscalingEnabled = enabled;
+	}
+
+	// Records the frame timing and writes it to m_frameTracePath at the end of the session. Call before Run().
+	void SetFrameTraceEnabled(bool enabled)
+	{
+		m_frameTraceEnabled = enabled;
+	}
+
+	// Samples hardware performance counters around the phases of the frame loop. They are logged and exported with the
+	// frame trace, so this also enables the frame trace. Call before Run().
+	void SetPerfCountersEnabled(bool enabled)
+	{
+		m_perfCountersEnabled = enabled;
+		m_frameTraceEnabled = m_frameTraceEnabled || enabled;
+	}
+
+	// Delays the start of cheap frames to reduce the pose latency. It learns the frame cost from the frame trace, so this
+	// also enables the frame trace. Call before Run().
+	void SetJustInTimeFrameStartEnabled(bool enabled)
+	{
+		m_justInTimeFrameStartEnabled = enabled;
+		m_frameTraceEnabled = m_frameTraceEnabled || enabled;
+	}
+
+	// Tunes the rendering settings on the first start on a device, and uses the settings stored for the device
+	// afterwards. Call before Run().
+	void SetAutoTuneEnabled(bool enabled)
+	{
+		m_autoTuneEnabled = enabled;
+	}
+
+	// Tunes the rendering settings again, instead of using the settings stored for the device. Call before Run().
+	void SetAutoTuneRetune(bool retune)
+	{
+		m_autoTuneRetune = retune;
+	}
+
+	// Plays a YUV4MPEG2 video in a 360 degree equirect layer, or in a quad layer in front of the user. Call before Run().
+	void SetVideo(const std::string& path, bool equirect)
+	{
+		m_videoPath = path;
+		m_videoEquirect = equirect;
+	}
+
 	void Run()
 	{
 		CreateInstance();
@@ -67,6 +150,15 @@ private:
 		// Add both required and requested instance extensions.
 		{
 			m_instanceExtensions.push_back(XR_EXT_DEBUG_UTILS_EXTENSION_NAME);
+			// Optional extensions are only requested if the OpenXR runtime supports them.
+			m_optionalInstanceExtensions.push_back(XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME);
+#if defined(XR_USE_TIMESPEC)
+			m_optionalInstanceExtensions.push_back(XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME);
+#endif
+			// Quad views: a high resolution inset view within a low resolution peripheral view per eye.
+			m_optionalInstanceExtensions.push_back(XR_VARJO_QUAD_VIEWS_EXTENSION_NAME);
+			// Equirect layers for 360 degree video.
+			m_optionalInstanceExtensions.push_back(XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME);
 			// Ensure m_APIType is already defined when we call this line.
 			m_instanceExtensions.push_back(GetGraphicsAPIInstanceExtensionString(m_APIType));
 		}
@@ -99,6 +191,17 @@ private:
 		extensionProperties.resize(extensionCount, { XR_TYPE_EXTENSION_PROPERTIES });
 		OPENXR_CHECK(xrEnumerateInstanceExtensionProperties(nullptr, extensionCount, &extensionCount, extensionProperties.data()), "Failed to enumerate InstanceExtensionProperties.");
 
+		// Add the optional Instance Extensions that the OpenXR runtime supports to the requested ones.
+		for (auto& optionalInstanceExtension : m_optionalInstanceExtensions) {
+			for (auto& extensionProperty : extensionProperties) {
+				// strcmp returns 0 if the strings match.
+				if (strcmp(optionalInstanceExtension.c_str(), extensionProperty.extensionName) == 0) {
+					m_instanceExtensions.push_back(optionalInstanceExtension);
+					break;
+				}
+			}
+		}
+
 		// Check the requested Instance Extensions against the ones from the OpenXR runtime.
 		// If an extension is found add it to Active Instance Extensions.
 		// Log error if the Instance Extension is not found.
@@ -186,10 +289,106 @@ private:
 		sessionCreateInfo.createFlags = 0;
 		sessionCreateInfo.systemId = m_systemID;
 		OPENXR_CHECK(xrCreateSession(m_xrInstance, &sessionCreateInfo, &m_Session), "Failed to create Session.");
+
+		// Load xrPerfSettingsSetPerformanceLevelEXT() function pointer as it is not default loaded by the OpenXR loader.
+		if (IsStringInVector(m_activeInstanceExtensions, XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME)) {
+			OPENXR_CHECK(xrGetInstanceProcAddr(m_xrInstance, "xrPerfSettingsSetPerformanceLevelEXT", (PFN_xrVoidFunction*)&m_xrPerfSettingsSetPerformanceLevelEXT), "Failed to get InstanceProcAddr.");
+		}
+
+		// Hardware performance counters of the frame thread, per phase of the frame loop.
+		if (m_perfCountersEnabled) {
+			m_perfCounters = std::make_unique<PerfCounters>();
+			m_perfPhaseRenderFrame = m_perfCounters->GetPhase("RenderFrame");
+			m_perfPhaseRenderLayer = m_perfCounters->GetPhase("RenderLayer");
+			m_perfPhaseCulling = m_perfCounters->GetPhase("Culling");
+			m_perfPhaseRecording = m_perfCounters->GetPhase("Recording");
+		}
+
+		if (m_frameTraceEnabled) {
+			bool convertTimespecTimeEnabled = false;
+#if defined(XR_USE_TIMESPEC)
+			convertTimespecTimeEnabled = IsStringInVector(m_activeInstanceExtensions, XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME);
+#endif
+			m_frameTrace = std::make_unique<FrameTrace>(m_xrInstance, m_GraphicsAPI.get(), convertTimespecTimeEnabled);
+
+			// The just-in-time frame start learns the frame cost from the frame trace.
+			if (m_justInTimeFrameStartEnabled) {
+				m_justInTimeFrameStart = std::make_unique<JustInTimeFrameStart>(JustInTimeFrameStart::CreateInfo());
+			}
+		}
+
+		// With split rendering, the views are rendered by the server and streamed back.
+		if (!m_splitRenderingAddress.empty()) {
+			m_splitRenderClient = std::make_unique<SplitRenderClient>(m_splitRenderingAddress);
+			if (!m_splitRenderClient->IsConnected()) {
+				XR_TUT_LOG_ERROR("Failed to connect to the split rendering server at " << m_splitRenderingAddress << ". Rendering locally.");
+				m_splitRenderClient.reset();
+			}
+			else if (m_viewConfigurationViews.size() > SplitRenderingConnection::maxViews) {
+				XR_TUT_LOG_ERROR("Split rendering supports up to " << SplitRenderingConnection::maxViews << " views, the view configuration has " << m_viewConfigurationViews.size() << ". Rendering locally.");
+				m_splitRenderClient.reset();
+			}
+		}
+	}
+
+	void AutoTune(XrDuration displayPeriod)
+	{
+		const std::string deviceKey = AutoTuner::GetDeviceKey(m_GraphicsAPI.get(), m_systemProperties.systemName);
+		if (m_autoTuneRetune || !AutoTuner::LoadSettings(m_autoTunePath, deviceKey, m_autoTuneSettings)) {
+			XR_TUT_LOG("Auto-tuning the rendering settings for " << deviceKey);
+			AutoTuner::CreateInfo autoTunerCI;
+			for (const XrViewConfigurationView& viewConfigurationView : m_viewConfigurationViews) {
+				autoTunerCI.viewSizes.push_back({ viewConfigurationView.recommendedImageRectWidth, viewConfigurationView.recommendedImageRectHeight });
+			}
+			autoTunerCI.colorFormat = m_colorSwapchainInfos[0].swapchainFormat;
+			autoTunerCI.depthFormat = m_depthSwapchainInfos[0].swapchainFormat;
+			autoTunerCI.frameBudgetMs = static_cast<float>(displayPeriod) * 1e-6f;
+			m_autoTuneSettings = AutoTuner(m_GraphicsAPI.get(), autoTunerCI).Tune();
+			if (!AutoTuner::SaveSettings(m_autoTunePath, deviceKey, m_autoTuneSettings)) {
+				XR_TUT_LOG_ERROR("Failed to save the auto-tuned settings to " << m_autoTunePath);
+			}
+		}
+		XR_TUT_LOG("Auto-Tuned Resolution Scale: " << m_autoTuneSettings.resolutionScale << " MSAA: " << m_autoTuneSettings.msaaSampleCount << " Multiview: " << m_autoTuneSettings.multiview << " Buffer Updates: " << AutoTuner::ToString(m_autoTuneSettings.bufferUpdateStrategy));
+
+		// The tuned settings are the highest quality tier. The default tiers below them remain for the performance
+		// notifications to step down to.
+		std::vector<AdaptiveQualityController::QualityTier> tiers = {{m_autoTuneSettings.resolutionScale, m_autoTuneSettings.msaaSampleCount}};
+		for (const AdaptiveQualityController::QualityTier& tier : AdaptiveQualityController::GetDefaultTiers(m_viewConfigurationViews[0].recommendedSwapchainSampleCount)) {
+			const bool lower = tier.resolutionScale < tiers[0].resolutionScale || tier.msaaSampleCount < tiers[0].msaaSampleCount;
+			if (lower && tier.resolutionScale <= tiers[0].resolutionScale && tier.msaaSampleCount <= tiers[0].msaaSampleCount) {
+				tiers.push_back(tier);
+			}
+		}
+		m_adaptiveQuality = AdaptiveQualityController(tiers);
+
+		// Recreate the render targets for the tuned tier.
+		RetireViewRenderTargets();
+		CreateViewRenderTargets();
 	}
 
 	void DestroySession()
 	{
+		// Export the frame timings, lined up with CLOCK_MONOTONIC, before the GPU queries are destroyed.
+		if (m_frameTrace) {
+			LogLatencyStatistics(true);
+			std::vector<std::pair<std::string, std::string>> otherData;
+			if (m_perfCounters) {
+				otherData.push_back({ "perfCounters", m_perfCounters->GetStatisticsJSON() });
+			}
+			otherData.push_back({ "posePrefetcher", m_posePrefetcher.GetStatisticsJSON() });
+			if (m_frameTrace->Export(m_frameTracePath, otherData)) {
+				XR_TUT_LOG("Frame trace written to " << m_frameTracePath);
+			}
+			m_justInTimeFrameStart.reset();
+			m_frameTrace.reset();
+		}
+
+		m_splitRenderClient.reset();
+		if (m_splitRenderStagingBuffer) {
+			m_GraphicsAPI->DestroyBuffer(m_splitRenderStagingBuffer);
+			m_splitRenderStagingBuffer = nullptr;
+		}
+
 		// Destroy the XrSession.
 		OPENXR_CHECK(xrDestroySession(m_Session), "Failed to destroy Session.");
 	}
@@ -245,6 +444,14 @@ private:
 				}
 				break;
 			}
+			// Log the performance settings notification and pass it to the adaptive quality controller.
+			case XR_TYPE_EVENT_DATA_PERF_SETTINGS_EXT:
+			{
+				XrEventDataPerfSettingsEXT* perfSettings = reinterpret_cast<XrEventDataPerfSettingsEXT*>(&eventData);
+				XR_TUT_LOG("OPENXR: Performance Settings: Domain: " << perfSettings->domain << " Sub Domain: " << perfSettings->subDomain << " Level: " << perfSettings->fromLevel << " -> " << perfSettings->toLevel);
+				m_adaptiveQuality.OnNotification(*perfSettings);
+				break;
+			}
 			// Session State changes:
 			case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED:
 			{
@@ -303,7 +510,11 @@ private:
 		OPENXR_CHECK(xrEnumerateViewConfigurations(m_xrInstance, m_systemID, viewConfigurationCount, &viewConfigurationCount, m_viewConfigurations.data()), "Failed to enumerate View Configurations.");
 
 		// Pick the first application supported View Configuration Type con supported by the hardware.
+		// The quad view configuration is only available if its extension is active.
 		for (const XrViewConfigurationType& viewConfiguration : m_applicationViewConfigurations) {
+			if (viewConfiguration == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO && !IsStringInVector(m_activeInstanceExtensions, XR_VARJO_QUAD_VIEWS_EXTENSION_NAME)) {
+				continue;
+			}
 			if (std::find(m_viewConfigurations.begin(), m_viewConfigurations.end(), viewConfiguration) != m_viewConfigurations.end()) {
 				m_viewConfiguration = viewConfiguration;
 				break;
@@ -319,6 +530,9 @@ private:
 		OPENXR_CHECK(xrEnumerateViewConfigurationViews(m_xrInstance, m_systemID, m_viewConfiguration, 0, &viewConfigurationViewCount, nullptr), "Failed to enumerate ViewConfiguration Views.");
 		m_viewConfigurationViews.resize(viewConfigurationViewCount, { XR_TYPE_VIEW_CONFIGURATION_VIEW });
 		OPENXR_CHECK(xrEnumerateViewConfigurationViews(m_xrInstance, m_systemID, m_viewConfiguration, viewConfigurationViewCount, &viewConfigurationViewCount, m_viewConfigurationViews.data()), "Failed to enumerate ViewConfiguration Views.");
+
+		// The highest quality tier renders straight into the swapchain images, with their recommended sample count.
+		m_adaptiveQuality = AdaptiveQualityController(AdaptiveQualityController::GetDefaultTiers(m_viewConfigurationViews[0].recommendedSwapchainSampleCount));
 	}
 
 	void CreateSwapchains()
@@ -356,6 +570,7 @@ private:
 			swapchainCI.mipCount = 1;
 			OPENXR_CHECK(xrCreateSwapchain(m_Session, &swapchainCI, &colorSwapchainInfo.swapchain), "Failed to create Color Swapchain");
 			colorSwapchainInfo.swapchainFormat = swapchainCI.format;  // Save the swapchain format for later use.
+			XrSwapchainCreateInfo colorSwapchainCI = swapchainCI;
 
 			// Depth.
 			swapchainCI.createFlags = 0;
@@ -369,17 +584,20 @@ private:
 			swapchainCI.mipCount = 1;
 			OPENXR_CHECK(xrCreateSwapchain(m_Session, &swapchainCI, &depthSwapchainInfo.swapchain), "Failed to create Depth Swapchain");
 			depthSwapchainInfo.swapchainFormat = swapchainCI.format;  // Save the swapchain format for later use.
+			XrSwapchainCreateInfo depthSwapchainCI = swapchainCI;
 
 			// Get the number of images in the color/depth swapchain and allocate Swapchain image data via GraphicsAPI to store the returned array.
 			uint32_t colorSwapchainImageCount = 0;
 			OPENXR_CHECK(xrEnumerateSwapchainImages(colorSwapchainInfo.swapchain, 0, &colorSwapchainImageCount, nullptr), "Failed to enumerate Color Swapchain Images.");
 			XrSwapchainImageBaseHeader* colorSwapchainImages = m_GraphicsAPI->AllocateSwapchainImageData(colorSwapchainInfo.swapchain, GraphicsAPI::SwapchainType::COLOR, colorSwapchainImageCount);
 			OPENXR_CHECK(xrEnumerateSwapchainImages(colorSwapchainInfo.swapchain, colorSwapchainImageCount, &colorSwapchainImageCount, colorSwapchainImages), "Failed to enumerate Color Swapchain Images.");
+			m_GraphicsAPI->RegisterSwapchainImages(colorSwapchainInfo.swapchain, colorSwapchainCI);
 
 			uint32_t depthSwapchainImageCount = 0;
 			OPENXR_CHECK(xrEnumerateSwapchainImages(depthSwapchainInfo.swapchain, 0, &depthSwapchainImageCount, nullptr), "Failed to enumerate Depth Swapchain Images.");
 			XrSwapchainImageBaseHeader* depthSwapchainImages = m_GraphicsAPI->AllocateSwapchainImageData(depthSwapchainInfo.swapchain, GraphicsAPI::SwapchainType::DEPTH, depthSwapchainImageCount);
 			OPENXR_CHECK(xrEnumerateSwapchainImages(depthSwapchainInfo.swapchain, depthSwapchainImageCount, &depthSwapchainImageCount, depthSwapchainImages), "Failed to enumerate Depth Swapchain Images.");
+			m_GraphicsAPI->RegisterSwapchainImages(depthSwapchainInfo.swapchain, depthSwapchainCI);
 
 			// Per image in the swapchains, fill out a GraphicsAPI::ImageViewCreateInfo structure and create a color/depth image view.
 			for (uint32_t j = 0; j < colorSwapchainImageCount; j++) {
@@ -409,10 +627,202 @@ private:
 				depthSwapchainInfo.imageViews.push_back(m_GraphicsAPI->CreateImageView(imageViewCI));
 			}
 		}
+
+		// Far field content is rendered once into a mono target matching the first view, and reprojected into every view.
+		if (m_farFieldEnabled && m_viewConfigurationViews.size() > 1)
+		{
+			m_farFieldReprojection = std::make_unique<FarFieldReprojection>(m_GraphicsAPI.get(), m_viewConfigurationViews[0].recommendedImageRectWidth, m_viewConfigurationViews[0].recommendedImageRectHeight,
+				m_colorSwapchainInfos[0].swapchainFormat, m_depthSwapchainInfos[0].swapchainFormat, m_farFieldDistance);
+		}
+
+		CreateViewRenderTargets();
+
+		if (!m_videoPath.empty())
+		{
+			CreateVideoLayer(formats);
+		}
+	}
+
+	void CreateVideoLayer(const std::vector<int64_t>& formats)
+	{
+		std::unique_ptr<Y4MDecoder> decoder = std::make_unique<Y4MDecoder>(m_videoPath);
+		if (!decoder->IsValid())
+		{
+			return;
+		}
+		if (m_videoEquirect && !IsStringInVector(m_activeInstanceExtensions, XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME))
+		{
+			XR_TUT_LOG_ERROR(XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME << " is not supported. Playing the video in a quad layer.");
+			m_videoEquirect = false;
+		}
+
+		// The swapchain is only ever written by the conversion pass, at the video's resolution.
+		XrSwapchainCreateInfo swapchainCI{ XR_TYPE_SWAPCHAIN_CREATE_INFO };
+		swapchainCI.createFlags = 0;
+		swapchainCI.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+		swapchainCI.format = m_GraphicsAPI->SelectColorSwapchainFormat(formats);
+		swapchainCI.sampleCount = 1;
+		swapchainCI.width = decoder->GetFormat().width;
+		swapchainCI.height = decoder->GetFormat().height;
+		swapchainCI.faceCount = 1;
+		swapchainCI.arraySize = 1;
+		swapchainCI.mipCount = 1;
+		OPENXR_CHECK(xrCreateSwapchain(m_Session, &swapchainCI, &m_videoSwapchainInfo.swapchain), "Failed to create Video Swapchain");
+		m_videoSwapchainInfo.swapchainFormat = swapchainCI.format;
+
+		uint32_t videoSwapchainImageCount = 0;
+		OPENXR_CHECK(xrEnumerateSwapchainImages(m_videoSwapchainInfo.swapchain, 0, &videoSwapchainImageCount, nullptr), "Failed to enumerate Video Swapchain Images.");
+		XrSwapchainImageBaseHeader* videoSwapchainImages = m_GraphicsAPI->AllocateSwapchainImageData(m_videoSwapchainInfo.swapchain, GraphicsAPI::SwapchainType::COLOR, videoSwapchainImageCount);
+		OPENXR_CHECK(xrEnumerateSwapchainImages(m_videoSwapchainInfo.swapchain, videoSwapchainImageCount, &videoSwapchainImageCount, videoSwapchainImages), "Failed to enumerate Video Swapchain Images.");
+		m_GraphicsAPI->RegisterSwapchainImages(m_videoSwapchainInfo.swapchain, swapchainCI);
+		for (uint32_t j = 0; j < videoSwapchainImageCount; j++) {
+			m_videoSwapchainInfo.imageViews.push_back(m_GraphicsAPI->CreateImageView({ m_GraphicsAPI->GetSwapchainImage(m_videoSwapchainInfo.swapchain, j), GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D,
+				m_videoSwapchainInfo.swapchainFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1 }));
+		}
+
+		VideoLayer::CreateInfo videoLayerCI;
+		videoLayerCI.lumaFormat = m_GraphicsAPI->GetVideoLumaFormat();
+		videoLayerCI.chromaFormat = m_GraphicsAPI->GetVideoChromaFormat();
+		videoLayerCI.colorFormat = m_videoSwapchainInfo.swapchainFormat;
+		m_videoLayer = std::make_unique<VideoLayer>(m_GraphicsAPI.get(), videoLayerCI, std::move(decoder));
+		m_videoFrameReleased = false;
+	}
+
+	void DestroyVideoLayer()
+	{
+		m_videoLayer.reset();
+		if (m_videoSwapchainInfo.swapchain == XR_NULL_HANDLE)
+		{
+			return;
+		}
+		for (void*& imageView : m_videoSwapchainInfo.imageViews) {
+			m_GraphicsAPI->DestroyImageView(imageView);
+		}
+		m_videoSwapchainInfo.imageViews.clear();
+		m_GraphicsAPI->FreeSwapchainImageData(m_videoSwapchainInfo.swapchain);
+		OPENXR_CHECK(xrDestroySwapchain(m_videoSwapchainInfo.swapchain), "Failed to destroy Video Swapchain");
+		m_videoSwapchainInfo.swapchain = XR_NULL_HANDLE;
+	}
+
+	void CreateViewRenderTargets()
+	{
+		// Views with the same resolution and formats share their render targets, e.g. both eyes of a stereo configuration,
+		// or the two peripheral and the two inset views of a quad view configuration.
+		m_viewGroupIndices.resize(m_viewConfigurationViews.size());
+		for (uint32_t i = 0; i < static_cast<uint32_t>(m_viewConfigurationViews.size()); i++)
+		{
+			const uint32_t width = m_viewConfigurationViews[i].recommendedImageRectWidth;
+			const uint32_t height = m_viewConfigurationViews[i].recommendedImageRectHeight;
+			const int64_t colorFormat = m_colorSwapchainInfos[i].swapchainFormat;
+			const int64_t depthFormat = m_depthSwapchainInfos[i].swapchainFormat;
+			const uint32_t sampleCount = m_viewConfigurationViews[i].recommendedSwapchainSampleCount;
+			auto it = std::find_if(m_viewGroups.begin(), m_viewGroups.end(), [&](const ViewGroup& viewGroup) {
+				return viewGroup.width == width && viewGroup.height == height && viewGroup.colorFormat == colorFormat && viewGroup.depthFormat == depthFormat && viewGroup.sampleCount == sampleCount;
+			});
+			if (it == m_viewGroups.end())
+			{
+				m_viewGroups.push_back({ width, height, colorFormat, depthFormat, sampleCount });
+				it = m_viewGroups.end() - 1;
+			}
+			m_viewGroupIndices[i] = { static_cast<uint32_t>(it - m_viewGroups.begin()), it->viewCount++ };
+		}
+
+		for (ViewGroup& viewGroup : m_viewGroups)
+		{
+			// Views are rendered at a reduced resolution and temporally upscaled into the swapchain images.
+			// The adaptive quality tier's resolution scale reduces the render resolution further.
+			uint32_t renderWidth = viewGroup.width;
+			uint32_t renderHeight = viewGroup.height;
+			if (m_temporalUpscalingEnabled)
+			{
+				viewGroup.temporalUpscaler = std::make_unique<TemporalUpscaler>(m_GraphicsAPI.get(), viewGroup.viewCount, renderWidth, renderHeight, m_temporalUpscalingRenderScale * m_adaptiveQuality.GetTier().resolutionScale,
+					viewGroup.colorFormat, viewGroup.depthFormat, m_GraphicsAPI->GetMotionVectorFormat());
+				renderWidth = viewGroup.temporalUpscaler->GetRenderWidth();
+				renderHeight = viewGroup.temporalUpscaler->GetRenderHeight();
+			}
+
+			// Transparent content is rendered at half resolution and upsampled over each view after its opaque content.
+			// It accumulates in a float format, as premultiplied blending bands and clamps in the swapchain's formats.
+			if (m_halfResolutionTransparencyEnabled)
+			{
+				viewGroup.halfResolutionTransparency = std::make_unique<HalfResolutionTransparency>(m_GraphicsAPI.get(), renderWidth, renderHeight,
+					m_GraphicsAPI->GetHDRColorFormat(), viewGroup.depthFormat, viewGroup.colorFormat);
+			}
+
+			// With more samples than the swapchain images, the opaque content is rendered into multisampled images and
+			// resolved into the view's images. Otherwise, it is rendered straight into the swapchain images, without a resolve.
+			// Multisampled swapchain images can't be the target of a resolve, so they are always rendered into directly.
+			// The views are rendered one after another, so all views of the group share the multisampled images.
+			const uint32_t msaaSampleCount = m_adaptiveQuality.GetTier().msaaSampleCount;
+			if (viewGroup.sampleCount == 1 && msaaSampleCount > 1)
+			{
+				viewGroup.msaaColorImage = m_GraphicsAPI->CreateImage({ 2, renderWidth, renderHeight, 1, 1, 1, msaaSampleCount, viewGroup.colorFormat, false, true, false, false });
+				viewGroup.msaaColorImageView = m_GraphicsAPI->CreateImageView({ viewGroup.msaaColorImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, viewGroup.colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1 });
+				viewGroup.msaaDepthImage = m_GraphicsAPI->CreateImage({ 2, renderWidth, renderHeight, 1, 1, 1, msaaSampleCount, viewGroup.depthFormat, false, false, true, false });
+				viewGroup.msaaDepthImageView = m_GraphicsAPI->CreateImageView({ viewGroup.msaaDepthImage, GraphicsAPI::ImageViewCreateInfo::Type::DSV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, viewGroup.depthFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::DEPTH_BIT, 0, 1, 0, 1 });
+			}
+		}
+	}
+
+	struct ViewGroup;
+	void DestroyViewGroup(ViewGroup& viewGroup)
+	{
+		viewGroup.temporalUpscaler.reset();
+		viewGroup.halfResolutionTransparency.reset();
+		if (viewGroup.msaaColorImage)
+		{
+			m_GraphicsAPI->DestroyImageView(viewGroup.msaaColorImageView);
+			m_GraphicsAPI->DestroyImage(viewGroup.msaaColorImage);
+			m_GraphicsAPI->DestroyImageView(viewGroup.msaaDepthImageView);
+			m_GraphicsAPI->DestroyImage(viewGroup.msaaDepthImage);
+		}
+	}
+
+	void DestroyViewRenderTargets()
+	{
+		for (ViewGroup& viewGroup : m_viewGroups)
+		{
+			DestroyViewGroup(viewGroup);
+		}
+		for (ViewGroup& viewGroup : m_retiredViewGroups)
+		{
+			DestroyViewGroup(viewGroup);
+		}
+		m_viewGroups.clear();
+		m_retiredViewGroups.clear();
+		m_viewGroupIndices.clear();
+	}
+
+	// Replaces the render targets while the session runs. The old ones are destroyed one view group per step in the
+	// idle time before xrWaitFrame(), instead of in the frame that replaces them.
+	void RetireViewRenderTargets()
+	{
+		const bool destructionScheduled = !m_retiredViewGroups.empty();
+		for (ViewGroup& viewGroup : m_viewGroups)
+		{
+			m_retiredViewGroups.push_back(std::move(viewGroup));
+		}
+		m_viewGroups.clear();
+		m_viewGroupIndices.clear();
+		if (!destructionScheduled)
+		{
+			m_idleTaskScheduler.AddTask("Destroy Retired View Render Targets", [this]() {
+				if (!m_retiredViewGroups.empty())
+				{
+					DestroyViewGroup(m_retiredViewGroups.back());
+					m_retiredViewGroups.pop_back();
+				}
+				return !m_retiredViewGroups.empty();
+			});
+		}
 	}
 
 	void DestroySwapchains()
 	{
+		DestroyVideoLayer();
+		DestroyViewRenderTargets();
+		m_farFieldReprojection.reset();
+
 		// Per view in the view configuration:
 		for (size_t i = 0; i < m_viewConfigurationViews.size(); i++)
 		{
@@ -480,7 +890,48 @@ private:
 		// Get the XrFrameState for timing and rendering info.
 		XrFrameState frameState{ XR_TYPE_FRAME_STATE };
 		XrFrameWaitInfo frameWaitInfo{ XR_TYPE_FRAME_WAIT_INFO };
+		// Use the time that xrWaitFrame() would block for background tasks, without delaying the frame start.
+		m_idleTaskScheduler.RunIdleTasks();
+		m_idleTaskScheduler.BeginWait();
 		OPENXR_CHECK(xrWaitFrame(m_Session, &frameWaitInfo, &frameState), "Failed to wait for XR Frame.");
+		m_idleTaskScheduler.EndWait();
+		if (m_frameTrace) {
+			m_frameTrace->BeginFrame(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod);
+			LogLatencyStatistics(false);
+		}
+
+		// The auto-tuner's frame budget is the display period, which is only known from the first xrWaitFrame(). It runs
+		// within an empty frame, so that the runtime's frame loop stays paired while the probe occupies the GPU.
+		if (m_autoTuneEnabled && !m_autoTuned && frameState.predictedDisplayPeriod > 0) {
+			XrFrameBeginInfo frameBeginInfo{ XR_TYPE_FRAME_BEGIN_INFO };
+			OPENXR_CHECK(xrBeginFrame(m_Session, &frameBeginInfo), "Failed to begin the XR Frame.");
+			AutoTune(frameState.predictedDisplayPeriod);
+			m_autoTuned = true;
+
+			XrFrameEndInfo frameEndInfo{ XR_TYPE_FRAME_END_INFO };
+			frameEndInfo.displayTime = frameState.predictedDisplayTime;
+			frameEndInfo.environmentBlendMode = m_environmentBlendMode;
+			frameEndInfo.layerCount = 0;
+			frameEndInfo.layers = nullptr;
+			if (m_frameTrace) {
+				m_frameTrace->EndFrame();
+			}
+			OPENXR_CHECK(xrEndFrame(m_Session, &frameEndInfo), "Failed to end the XR Frame.");
+			return;
+		}
+		UpdateAdaptiveQuality(static_cast<float>(frameState.predictedDisplayPeriod) * 1e-9f);
+
+		// Sleep until the latest safe start time, so that the views are located closer to the display time.
+		if (m_justInTimeFrameStart) {
+			m_justInTimeFrameStart->Update(*m_frameTrace);
+			m_justInTimeFrameStart->Wait(*m_frameTrace);
+		}
+
+		// Count the frame's CPU work, after any waits.
+		PerfCounters::Scope renderFrameScope(m_perfCounters.get(), m_perfPhaseRenderFrame);
+
+		// Advance the game logic to the predicted display time, at its own tick rate.
+		m_simulation.Update(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod);
 
 		// Tell the OpenXR compositor that the application is beginning the frame.
 		XrFrameBeginInfo frameBeginInfo{ XR_TYPE_FRAME_BEGIN_INFO };
@@ -499,6 +950,10 @@ private:
 			if (rendered) {
 				renderLayerInfo.layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&renderLayerInfo.layerProjection));
 			}
+			// The video layer is composited over the projection layer.
+			if (m_videoLayer && m_videoLayer->IsValid() && RenderVideoLayer(renderLayerInfo)) {
+				renderLayerInfo.layers.push_back(m_videoEquirect ? reinterpret_cast<XrCompositionLayerBaseHeader*>(&renderLayerInfo.layerEquirect) : reinterpret_cast<XrCompositionLayerBaseHeader*>(&renderLayerInfo.layerQuad));
+			}
 		}
 
 		// Tell OpenXR that we are finished with this frame; specifying its display time, environment blending and layers.
@@ -507,12 +962,104 @@ private:
 		frameEndInfo.environmentBlendMode = m_environmentBlendMode;
 		frameEndInfo.layerCount = static_cast<uint32_t>(renderLayerInfo.layers.size());
 		frameEndInfo.layers = renderLayerInfo.layers.data();
+		if (m_frameTrace) {
+			m_frameTrace->EndFrame();
+		}
 		OPENXR_CHECK(xrEndFrame(m_Session, &frameEndInfo), "Failed to end the XR Frame.");
 	}
 
+	void UpdateAdaptiveQuality(float deltaTime)
+	{
+		// Request the performance levels chosen by the controller from the runtime.
+		if (m_xrPerfSettingsSetPerformanceLevelEXT) {
+			for (XrPerfSettingsDomainEXT domain : { XR_PERF_SETTINGS_DOMAIN_CPU_EXT, XR_PERF_SETTINGS_DOMAIN_GPU_EXT }) {
+				XrPerfSettingsLevelEXT level;
+				if (m_adaptiveQuality.GetPerformanceLevelRequest(domain, level)) {
+					OPENXR_CHECK(m_xrPerfSettingsSetPerformanceLevelEXT(m_Session, domain, level), "Failed to set Performance Level.");
+				}
+			}
+		}
+
+		if (!m_adaptiveQuality.Update(deltaTime)) {
+			return;
+		}
+
+		// Recreate the render targets for the new tier's resolution scale and MSAA sample count.
+		const AdaptiveQualityController::QualityTier& tier = m_adaptiveQuality.GetTier();
+		XR_TUT_LOG("Quality Tier: " << m_adaptiveQuality.GetTierIndex() << " Resolution Scale: " << tier.resolutionScale << " MSAA: " << tier.msaaSampleCount);
+		RetireViewRenderTargets();
+		CreateViewRenderTargets();
+	}
+
+	void SimulationTick(const FixedTimestepSimulation::State& current, FixedTimestepSimulation::State& next, XrTime time, float deltaTime)
+	{
+		// Update the game logic here, at m_simulationTickRate, writing the objects' transforms at time into next.
+		// This runs on the job system, concurrently with rendering. The objects are set with m_simulation.SetState().
+		// Each object spins about its vertical axis at m_simulationSpinRate radians per second.
+		const XrVector3f up = { 0.0f, 1.0f, 0.0f };
+		XrQuaternionf spin;
+		XrQuaternionf_CreateFromAxisAngle(&spin, &up, m_simulationSpinRate * deltaTime);
+		next.resize(current.size());
+		for (size_t i = 0; i < current.size(); i++) {
+			next[i].position = current[i].position;
+			XrQuaternionf_Multiply(&next[i].orientation, &spin, &current[i].orientation);
+		}
+	}
+
+	void LogLatencyStatistics(bool force)
+	{
+		// Log the motion-to-photon latency distributions every m_latencyLogInterval frames.
+		const std::deque<FrameTrace::Frame>& frames = m_frameTrace->GetFrames();
+		if (frames.empty() || (!force && (frames.back().index == 0 || frames.back().index % m_latencyLogInterval != 0))) {
+			return;
+		}
+		const FrameTrace::Statistics& statistics = m_frameTrace->GetStatistics();
+		auto LogDistribution = [](const char* name, const FrameTrace::Distribution& distribution) {
+			XR_TUT_LOG("    " << name << " ms: Mean: " << distribution.mean << " P50: " << distribution.p50 << " P90: " << distribution.p90 << " P99: " << distribution.p99 << " Max: " << distribution.max);
+		};
+		XR_TUT_LOG("Latency over " << statistics.frameCount << " frames, " << statistics.lateFrames << " late:");
+		LogDistribution("Prediction Horizon", statistics.predictionHorizon);
+		LogDistribution("Pose Age At Display", statistics.poseAgeAtDisplay);
+		LogDistribution("Submit To Display", statistics.submitToDisplay);
+		LogDistribution("GPU Complete To Display", statistics.gpuCompleteToDisplay);
+
+		const PosePrefetcher::Statistics& prefetchStatistics = m_posePrefetcher.GetStatistics();
+		XR_TUT_LOG("Pose Prefetcher: Prefetches: " << prefetchStatistics.prefetches << " Hits: " << prefetchStatistics.hits << " Misses: " << prefetchStatistics.misses
+			<< " Wasted: " << prefetchStatistics.wasted << " Hit Rate: " << prefetchStatistics.hitRate << " Lead Time: " << prefetchStatistics.averageLeadTimeMs << " ms");
+
+		if (m_perfCounters && m_perfCounters->IsAvailable()) {
+			for (const PerfCounters::PhaseStatistics& phase : m_perfCounters->GetStatistics()) {
+				XR_TUT_LOG("Perf Counters: " << phase.name << ": Samples: " << phase.samples << " IPC: " << phase.instructionsPerCycle << " LLC Misses/KI: " << phase.llcMissesPerKiloInstruction
+					<< " Branch Misses/KI: " << phase.branchMissesPerKiloInstruction << " Context Switches/Sample: " << phase.contextSwitchesPerSample);
+			}
+		}
+
+		if (m_justInTimeFrameStart) {
+			const JustInTimeFrameStart::Statistics& jitStatistics = m_justInTimeFrameStart->GetStatistics();
+			XR_TUT_LOG("Just-In-Time Frame Start: Cost P50: " << jitStatistics.costP50Ms << " ms Model: " << jitStatistics.costModelMs << " ms Safety Margin: " << jitStatistics.safetyMarginMs
+				<< " ms Oversleep: " << jitStatistics.oversleepMs << " ms Late: " << jitStatistics.lateFrames << "/" << jitStatistics.learnedFrames
+				<< " Pose Age Reduction: " << jitStatistics.averageSleepMs << " ms");
+		}
+
+		if (m_videoLayer) {
+			const VideoLayer::Statistics videoStatistics = m_videoLayer->GetStatistics();
+			XR_TUT_LOG("Video: Decoded: " << videoStatistics.framesDecoded << " Shown: " << videoStatistics.framesShown << " Dropped: " << videoStatistics.framesDropped
+				<< " Late Updates: " << videoStatistics.lateUpdates << " Decode: " << videoStatistics.decodeMs << " ms Uploaded: " << videoStatistics.bytesUploaded / (1024 * 1024) << " MiB");
+		}
+
+		if (m_splitRenderClient) {
+			const SplitRenderClient::Statistics splitStatistics = m_splitRenderClient->GetStatistics();
+			XR_TUT_LOG("Split Rendering: Latency: " << splitStatistics.latencyMs << " ms Server: " << splitStatistics.serverMs << " ms Decode: " << splitStatistics.decodeMs
+				<< " ms Bandwidth: " << splitStatistics.receivedMbps << " Mbit/s Compression: " << splitStatistics.compressionRatio << ":1 Frames: " << splitStatistics.framesReceived
+				<< " Dropped: " << splitStatistics.framesDropped);
+		}
+	}
+
 	struct RenderLayerInfo;
 	bool RenderLayer(RenderLayerInfo& renderLayerInfo)
 	{
+		PerfCounters::Scope renderLayerScope(m_perfCounters.get(), m_perfPhaseRenderLayer);
+
 		// Locate the views from the view configuration within the (reference) space at the display time.
 		std::vector<XrView> views(m_viewConfigurationViews.size(), { XR_TYPE_VIEW });
 
@@ -523,6 +1070,10 @@ private:
 		viewLocateInfo.space = m_localSpace;
 		uint32_t viewCount = 0;
 		XrResult result = xrLocateViews(m_Session, &viewLocateInfo, &viewState, static_cast<uint32_t>(views.size()), &viewCount, views.data());
+		if (m_frameTrace) {
+			// The poses are predicted for the display time at this point. Any later work adds to their age at display.
+			m_frameTrace->LocateViews();
+		}
 		if (result != XR_SUCCESS) {
 			XR_TUT_LOG("Failed to locate Views.");
 			return false;
@@ -531,12 +1082,77 @@ private:
 		// Resize the layer projection views to match the view count. The layer projection views are used in the layer projection.
 		renderLayerInfo.layerProjectionViews.resize(viewCount, { XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW });
 
+		float nearZ = 0.05f;
+		float farZ = 100.0f;
+
+		// Prefetch the streamed assets that the extrapolated head pose is about to bring into view.
+		// Register assets with m_posePrefetcher.AddAsset(), e.g. with a callback calling VirtualTexture::Prefetch() for their texture region.
+		{
+			PerfCounters::Scope cullingScope(m_perfCounters.get(), m_perfPhaseCulling);
+			// Views contained in another view, e.g. the inset views of quad views, add nothing to the visible set, so only
+			// the views that are culled themselves are passed on. Draw calls of a contained view reuse the culling results
+			// of m_cullingViews[i].
+			FindCullingViews(views.data(), viewCount, m_cullingViews);
+			std::vector<XrView> cullingViews;
+			for (uint32_t i = 0; i < viewCount; i++)
+			{
+				if (m_cullingViews[i] == i)
+				{
+					cullingViews.push_back(views[i]);
+				}
+			}
+			m_posePrefetcher.Update(renderLayerInfo.predictedDisplayTime, cullingViews.data(), static_cast<uint32_t>(cullingViews.size()), nearZ, farZ);
+		}
+
+		// With split rendering, the server renders the views instead.
+		if (m_splitRenderClient && m_splitRenderClient->IsConnected())
+		{
+			return RenderSplitLayer(renderLayerInfo, views.data(), viewCount);
+		}
+
+		// VR mode uses a background color. In AR mode make the background color black.
+		const float backgroundColor = m_environmentBlendMode == XR_ENVIRONMENT_BLEND_MODE_OPAQUE ? 0.17f : 0.00f;
+
+		// Render the far field content once from the central pose of all views.
+		// The mono target matches the peripheral views, so the quad views' high resolution inset views render the far field
+		// content themselves.
+		const bool farField = m_farFieldReprojection && viewCount > 1;
+		const uint32_t farFieldViewCount = m_viewConfiguration == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO ? 2 : viewCount;
+		if (farField)
+		{
+			m_farFieldReprojection->SetViews(views.data(), farFieldViewCount, farZ);
+			m_GraphicsAPI->BeginRendering();
+			m_farFieldReprojection->BeginMonoPass(backgroundColor, backgroundColor, backgroundColor, 1.00f);
+			// Draw objects for which m_farFieldReprojection->IsFarField() is true here, with m_farFieldReprojection->GetViewProjection().
+			m_GraphicsAPI->EndRendering();
+		}
+
+		// Advance the sub-pixel jitter of the temporal upscalers.
+		for (ViewGroup& viewGroup : m_viewGroups)
+		{
+			if (viewGroup.temporalUpscaler)
+			{
+				viewGroup.temporalUpscaler->BeginFrame();
+			}
+		}
+
 		// Per view in the view configuration:
 		for (uint32_t i = 0; i < viewCount; i++)
 		{
+			if (m_perfCounters && m_perfPhaseViews.size() <= i) {
+				m_perfPhaseViews.push_back(m_perfCounters->GetPhase("View " + std::to_string(i)));
+			}
+			PerfCounters::Scope viewScope(m_perfCounters.get(), m_perfCounters ? m_perfPhaseViews[i] : 0);
+
 			SwapchainInfo& colorSwapchainInfo = m_colorSwapchainInfos[i];
 			SwapchainInfo& depthSwapchainInfo = m_depthSwapchainInfos[i];
 
+			// The render targets of the view's resolution and formats, and the view's index within them.
+			ViewGroup& viewGroup = m_viewGroups[m_viewGroupIndices[i].first];
+			const uint32_t groupViewIndex = m_viewGroupIndices[i].second;
+			TemporalUpscaler* temporalUpscaler = viewGroup.temporalUpscaler.get();
+			HalfResolutionTransparency* halfResolutionTransparency = viewGroup.halfResolutionTransparency.get();
+
 			// Acquire and wait for an image from the swapchains.
 			// Get the image index of an image in the swapchains.
 			// The timeout is infinite.
@@ -552,12 +1168,12 @@ private:
 			OPENXR_CHECK(xrWaitSwapchainImage(depthSwapchainInfo.swapchain, &waitInfo), "Failed to wait for Image from the Depth Swapchain");
 
 			// Get the width and height and construct the viewport and scissors.
-			const uint32_t& width = m_viewConfigurationViews[i].recommendedImageRectWidth;
-			const uint32_t& height = m_viewConfigurationViews[i].recommendedImageRectHeight;
+			// Without temporal upscaling, the adaptive quality tier's resolution scale renders into a smaller region of the swapchain images.
+			const float resolutionScale = temporalUpscaler ? 1.0f : m_adaptiveQuality.GetTier().resolutionScale;
+			const uint32_t width = static_cast<uint32_t>(static_cast<float>(m_viewConfigurationViews[i].recommendedImageRectWidth) * resolutionScale);
+			const uint32_t height = static_cast<uint32_t>(static_cast<float>(m_viewConfigurationViews[i].recommendedImageRectHeight) * resolutionScale);
 			GraphicsAPI::Viewport viewport = { 0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f };
 			GraphicsAPI::Rect2D scissor = { {(int32_t)0, (int32_t)0}, {width, height} };
-			float nearZ = 0.05f;
-			float farZ = 100.0f;
 
 			// Fill out the XrCompositionLayerProjectionView structure specifying the pose and fov from the view.
 			// This also associates the swapchain image with this layer projection view.
@@ -572,21 +1188,77 @@ private:
 			renderLayerInfo.layerProjectionViews[i].subImage.imageArrayIndex = 0;  // Useful for multiview rendering.
 
 			// Rendering code to clear the color and depth image views.
+			if (m_perfCounters) {
+				m_perfCounters->BeginPhase(m_perfPhaseRecording);
+			}
 			m_GraphicsAPI->BeginRendering();
 
-			if (m_environmentBlendMode == XR_ENVIRONMENT_BLEND_MODE_OPAQUE)
+			// With temporal upscaling, the view is rendered into the upscaler's reduced resolution images instead of the swapchain images.
+			void* colorImageView = colorSwapchainInfo.imageViews[colorImageIndex];
+			void* colorImage = m_GraphicsAPI->GetSwapchainImage(colorSwapchainInfo.swapchain, colorImageIndex);
+			void* depthImageView = depthSwapchainInfo.imageViews[depthImageIndex];
+			void* depthImage = m_GraphicsAPI->GetSwapchainImage(depthSwapchainInfo.swapchain, depthImageIndex);
+			uint32_t renderWidth = width;
+			uint32_t renderHeight = height;
+			if (temporalUpscaler)
+			{
+				// Draw with temporalUpscaler->GetViewProjection(groupViewIndex), which is jittered every frame.
+				temporalUpscaler->SetView(groupViewIndex, views[i], nearZ, farZ);
+				colorImageView = temporalUpscaler->GetColorImageView(groupViewIndex);
+				colorImage = temporalUpscaler->GetColorImage(groupViewIndex);
+				depthImageView = temporalUpscaler->GetDepthImageView(groupViewIndex);
+				depthImage = temporalUpscaler->GetDepthImage(groupViewIndex);
+				renderWidth = temporalUpscaler->GetRenderWidth();
+				renderHeight = temporalUpscaler->GetRenderHeight();
+			}
+
+			// With MSAA, the opaque content is rendered into the multisampled images.
+			void* opaqueColorImageView = viewGroup.msaaColorImageView ? viewGroup.msaaColorImageView : colorImageView;
+			void* opaqueDepthImageView = viewGroup.msaaDepthImageView ? viewGroup.msaaDepthImageView : depthImageView;
+
+			if (farField && i < farFieldViewCount)
 			{
-				// VR mode use a background color.
-				m_GraphicsAPI->ClearColor(colorSwapchainInfo.imageViews[colorImageIndex], 0.17f, 0.17f, 0.17f, 1.00f);
+				// The reprojected far field replaces the clear. Near content is rendered over it, per view.
+				m_farFieldReprojection->Reproject(opaqueColorImageView, renderWidth, renderHeight, views[i]);
 			}
 			else
 			{
-				// In AR mode make the background color black.
-				m_GraphicsAPI->ClearColor(colorSwapchainInfo.imageViews[colorImageIndex], 0.00f, 0.00f, 0.00f, 1.00f);
+				m_GraphicsAPI->ClearColor(opaqueColorImageView, backgroundColor, backgroundColor, backgroundColor, 1.00f);
+			}
+			m_GraphicsAPI->ClearDepth(opaqueDepthImageView, 1.0f);
+
+			// Without the reprojected far field, the opaque content includes the objects for which m_farFieldReprojection->IsFarField() is true.
+
+			if (viewGroup.msaaColorImage)
+			{
+				// Resolve the color and depth, which the passes below read.
+				GraphicsAPI::ImageBlit region = { { 0, 0, 1 }, { { 0, 0, 0 }, { (int32_t)renderWidth, (int32_t)renderHeight, 1 } }, { 0, 0, 1 }, { { 0, 0, 0 }, { (int32_t)renderWidth, (int32_t)renderHeight, 1 } } };
+				m_GraphicsAPI->BlitImage(viewGroup.msaaColorImage, colorImage, region, GraphicsAPI::SamplerCreateInfo::Filter::NEAREST);
+				m_GraphicsAPI->BlitImage(viewGroup.msaaDepthImage, depthImage, region, GraphicsAPI::SamplerCreateInfo::Filter::NEAREST);
+			}
+
+			if (temporalUpscaler)
+			{
+				temporalUpscaler->GenerateMotionVectors(groupViewIndex);
+				// Draw the motion vectors of moving objects here.
+			}
+
+			if (halfResolutionTransparency)
+			{
+				halfResolutionTransparency->Begin(depthImage, renderWidth, renderHeight);
+				// Draw transparent objects here, with depth testing, without depth writes and with premultiplied alpha blending.
+				halfResolutionTransparency->Composite(colorImageView, depthImage, renderWidth, renderHeight, nearZ, farZ);
+			}
+
+			if (temporalUpscaler)
+			{
+				temporalUpscaler->Resolve(groupViewIndex, colorSwapchainInfo.imageViews[colorImageIndex]);
 			}
-			m_GraphicsAPI->ClearDepth(depthSwapchainInfo.imageViews[depthImageIndex], 1.0f);
 
 			m_GraphicsAPI->EndRendering();
+			if (m_perfCounters) {
+				m_perfCounters->EndPhase(m_perfPhaseRecording);
+			}
 
 			// Give the swapchain image back to OpenXR, allowing the compositor to use the image.
 			XrSwapchainImageReleaseInfo releaseInfo{ XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
@@ -603,12 +1275,146 @@ private:
 		return true;
 	}
 
+	bool RenderVideoLayer(RenderLayerInfo& renderLayerInfo)
+	{
+		// Only a new video frame is converted into the next swapchain image. Until then, the runtime keeps showing the last released image.
+		if (m_videoLayer->Update(renderLayerInfo.predictedDisplayTime))
+		{
+			uint32_t videoImageIndex = 0;
+			XrSwapchainImageAcquireInfo acquireInfo{ XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
+			OPENXR_CHECK(xrAcquireSwapchainImage(m_videoSwapchainInfo.swapchain, &acquireInfo, &videoImageIndex), "Failed to acquire Image from the Video Swapchain");
+			XrSwapchainImageWaitInfo waitInfo = { XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
+			waitInfo.timeout = XR_INFINITE_DURATION;
+			OPENXR_CHECK(xrWaitSwapchainImage(m_videoSwapchainInfo.swapchain, &waitInfo), "Failed to wait for Image from the Video Swapchain");
+
+			m_GraphicsAPI->BeginRendering();
+			m_videoLayer->Convert(m_videoSwapchainInfo.imageViews[videoImageIndex]);
+			m_GraphicsAPI->EndRendering();
+
+			XrSwapchainImageReleaseInfo releaseInfo{ XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
+			OPENXR_CHECK(xrReleaseSwapchainImage(m_videoSwapchainInfo.swapchain, &releaseInfo), "Failed to release Image back to the Video Swapchain");
+			m_videoFrameReleased = true;
+		}
+		if (!m_videoFrameReleased)
+		{
+			return false;
+		}
+
+		XrSwapchainSubImage subImage{};
+		subImage.swapchain = m_videoSwapchainInfo.swapchain;
+		subImage.imageRect.offset = { 0, 0 };
+		subImage.imageRect.extent = { static_cast<int32_t>(m_videoLayer->GetWidth()), static_cast<int32_t>(m_videoLayer->GetHeight()) };
+		subImage.imageArrayIndex = 0;
+		if (m_videoEquirect)
+		{
+			// A full sphere at infinity around the origin of the local space.
+			renderLayerInfo.layerEquirect = { XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR };
+			renderLayerInfo.layerEquirect.space = m_localSpace;
+			renderLayerInfo.layerEquirect.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+			renderLayerInfo.layerEquirect.subImage = subImage;
+			renderLayerInfo.layerEquirect.pose = { {0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f} };
+			renderLayerInfo.layerEquirect.radius = 0.0f;
+			renderLayerInfo.layerEquirect.centralHorizontalAngle = 2.0f * MATH_PI;
+			renderLayerInfo.layerEquirect.upperVerticalAngle = MATH_PI / 2.0f;
+			renderLayerInfo.layerEquirect.lowerVerticalAngle = -MATH_PI / 2.0f;
+		}
+		else
+		{
+			// A screen 2 meters high, 3 meters in front of the origin of the local space.
+			const float height = 2.0f;
+			renderLayerInfo.layerQuad = { XR_TYPE_COMPOSITION_LAYER_QUAD };
+			renderLayerInfo.layerQuad.space = m_localSpace;
+			renderLayerInfo.layerQuad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+			renderLayerInfo.layerQuad.subImage = subImage;
+			renderLayerInfo.layerQuad.pose = { {0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -3.0f} };
+			renderLayerInfo.layerQuad.size = { height * static_cast<float>(m_videoLayer->GetWidth()) / static_cast<float>(m_videoLayer->GetHeight()), height };
+		}
+		return true;
+	}
+
+	bool RenderSplitLayer(RenderLayerInfo& renderLayerInfo, const XrView* views, uint32_t viewCount)
+	{
+		// Each view is rendered at its recommended resolution.
+		m_splitRenderClient->SendPoses(m_splitRenderFrameIndex++, renderLayerInfo.predictedDisplayTime, views, m_viewConfigurationViews.data(), viewCount);
+
+		// Show the latest frame received, which is older than the poses just sent. Until the first frame arrives, no layer is submitted.
+		m_splitRenderClient->GetLatestFrame(m_splitRenderFrame);
+		if (m_splitRenderFrame.viewCount != viewCount)
+		{
+			return false;
+		}
+		size_t stagingBufferSize = 0;
+		for (uint32_t i = 0; i < viewCount; i++)
+		{
+			if (m_splitRenderFrame.widths[i] != m_viewConfigurationViews[i].recommendedImageRectWidth || m_splitRenderFrame.heights[i] != m_viewConfigurationViews[i].recommendedImageRectHeight)
+			{
+				return false;
+			}
+			stagingBufferSize += m_splitRenderFrame.images[i].size();
+		}
+
+		if (m_splitRenderStagingBufferSize != stagingBufferSize)
+		{
+			if (m_splitRenderStagingBuffer)
+			{
+				m_GraphicsAPI->DestroyBuffer(m_splitRenderStagingBuffer);
+			}
+			m_splitRenderStagingBufferSize = stagingBufferSize;
+			m_splitRenderStagingBuffer = m_GraphicsAPI->CreateBuffer({ GraphicsAPI::BufferCreateInfo::Type::STAGING, 0, m_splitRenderStagingBufferSize, nullptr });
+		}
+
+		size_t stagingBufferOffset = 0;
+		for (uint32_t i = 0; i < viewCount; i++)
+		{
+			const uint32_t width = m_splitRenderFrame.widths[i];
+			const uint32_t height = m_splitRenderFrame.heights[i];
+			const size_t imageSize = m_splitRenderFrame.images[i].size();
+			SwapchainInfo& colorSwapchainInfo = m_colorSwapchainInfos[i];
+			uint32_t colorImageIndex = 0;
+			XrSwapchainImageAcquireInfo acquireInfo{ XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
+			OPENXR_CHECK(xrAcquireSwapchainImage(colorSwapchainInfo.swapchain, &acquireInfo, &colorImageIndex), "Failed to acquire Image from the Color Swapchian");
+			XrSwapchainImageWaitInfo waitInfo = { XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
+			waitInfo.timeout = XR_INFINITE_DURATION;
+			OPENXR_CHECK(xrWaitSwapchainImage(colorSwapchainInfo.swapchain, &waitInfo), "Failed to wait for Image from the Color Swapchain");
+
+			// Every swapchain image needs the frame, as the swapchain cycles through its images.
+			m_GraphicsAPI->SetBufferData(m_splitRenderStagingBuffer, stagingBufferOffset, imageSize, m_splitRenderFrame.images[i].data());
+			GraphicsAPI::BufferImageCopy region{};
+			region.bufferOffset = stagingBufferOffset;
+			region.imageSubresource = { 0, 0, 1 };
+			region.imageExtent = { width, height, 1 };
+			m_GraphicsAPI->CopyBufferToImage(m_splitRenderStagingBuffer, m_GraphicsAPI->GetSwapchainImage(colorSwapchainInfo.swapchain, colorImageIndex), region);
+
+			// The frame is submitted with the poses it was rendered with, so that the runtime reprojects it to the current poses.
+			renderLayerInfo.layerProjectionViews[i] = { XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW };
+			renderLayerInfo.layerProjectionViews[i].pose = m_splitRenderFrame.poses[i];
+			renderLayerInfo.layerProjectionViews[i].fov = m_splitRenderFrame.fovs[i];
+			renderLayerInfo.layerProjectionViews[i].subImage.swapchain = colorSwapchainInfo.swapchain;
+			renderLayerInfo.layerProjectionViews[i].subImage.imageRect.offset.x = 0;
+			renderLayerInfo.layerProjectionViews[i].subImage.imageRect.offset.y = 0;
+			renderLayerInfo.layerProjectionViews[i].subImage.imageRect.extent.width = static_cast<int32_t>(width);
+			renderLayerInfo.layerProjectionViews[i].subImage.imageRect.extent.height = static_cast<int32_t>(height);
+			renderLayerInfo.layerProjectionViews[i].subImage.imageArrayIndex = 0;
+
+			XrSwapchainImageReleaseInfo releaseInfo{ XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
+			OPENXR_CHECK(xrReleaseSwapchainImage(colorSwapchainInfo.swapchain, &releaseInfo), "Failed to release Image back to the Color Swapchain");
+			stagingBufferOffset += imageSize;
+		}
+
+		renderLayerInfo.layerProjection.layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT | XR_COMPOSITION_LAYER_CORRECT_CHROMATIC_ABERRATION_BIT;
+		renderLayerInfo.layerProjection.space = m_localSpace;
+		renderLayerInfo.layerProjection.viewCount = viewCount;
+		renderLayerInfo.layerProjection.views = renderLayerInfo.layerProjectionViews.data();
+		return true;
+	}
+
 protected:
 	XrInstance m_xrInstance = XR_NULL_HANDLE;
 	std::vector<const char*> m_activeAPILayers = {};
 	std::vector<const char*> m_activeInstanceExtensions = {};
 	std::vector<std::string> m_apiLayers = {};
 	std::vector<std::string> m_instanceExtensions = {};
+	std::vector<std::string> m_optionalInstanceExtensions = {};
 
 	XrDebugUtilsMessengerEXT m_DebugUtilsMessenger = XR_NULL_HANDLE;
 
@@ -625,7 +1431,7 @@ protected:
 	bool m_applicationRunning = true;
 	bool m_sessionRunning = false;
 
-	std::vector<XrViewConfigurationType> m_applicationViewConfigurations = { XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO };
+	std::vector<XrViewConfigurationType> m_applicationViewConfigurations = { XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO };
 	std::vector<XrViewConfigurationType> m_viewConfigurations;
 	XrViewConfigurationType m_viewConfiguration = XR_VIEW_CONFIGURATION_TYPE_MAX_ENUM;
 	std::vector<XrViewConfigurationView> m_viewConfigurationViews;
@@ -644,17 +1450,288 @@ protected:
 	XrEnvironmentBlendMode m_environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_MAX_ENUM;
 
 	XrSpace m_localSpace = XR_NULL_HANDLE;
+
+	// Content further away than m_farFieldDistance meters is rendered once and reprojected into the views.
+	bool m_farFieldEnabled = false;
+	float m_farFieldDistance = 30.0f;
+	std::unique_ptr<FarFieldReprojection> m_farFieldReprojection = nullptr;
+
+	// Transparent content is rendered at a quarter of the pixel count and composited with a depth aware upsample.
+	bool m_halfResolutionTransparencyEnabled = false;
+
+	// Views are rendered at m_temporalUpscalingRenderScale of the recommended resolution and temporally upscaled.
+	bool m_temporalUpscalingEnabled = false;
+	float m_temporalUpscalingRenderScale = 0.7f;
+
+	// The render targets of the views with the same resolution and formats.
+	struct ViewGroup
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		int64_t colorFormat = 0;
+		int64_t depthFormat = 0;
+		uint32_t sampleCount = 0;  // Of the swapchain images.
+		uint32_t viewCount = 0;
+		std::unique_ptr<TemporalUpscaler> temporalUpscaler = nullptr;
+		std::unique_ptr<HalfResolutionTransparency> halfResolutionTransparency = nullptr;
+		void* msaaColorImage = nullptr;
+		void* msaaColorImageView = nullptr;
+		void* msaaDepthImage = nullptr;
+		void* msaaDepthImageView = nullptr;
+	};
+	std::vector<ViewGroup> m_viewGroups;
+	std::vector<ViewGroup> m_retiredViewGroups;  // Destroyed by an idle task, see RetireViewRenderTargets().
+	std::vector<std::pair<uint32_t, uint32_t>> m_viewGroupIndices;  // Per view: The view group, and the view's index within it.
+
+	// Per view: The view whose culling results the view uses. See FindCullingViews().
+	std::vector<uint32_t> m_cullingViews;
+
+	// Streaming requests for content predicted to enter the views 300 to 500 ms ahead.
+	PosePrefetcher m_posePrefetcher{PosePrefetcher::CreateInfo()};
+
+	// Quality tiers stepped in response to XR_EXT_performance_settings notifications.
+	AdaptiveQualityController m_adaptiveQuality{AdaptiveQualityController::GetDefaultTiers()};
+
+	// Rendering settings tuned on the first start on a device and stored in m_autoTunePath. The resolution scale and the
+	// MSAA sample count replace the highest quality tier. Multiview and the buffer update strategy are stored for the
+	// scene renderers to follow.
+	bool m_autoTuneEnabled = false;
+	bool m_autoTuneRetune = false;
+	bool m_autoTuned = false;
+	std::string m_autoTunePath = "AutoTune.txt";
+	AutoTuner::Settings m_autoTuneSettings;
+	PFN_xrPerfSettingsSetPerformanceLevelEXT m_xrPerfSettingsSetPerformanceLevelEXT = nullptr;
+
+	// Small background tasks, e.g. streaming callbacks, deferred destruction and cache warming, run in the idle time
+	// before xrWaitFrame(). Add them with m_idleTaskScheduler.AddTask(). RetireViewRenderTargets() adds one.
+	IdleTaskScheduler m_idleTaskScheduler{IdleTaskScheduler::CreateInfo()};
+
+	// The game logic runs at a fixed tick rate, independent of the display rate, and is interpolated to the display time.
+	float m_simulationTickRate = 60.0f;
+	float m_simulationSpinRate = 1.0f;
+	FixedTimestepSimulation m_simulation{m_simulationTickRate, [this](const FixedTimestepSimulation::State& current, FixedTimestepSimulation::State& next, XrTime time, float deltaTime) { SimulationTick(current, next, time, deltaTime); }, JobSystem::Get()};
+
+	// Frame start, submission, GPU completion and predicted display times on the CLOCK_MONOTONIC timebase.
+	bool m_frameTraceEnabled = false;
+	std::string m_frameTracePath = "FrameTrace.json";
+	std::unique_ptr<FrameTrace> m_frameTrace = nullptr;
+	uint64_t m_latencyLogInterval = 1000;
+
+	// perf_event_open() counters sampled around the phases of the frame loop. Falls back to no counters without permission.
+	bool m_perfCountersEnabled = false;
+	std::unique_ptr<PerfCounters> m_perfCounters = nullptr;
+	PerfCounters::PhaseHandle m_perfPhaseRenderFrame = 0;
+	PerfCounters::PhaseHandle m_perfPhaseRenderLayer = 0;
+	PerfCounters::PhaseHandle m_perfPhaseCulling = 0;
+	PerfCounters::PhaseHandle m_perfPhaseRecording = 0;
+	std::vector<PerfCounters::PhaseHandle> m_perfPhaseViews;
+
+	// Delays the start of cheap frames after xrWaitFrame() to reduce the pose latency. Requires the frame trace.
+	bool m_justInTimeFrameStartEnabled = false;
+	std::unique_ptr<JustInTimeFrameStart> m_justInTimeFrameStart = nullptr;
+
+	// The views are rendered by a split rendering server at m_splitRenderingAddress, if set.
+	std::string m_splitRenderingAddress;
+	std::unique_ptr<SplitRenderClient> m_splitRenderClient = nullptr;
+	SplitRenderClient::Frame m_splitRenderFrame{};
+	uint64_t m_splitRenderFrameIndex = 0;
+	void* m_splitRenderStagingBuffer = nullptr;
+	size_t m_splitRenderStagingBufferSize = 0;
+
+	// A YUV4MPEG2 video at m_videoPath, if set, is played in an equirect or a quad layer.
+	std::string m_videoPath;
+	bool m_videoEquirect = true;
+	std::unique_ptr<VideoLayer> m_videoLayer = nullptr;
+	SwapchainInfo m_videoSwapchainInfo = {};
+	bool m_videoFrameReleased = false;
+
 	struct RenderLayerInfo
 	{
 		XrTime predictedDisplayTime;
 		std::vector<XrCompositionLayerBaseHeader*> layers;
 		XrCompositionLayerProjection layerProjection = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
 		std::vector<XrCompositionLayerProjectionView> layerProjectionViews;
+		XrCompositionLayerQuad layerQuad = { XR_TYPE_COMPOSITION_LAYER_QUAD };
+		XrCompositionLayerEquirect2KHR layerEquirect = { XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR };
 	};
 };
 
+// Renders the generated stress scene from the views of a pose list into image files, without OpenXR. See BatchRenderer::ReadPoseList() for the format.
+int RunBatchRendering(const std::string& poseListPath, const std::string& outputDirectory)
+{
+	std::vector<XrView> views;
+	if (!BatchRenderer::ReadPoseList(poseListPath, views)) {
+		return 1;
+	}
+
+	// Without an XrInstance, the OpenGL context is created on a hidden window.
+	std::unique_ptr<GraphicsAPI> graphicsAPI = std::make_unique<GraphicsAPI_OpenGL>();
+	StressScene::CreateInfo stressSceneCI;
+	stressSceneCI.colorFormat = graphicsAPI->GetColorFormat();
+	stressSceneCI.depthFormat = graphicsAPI->GetDepthFormat();
+	StressScene stressScene(graphicsAPI.get(), stressSceneCI);
+
+	BatchRenderer::CreateInfo batchRendererCI;
+	batchRendererCI.colorFormat = stressSceneCI.colorFormat;
+	batchRendererCI.depthFormat = stressSceneCI.depthFormat;
+	batchRendererCI.outputDirectory = outputDirectory;
+	BatchRenderer batchRenderer(graphicsAPI.get(), batchRendererCI, [&](const XrView&, const XrMatrix4x4f& viewProjection, void* colorImageView, void* depthImageView, uint32_t width, uint32_t height) {
+		stressScene.Draw(viewProjection, colorImageView, depthImageView, width, height);
+	});
+	if (!batchRenderer.IsValid()) {
+		return 1;
+	}
+	batchRenderer.Render(views);
+
+	const BatchRenderer::Statistics& statistics = batchRenderer.GetStatistics();
+	XR_TUT_LOG("Batch: " << statistics.imagesRendered << " images in " << statistics.seconds << " s, " << statistics.imagesPerSecond << " images/s, "
+		<< statistics.imagesWritten << " written, " << statistics.readbackWaits << " readback waits, " << statistics.writerWaits << " writer waits.");
+	return 0;
+}
+
+// Renders a generated scene with increasing object counts, without OpenXR, and reports how the CPU and GPU times scale.
+int RunStressBenchmark(uint64_t seed, const std::string& reportPath)
+{
+	std::unique_ptr<GraphicsAPI> graphicsAPI = std::make_unique<GraphicsAPI_OpenGL>();
+	StressScene::CreateInfo stressSceneCI;
+	stressSceneCI.seed = seed;
+	stressSceneCI.colorFormat = graphicsAPI->GetColorFormat();
+	stressSceneCI.depthFormat = graphicsAPI->GetDepthFormat();
+	StressScene::RunScalingBenchmark(graphicsAPI.get(), stressSceneCI, { 250, 1000, 4000, 16000, 64000 }, 64, reportPath);
+	return 0;
+}
+
+// Reports the decompression throughput of an asset archive. If archivePath does not exist, writes an archive of 64 MB of
+// generated data with the redundancy of typical mesh and text assets there, and deletes it after the measurement.
+int RunArchiveBenchmark(const std::string& archivePath, uint32_t iterations)
+{
+	const bool generated = !std::ifstream(archivePath).good();
+	if (generated) {
+		std::vector<AssetArchive::File> files(16);
+		uint64_t state = 1;
+		for (size_t i = 0; i < files.size(); i++) {
+			files[i].name = "file" + std::to_string(i);
+			files[i].data.resize(4 * 1024 * 1024);
+			for (size_t j = 0; j < files[i].data.size(); j++) {
+				// Runs of a few symbols, with occasional random bytes.
+				state = state * 6364136223846793005ull + 1442695040888963407ull;
+				files[i].data[j] = (state >> 60) == 0 ? static_cast<uint8_t>(state >> 32) : static_cast<uint8_t>('a' + (j / 16 + (j % 7)) % 8);
+			}
+		}
+		if (!AssetArchive::Write(archivePath, files)) {
+			std::remove(archivePath.c_str());
+			return 1;
+		}
+	}
+	AssetArchive::BenchmarkResult result{};
+	bool valid = false;
+	{
+		AssetArchive archive(archivePath);
+		valid = archive.IsValid();
+		if (valid) {
+			result = archive.BenchmarkDecompression(JobSystem::Get(), iterations);
+		}
+	}
+	if (generated) {
+		std::remove(archivePath.c_str());
+	}
+	if (!valid) {
+		return 1;
+	}
+	XR_TUT_LOG("Asset Archive: " << result.uncompressedBytes / (1024 * 1024) << " MiB, Compression: " << static_cast<double>(result.uncompressedBytes) / static_cast<double>(std::max<uint64_t>(result.compressedBytes, 1))
+		<< ":1 Decompression: " << result.singleThreadedMBps << " MB/s on one thread, " << result.parallelMBps << " MB/s on " << JobSystem::Get().GetThreadCount() << " threads");
+	return 0;
+}
+
+// Checks that temporal upscaling is reproducible, without OpenXR.
+int RunTemporalUpscalerCheck()
+{
+	std::unique_ptr<GraphicsAPI> graphicsAPI = std::make_unique<GraphicsAPI_OpenGL>();
+	const bool passed = TemporalUpscaler::CheckDeterminism(graphicsAPI.get(), graphicsAPI->GetColorFormat(), graphicsAPI->GetDepthFormat(), graphicsAPI->GetMotionVectorFormat());
+	XR_TUT_LOG("Temporal Upscaler Determinism: " << (passed ? "Passed" : "Failed"));
+	return passed ? 0 : 1;
+}
+
+// Serves the views of a split rendering client with a generated scene, without OpenXR.
+int RunSplitRenderingServer(const std::string& address)
+{
+	std::unique_ptr<GraphicsAPI> graphicsAPI = std::make_unique<GraphicsAPI_OpenGL>();
+	StressScene::CreateInfo stressSceneCI;
+	stressSceneCI.colorFormat = graphicsAPI->GetColorFormat();
+	stressSceneCI.depthFormat = graphicsAPI->GetDepthFormat();
+	StressScene stressScene(graphicsAPI.get(), stressSceneCI);
+
+	SplitRenderServer::CreateInfo splitRenderServerCI;
+	splitRenderServerCI.address = address;
+	splitRenderServerCI.colorFormat = stressSceneCI.colorFormat;
+	splitRenderServerCI.depthFormat = stressSceneCI.depthFormat;
+	SplitRenderServer server(graphicsAPI.get(), splitRenderServerCI, [&](const XrView&, const XrMatrix4x4f& viewProjection, void* colorImageView, void* depthImageView, uint32_t width, uint32_t height) {
+		stressScene.Draw(viewProjection, colorImageView, depthImageView, width, height);
+	});
+	server.Serve();
+
+	const SplitRenderServer::Statistics& statistics = server.GetStatistics();
+	XR_TUT_LOG("Split Rendering Server: " << statistics.frames << " frames, " << statistics.skippedPoses << " skipped poses, Render: " << statistics.renderMs << " ms Encode: "
+		<< statistics.encodeMs << " ms Compression: " << statistics.compressionRatio << ":1");
+	return 0;
+}
+
 int main(int argc, char** argv)
 {
+	// main --batch <pose list> [output directory]
+	if (argc >= 3 && strcmp(argv[1], "--batch") == 0) {
+		return RunBatchRendering(argv[2], argc >= 4 ? argv[3] : "");
+	}
+	// main --stress [seed] [report path]
+	if (argc >= 2 && strcmp(argv[1], "--stress") == 0) {
+		return RunStressBenchmark(argc >= 3 ? strtoull(argv[2], nullptr, 10) : 1, argc >= 4 ? argv[3] : "StressScene.csv");
+	}
+
+	// main --archive-benchmark <archive> [iterations]
+	if (argc >= 3 && strcmp(argv[1], "--archive-benchmark") == 0) {
+		return RunArchiveBenchmark(argv[2], argc >= 4 ? static_cast<uint32_t>(strtoul(argv[3], nullptr, 10)) : 4);
+	}
+	// main --check-temporal-upscaler
+	if (argc >= 2 && strcmp(argv[1], "--check-temporal-upscaler") == 0) {
+		return RunTemporalUpscalerCheck();
+	}
+
+	// main --split-server <address>
+	if (argc >= 3 && strcmp(argv[1], "--split-server") == 0) {
+		return RunSplitRenderingServer(argv[2]);
+	}
+
 	OpenXRTutorial app(OPENGL);
+	// main --split-client <address>
+	if (argc >= 3 && strcmp(argv[1], "--split-client") == 0) {
+		app.SetSplitRenderingServer(argv[2]);
+	}
+	// main --video <y4m file> [quad]
+	if (argc >= 3 && strcmp(argv[1], "--video") == 0) {
+		app.SetVideo(argv[2], !(argc >= 4 && strcmp(argv[3], "quad") == 0));
+	}
+	// main --retune
+	if (argc >= 2 && strcmp(argv[1], "--retune") == 0) {
+		app.SetAutoTuneEnabled(true);
+		app.SetAutoTuneRetune(true);
+	}
+	// Optional passes, after any of the above: main ... [--far-field] [--half-resolution-transparency] [--temporal-upscaling] [--frame-trace] [--perf-counters] [--just-in-time-frame-start] [--auto-tune]
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--far-field") == 0) {
+			app.SetFarFieldEnabled(true);
+		} else if (strcmp(argv[i], "--half-resolution-transparency") == 0) {
+			app.SetHalfResolutionTransparencyEnabled(true);
+		} else if (strcmp(argv[i], "--temporal-upscaling") == 0) {
+			app.SetTemporalUpscalingEnabled(true);
+		} else if (strcmp(argv[i], "--frame-trace") == 0) {
+			app.SetFrameTraceEnabled(true);
+		} else if (strcmp(argv[i], "--perf-counters") == 0) {
+			app.SetPerfCountersEnabled(true);
+		} else if (strcmp(argv[i], "--just-in-time-frame-start") == 0) {
+			app.SetJustInTimeFrameStartEnabled(true);
+		} else if (strcmp(argv[i], "--auto-tune") == 0) {
+			app.SetAutoTuneEnabled(true);
+		}
+	}
 	app.Run();
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <AdaptiveQuality.h>
+
+AdaptiveQualityController::AdaptiveQualityController(const std::vector<QualityTier> &tiers, float escalationTime, float recoveryTime)
+    : m_tiers(tiers), m_escalationTime(escalationTime), m_recoveryTime(recoveryTime) {
+    if (m_tiers.empty()) {
+        m_tiers = GetDefaultTiers();
+    }
+    for (uint32_t domain = 0; domain < domainCount; domain++) {
+        for (uint32_t subDomain = 0; subDomain < subDomainCount; subDomain++) {
+            m_levels[domain][subDomain] = XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT;
+        }
+        m_requestedLevels[domain] = XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT;
+        m_requestPending[domain] = true;
+    }
+}
+
+void AdaptiveQualityController::OnNotification(const XrEventDataPerfSettingsEXT &notification) {
+    const uint32_t domain = static_cast<uint32_t>(notification.domain) - 1;
+    const uint32_t subDomain = static_cast<uint32_t>(notification.subDomain) - 1;
+    if (domain >= domainCount || subDomain >= subDomainCount) {
+        std::cout << "WARNING: AdaptiveQualityController: Unknown performance settings domain." << std::endl;
+        return;
+    }
+    m_levels[domain][subDomain] = notification.toLevel;
+    m_timeAtLevel = 0.0f;
+
+    if (notification.toLevel == XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT) {
+        SetTier(static_cast<uint32_t>(m_tiers.size()) - 1);
+    } else if (notification.toLevel > notification.fromLevel) {
+        SetTier(m_tierIndex + 1);
+    }
+
+    // Lowering the clocks is the quickest way to shed heat. Otherwise, keep a level that can be sustained.
+    const bool thermalPressure = m_levels[domain][XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT - 1] != XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT;
+    const XrPerfSettingsLevelEXT level = thermalPressure ? XR_PERF_SETTINGS_LEVEL_SUSTAINED_LOW_EXT : XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT;
+    if (level != m_requestedLevels[domain]) {
+        m_requestedLevels[domain] = level;
+        m_requestPending[domain] = true;
+    }
+}
+
+bool AdaptiveQualityController::Update(float deltaTime) {
+    m_timeAtLevel += deltaTime;
+    const XrPerfSettingsNotificationLevelEXT worstLevel = GetWorstLevel();
+    if (worstLevel == XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT && m_timeAtLevel >= m_recoveryTime && m_tierIndex > 0) {
+        SetTier(m_tierIndex - 1);
+        m_timeAtLevel = 0.0f;
+    } else if (worstLevel != XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT && m_timeAtLevel >= m_escalationTime) {
+        SetTier(m_tierIndex + 1);
+        m_timeAtLevel = 0.0f;
+    }
+
+    const bool tierChanged = m_tierChanged;
+    m_tierChanged = false;
+    return tierChanged;
+}
+
+bool AdaptiveQualityController::GetPerformanceLevelRequest(XrPerfSettingsDomainEXT domain, XrPerfSettingsLevelEXT &level) {
+    const uint32_t index = static_cast<uint32_t>(domain) - 1;
+    if (index >= domainCount || !m_requestPending[index]) {
+        return false;
+    }
+    level = m_requestedLevels[index];
+    m_requestPending[index] = false;
+    return true;
+}
+
+std::vector<AdaptiveQualityController::QualityTier> AdaptiveQualityController::GetDefaultTiers(uint32_t baselineSampleCount) {
+    return {
+        {1.0f, baselineSampleCount},
+        {0.9f, baselineSampleCount},
+        {0.8f, std::max(baselineSampleCount / 2, 1u)},
+        {0.7f, 1},
+        {0.6f, 1}};
+}
+
+XrPerfSettingsNotificationLevelEXT AdaptiveQualityController::GetWorstLevel() const {
+    XrPerfSettingsNotificationLevelEXT worstLevel = XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT;
+    for (uint32_t domain = 0; domain < domainCount; domain++) {
+        for (uint32_t subDomain = 0; subDomain < subDomainCount; subDomain++) {
+            worstLevel = std::max(worstLevel, m_levels[domain][subDomain]);
+        }
+    }
+    return worstLevel;
+}
+
+void AdaptiveQualityController::SetTier(uint32_t tierIndex) {
+    tierIndex = std::min(tierIndex, static_cast<uint32_t>(m_tiers.size()) - 1);
+    if (tierIndex != m_tierIndex) {
+        m_tierIndex = tierIndex;
+        m_tierChanged = true;
+    }
+}
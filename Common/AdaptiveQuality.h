@@ -0,0 +1,63 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+
+// Reacts to the runtime's XR_EXT_performance_settings notifications by stepping through quality tiers, ordered from the
+// highest to the lowest quality.
+//
+// A notification that raises any domain to WARNING steps down one tier, and IMPAIRED drops to the lowest tier. While a
+// warning persists, the quality keeps stepping down every escalationTime seconds, as the runtime only notifies on
+// changes. Once all domains are back to NORMAL for recoveryTime seconds, the quality steps up one tier at a time.
+// Thermal warnings also lower the performance level requested for their domain from SUSTAINED_HIGH to SUSTAINED_LOW.
+//
+// The controller only depends on the notifications passed to OnNotification() and the time passed to Update(), so
+// notifications can be injected directly to test it without a runtime.
+class AdaptiveQualityController {
+public:
+    struct QualityTier {
+        float resolutionScale;
+        uint32_t msaaSampleCount;
+    };
+
+    AdaptiveQualityController(const std::vector<QualityTier>& tiers, float escalationTime = 3.0f, float recoveryTime = 10.0f);
+
+    void OnNotification(const XrEventDataPerfSettingsEXT& notification);
+
+    // Advances the controller by deltaTime seconds. Returns true if the tier changed.
+    bool Update(float deltaTime);
+
+    const QualityTier& GetTier() const { return m_tiers[m_tierIndex]; }
+    uint32_t GetTierIndex() const { return m_tierIndex; }
+
+    // Returns true, and the level to request with xrPerfSettingsSetPerformanceLevelEXT(), if the level for the domain
+    // changed since the last call.
+    bool GetPerformanceLevelRequest(XrPerfSettingsDomainEXT domain, XrPerfSettingsLevelEXT& level);
+
+    // The highest tier is the baseline, full resolution with the swapchain's sample count, so that it adds no work.
+    // The lower tiers reduce the resolution down to 60% and the sample count down to 1.
+    static std::vector<QualityTier> GetDefaultTiers(uint32_t baselineSampleCount = 1);
+
+private:
+    static constexpr uint32_t domainCount = 2;     // CPU, GPU.
+    static constexpr uint32_t subDomainCount = 3;  // Compositing, rendering, thermal.
+
+    XrPerfSettingsNotificationLevelEXT GetWorstLevel() const;
+    void SetTier(uint32_t tierIndex);
+
+    std::vector<QualityTier> m_tiers;
+    float m_escalationTime = 0.0f;
+    float m_recoveryTime = 0.0f;
+
+    uint32_t m_tierIndex = 0;
+    bool m_tierChanged = false;
+    float m_timeAtLevel = 0.0f;
+
+    XrPerfSettingsNotificationLevelEXT m_levels[domainCount][subDomainCount] = {};
+    XrPerfSettingsLevelEXT m_requestedLevels[domainCount] = {};
+    bool m_requestPending[domainCount] = {};
+};
@@ -0,0 +1,438 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <AssetArchive.h>
+
+#include <chrono>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr uint32_t archiveVersion = 1;
+static constexpr uint32_t minMatchLength = 4;
+static constexpr size_t maxMatchOffset = 65535;
+static constexpr uint32_t matchHashBits = 14;
+
+static uint32_t HashSequence(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return (value * 2654435761u) >> (32 - matchHashBits);
+}
+
+static void WriteLength(std::vector<uint8_t> &output, size_t length) {
+    // Lengths of 15 and above continue in extension bytes, which are summed until one is below 255.
+    length -= 15;
+    while (length >= 255) {
+        output.push_back(255);
+        length -= 255;
+    }
+    output.push_back(static_cast<uint8_t>(length));
+}
+
+static bool ReadLength(const uint8_t *&source, const uint8_t *sourceEnd, size_t &length) {
+    uint8_t value = 255;
+    while (value == 255) {
+        if (source == sourceEnd) {
+            return false;
+        }
+        value = *source++;
+        length += value;
+    }
+    return true;
+}
+
+static void WriteSequence(std::vector<uint8_t> &output, const uint8_t *literals, size_t literalLength, size_t matchOffset, size_t matchLength) {
+    const size_t matchCode = matchLength > 0 ? matchLength - minMatchLength : 0;
+    output.push_back(static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLength >= 15) {
+        WriteLength(output, literalLength);
+    }
+    output.insert(output.end(), literals, literals + literalLength);
+    if (matchLength > 0) {
+        output.push_back(static_cast<uint8_t>(matchOffset & 0xFF));
+        output.push_back(static_cast<uint8_t>(matchOffset >> 8));
+        if (matchCode >= 15) {
+            WriteLength(output, matchCode);
+        }
+    }
+}
+
+AssetArchive::AssetArchive(const std::string &path) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cout << "ERROR: AssetArchive: Unable to open " << path << "." << std::endl;
+        return;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    if (!mapping) {
+        std::cout << "ERROR: AssetArchive: Unable to map " << path << "." << std::endl;
+        return;
+    }
+    m_data = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        std::cout << "ERROR: AssetArchive: Unable to open " << path << "." << std::endl;
+        return;
+    }
+    struct stat fileStat;
+    if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0) {
+        void *mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping != MAP_FAILED) {
+            m_data = (const uint8_t *)mapping;
+            m_size = static_cast<size_t>(fileStat.st_size);
+        }
+    }
+    // The mapping stays valid after the file is closed.
+    close(file);
+#endif
+    if (!m_data) {
+        std::cout << "ERROR: AssetArchive: Unable to map " << path << "." << std::endl;
+        return;
+    }
+
+    // Validate the tables, so that lookups only need to validate the chunks they read.
+    const Header *header = (const Header *)m_data;
+    if (m_size < sizeof(Header) || memcmp(header->magic, "XRAR", 4) != 0 || header->version != archiveVersion) {
+        std::cout << "ERROR: AssetArchive: " << path << " is not an asset archive." << std::endl;
+        return;
+    }
+    const uint64_t chunksEnd = sizeof(Header) + (uint64_t)header->chunkCount * sizeof(ChunkEntry);
+    const uint64_t directoryEnd = chunksEnd + (uint64_t)header->directorySlotCount * sizeof(DirectoryEntry);
+    const bool powerOfTwo = header->directorySlotCount > 0 && (header->directorySlotCount & (header->directorySlotCount - 1)) == 0;
+    if (!powerOfTwo || directoryEnd > m_size || header->namesOffset < directoryEnd || header->namesOffset + header->namesSize > m_size) {
+        std::cout << "ERROR: AssetArchive: " << path << " is truncated or corrupt." << std::endl;
+        return;
+    }
+    m_chunks = (const ChunkEntry *)(m_data + sizeof(Header));
+    m_directory = (const DirectoryEntry *)(m_data + chunksEnd);
+    m_names = (const char *)(m_data + header->namesOffset);
+    m_header = header;
+}
+
+AssetArchive::~AssetArchive() {
+#if defined(_WIN32)
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle) {
+        CloseHandle((HANDLE)m_mappingHandle);
+    }
+    if (m_fileHandle) {
+        CloseHandle((HANDLE)m_fileHandle);
+    }
+#else
+    if (m_data) {
+        munmap((void *)m_data, m_size);
+    }
+#endif
+}
+
+int64_t AssetArchive::GetFileSize(const std::string &name) const {
+    const DirectoryEntry *entry = FindFile(name);
+    return entry ? static_cast<int64_t>(entry->size) : -1;
+}
+
+bool AssetArchive::Read(const std::string &name, uint64_t offset, uint64_t size, void *data, JobSystem *jobSystem) const {
+    const DirectoryEntry *entry = FindFile(name);
+    // Written so that offset + size cannot overflow.
+    if (!entry || offset > entry->size || size > entry->size - offset) {
+        std::cout << "ERROR: AssetArchive: Unable to read " << size << " bytes at " << offset << " of " << name << "." << std::endl;
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    const uint64_t chunkSize = m_header->chunkSize;
+    const uint32_t firstChunk = static_cast<uint32_t>(offset / chunkSize);
+    const uint32_t chunkCount = static_cast<uint32_t>((offset + size - 1) / chunkSize) - firstChunk + 1;
+    if (firstChunk + chunkCount > entry->chunkCount) {
+        std::cout << "ERROR: AssetArchive: " << name << " is corrupt." << std::endl;
+        return false;
+    }
+    std::atomic<bool> success{true};
+    auto DecompressRange = [&](uint32_t begin, uint32_t end) {
+        std::vector<uint8_t> partialChunk;
+        for (uint32_t i = begin; i < end; i++) {
+            // Chunks that are covered completely decompress straight into the destination.
+            const uint64_t chunkBegin = (uint64_t)(firstChunk + i) * chunkSize;
+            const uint64_t chunkEnd = std::min(chunkBegin + chunkSize, (uint64_t)entry->size);
+            const uint64_t copyBegin = std::max(chunkBegin, offset);
+            const uint64_t copyEnd = std::min(chunkEnd, offset + size);
+            uint8_t *destination = (uint8_t *)data + (copyBegin - offset);
+            bool chunkSuccess = false;
+            if (copyBegin == chunkBegin && copyEnd == chunkEnd) {
+                chunkSuccess = DecompressChunk(entry->firstChunk + firstChunk + i, destination, static_cast<uint32_t>(chunkEnd - chunkBegin));
+            } else {
+                partialChunk.resize(static_cast<size_t>(chunkEnd - chunkBegin));
+                chunkSuccess = DecompressChunk(entry->firstChunk + firstChunk + i, partialChunk.data(), static_cast<uint32_t>(partialChunk.size()));
+                if (chunkSuccess) {
+                    memcpy(destination, partialChunk.data() + (copyBegin - chunkBegin), static_cast<size_t>(copyEnd - copyBegin));
+                }
+            }
+            if (!chunkSuccess) {
+                success = false;
+            }
+        }
+    };
+    if (jobSystem && chunkCount > 1) {
+        jobSystem->ParallelFor(chunkCount, 1, DecompressRange);
+    } else {
+        DecompressRange(0, chunkCount);
+    }
+
+    if (!success) {
+        std::cout << "ERROR: AssetArchive: " << name << " is corrupt." << std::endl;
+    }
+    return success;
+}
+
+bool AssetArchive::ReadFile(const std::string &name, std::vector<uint8_t> &data, JobSystem *jobSystem) const {
+    const int64_t size = GetFileSize(name);
+    if (size < 0) {
+        std::cout << "ERROR: AssetArchive: Unable to find " << name << "." << std::endl;
+        return false;
+    }
+    data.resize(static_cast<size_t>(size));
+    return Read(name, 0, static_cast<uint64_t>(size), data.data(), jobSystem);
+}
+
+AssetArchive::BenchmarkResult AssetArchive::BenchmarkDecompression(JobSystem &jobSystem, uint32_t iterations) const {
+    BenchmarkResult result{};
+    if (!IsValid()) {
+        return result;
+    }
+    uint32_t largestChunk = 0;
+    for (uint32_t i = 0; i < m_header->chunkCount; i++) {
+        result.uncompressedBytes += m_chunks[i].uncompressedSize;
+        result.compressedBytes += m_chunks[i].compressedSize;
+        largestChunk = std::max(largestChunk, m_chunks[i].uncompressedSize);
+    }
+    iterations = std::max(iterations, 1u);
+
+    auto MeasureMBps = [&](const std::function<void(uint32_t, uint32_t)> &run) {
+        const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            run(0, m_header->chunkCount);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        return seconds > 0.0 ? (double)result.uncompressedBytes * iterations / (seconds * 1e6) : 0.0;
+    };
+
+    // Each worker decompresses its chunks into its own buffer, so the benchmark measures the codec and not the allocator.
+    auto DecompressChunks = [&](uint32_t begin, uint32_t end) {
+        std::vector<uint8_t> buffer(largestChunk);
+        for (uint32_t chunk = begin; chunk < end; chunk++) {
+            DecompressChunk(chunk, buffer.data(), m_chunks[chunk].uncompressedSize);
+        }
+    };
+    result.singleThreadedMBps = MeasureMBps(DecompressChunks);
+    result.parallelMBps = MeasureMBps([&](uint32_t begin, uint32_t end) {
+        jobSystem.ParallelFor(end - begin, 16, DecompressChunks);
+    });
+    return result;
+}
+
+bool AssetArchive::Write(const std::string &path, const std::vector<File> &files, uint32_t chunkSize) {
+    if (chunkSize == 0) {
+        std::cout << "ERROR: AssetArchive: The chunk size must not be 0." << std::endl;
+        return false;
+    }
+
+    Header header{{'X', 'R', 'A', 'R'}, archiveVersion, chunkSize, static_cast<uint32_t>(files.size()), 1, 0, 0, 0};
+    while (header.directorySlotCount < files.size() * 2) {
+        header.directorySlotCount *= 2;
+    }
+
+    // Compress all chunks. Directory entries are placed at their hash, probing linearly to the next free slot.
+    std::vector<ChunkEntry> chunks;
+    std::vector<std::vector<uint8_t>> chunkData;
+    std::vector<DirectoryEntry> directory(header.directorySlotCount, DirectoryEntry{});
+    std::string names;
+    for (const File &file : files) {
+        DirectoryEntry entry{HashName(file.name.data(), file.name.size()), file.data.size(), static_cast<uint32_t>(names.size()), static_cast<uint32_t>(file.name.size()), static_cast<uint32_t>(chunks.size()), 0};
+        names += file.name;
+        for (size_t offset = 0; offset < file.data.size(); offset += chunkSize) {
+            const size_t size = std::min<size_t>(chunkSize, file.data.size() - offset);
+            std::vector<uint8_t> compressed;
+            Compress(file.data.data() + offset, size, compressed);
+            if (compressed.size() >= size) {
+                compressed.assign(file.data.begin() + offset, file.data.begin() + offset + size);
+            }
+            chunks.push_back({0, static_cast<uint32_t>(compressed.size()), static_cast<uint32_t>(size)});
+            chunkData.push_back(std::move(compressed));
+            entry.chunkCount++;
+        }
+
+        uint32_t slot = static_cast<uint32_t>(entry.nameHash) & (header.directorySlotCount - 1);
+        while (directory[slot].nameHash != 0) {
+            const DirectoryEntry &other = directory[slot];
+            if (other.nameHash == entry.nameHash && names.compare(other.nameOffset, other.nameLength, file.name) == 0) {
+                std::cout << "ERROR: AssetArchive: " << file.name << " is added more than once." << std::endl;
+                return false;
+            }
+            slot = (slot + 1) & (header.directorySlotCount - 1);
+        }
+        directory[slot] = entry;
+    }
+
+    header.chunkCount = static_cast<uint32_t>(chunks.size());
+    header.namesOffset = sizeof(Header) + chunks.size() * sizeof(ChunkEntry) + directory.size() * sizeof(DirectoryEntry);
+    header.namesSize = names.size();
+    uint64_t offset = header.namesOffset + header.namesSize;
+    for (ChunkEntry &chunk : chunks) {
+        chunk.offset = offset;
+        offset += chunk.compressedSize;
+    }
+
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream) {
+        std::cout << "ERROR: AssetArchive: Unable to create " << path << "." << std::endl;
+        return false;
+    }
+    stream.write((const char *)&header, sizeof(header));
+    stream.write((const char *)chunks.data(), (std::streamsize)(chunks.size() * sizeof(ChunkEntry)));
+    stream.write((const char *)directory.data(), (std::streamsize)(directory.size() * sizeof(DirectoryEntry)));
+    stream.write(names.data(), (std::streamsize)names.size());
+    for (const std::vector<uint8_t> &data : chunkData) {
+        stream.write((const char *)data.data(), (std::streamsize)data.size());
+    }
+    return stream.good();
+}
+
+void AssetArchive::Compress(const uint8_t *source, size_t sourceSize, std::vector<uint8_t> &compressed) {
+    compressed.clear();
+    compressed.reserve(GetMaxCompressedSize(sourceSize));
+
+    // Greedy parsing: Each position is looked up in a hash table of the last position of each 4 byte sequence.
+    // Positions are stored plus one, so that 0 marks an empty entry.
+    std::vector<uint32_t> lastPositions(size_t(1) << matchHashBits, 0);
+    size_t literalStart = 0;
+    size_t position = 0;
+    while (position + minMatchLength <= sourceSize) {
+        const uint32_t hash = HashSequence(source + position);
+        const size_t candidate = lastPositions[hash];
+        lastPositions[hash] = static_cast<uint32_t>(position + 1);
+        if (candidate == 0 || position - (candidate - 1) > maxMatchOffset || memcmp(source + candidate - 1, source + position, minMatchLength) != 0) {
+            position++;
+            continue;
+        }
+
+        const size_t matchPosition = candidate - 1;
+        size_t matchLength = minMatchLength;
+        while (position + matchLength < sourceSize && source[matchPosition + matchLength] == source[position + matchLength]) {
+            matchLength++;
+        }
+        WriteSequence(compressed, source + literalStart, position - literalStart, position - matchPosition, matchLength);
+        position += matchLength;
+        literalStart = position;
+    }
+    if (literalStart < sourceSize) {
+        WriteSequence(compressed, source + literalStart, sourceSize - literalStart, 0, 0);
+    }
+}
+
+bool AssetArchive::Decompress(const uint8_t *source, size_t sourceSize, uint8_t *destination, size_t destinationSize) {
+    const uint8_t *sourceEnd = source + sourceSize;
+    uint8_t *const destinationBegin = destination;
+    uint8_t *const destinationEnd = destination + destinationSize;
+    while (source < sourceEnd) {
+        const uint8_t token = *source++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(source, sourceEnd, literalLength)) {
+            return false;
+        }
+        if (literalLength > (size_t)(sourceEnd - source) || literalLength > (size_t)(destinationEnd - destination)) {
+            return false;
+        }
+        memcpy(destination, source, literalLength);
+        source += literalLength;
+        destination += literalLength;
+        if (source == sourceEnd) {
+            break;
+        }
+
+        if (sourceEnd - source < 2) {
+            return false;
+        }
+        const size_t matchOffset = source[0] | (source[1] << 8);
+        source += 2;
+        size_t matchLength = token & 0xF;
+        if (matchLength == 15 && !ReadLength(source, sourceEnd, matchLength)) {
+            return false;
+        }
+        matchLength += minMatchLength;
+        if (matchOffset == 0 || matchOffset > (size_t)(destination - destinationBegin) || matchLength > (size_t)(destinationEnd - destination)) {
+            return false;
+        }
+        // Matches may overlap their own output, e.g. runs with an offset of 1, so copy byte by byte.
+        const uint8_t *match = destination - matchOffset;
+        for (size_t i = 0; i < matchLength; i++) {
+            destination[i] = match[i];
+        }
+        destination += matchLength;
+    }
+    return destination == destinationEnd;
+}
+
+uint64_t AssetArchive::HashName(const char *name, size_t length) {
+    // 64 bit FNV-1a. 0 marks empty directory slots, so it is never returned.
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)name[i]) * 1099511628211ull;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+const AssetArchive::DirectoryEntry *AssetArchive::FindFile(const std::string &name) const {
+    if (!IsValid()) {
+        return nullptr;
+    }
+    const uint64_t hash = HashName(name.data(), name.size());
+    const uint32_t mask = m_header->directorySlotCount - 1;
+    for (uint32_t i = 0, slot = static_cast<uint32_t>(hash) & mask; i <= mask; i++, slot = (slot + 1) & mask) {
+        const DirectoryEntry &entry = m_directory[slot];
+        if (entry.nameHash == 0) {
+            return nullptr;
+        }
+        if (entry.nameHash == hash && entry.nameLength == name.size() && (uint64_t)entry.nameOffset + entry.nameLength <= m_header->namesSize &&
+            memcmp(m_names + entry.nameOffset, name.data(), name.size()) == 0) {
+            if ((uint64_t)entry.firstChunk + entry.chunkCount > m_header->chunkCount) {
+                return nullptr;
+            }
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool AssetArchive::DecompressChunk(uint32_t chunk, uint8_t *destination, uint32_t size) const {
+    const ChunkEntry &entry = m_chunks[chunk];
+    if (entry.uncompressedSize != size || entry.offset + entry.compressedSize > m_size) {
+        return false;
+    }
+    const uint8_t *source = m_data + entry.offset;
+    if (entry.compressedSize == entry.uncompressedSize) {
+        memcpy(destination, source, entry.uncompressedSize);
+        return true;
+    }
+    return Decompress(source, entry.compressedSize, destination, entry.uncompressedSize);
+}
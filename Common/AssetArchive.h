@@ -0,0 +1,100 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <JobSystem.h>
+
+// A read only archive of many asset files in a single file, which avoids the open and seek overhead and the wasted
+// space of loose files.
+//
+// Each file is split into chunks of chunkSize bytes (64 KB by default), which are compressed independently with an
+// in-tree LZ77 codec, so any byte range of a file can be read by decompressing only the chunks that cover it. Reads
+// that cover several chunks decompress them in parallel on a JobSystem. File names are looked up in a hashed directory
+// with open addressing, in O(1). The archive is memory mapped, so the chunks are read straight from the page cache.
+//
+// Layout: Header | ChunkEntry[chunkCount] | DirectoryEntry[directorySlotCount] | names | chunk data.
+// A chunk whose compressed size equals its uncompressed size is stored uncompressed.
+class AssetArchive {
+public:
+    struct File {
+        std::string name;
+        std::vector<uint8_t> data;
+    };
+
+    struct BenchmarkResult {
+        uint64_t uncompressedBytes;
+        uint64_t compressedBytes;
+        double singleThreadedMBps;
+        double parallelMBps;
+    };
+
+    AssetArchive(const std::string& path);
+    ~AssetArchive();
+
+    bool IsValid() const { return m_header != nullptr; }
+
+    bool Contains(const std::string& name) const { return FindFile(name) != nullptr; }
+    // Returns the uncompressed size of the file, or -1 if the archive does not contain it.
+    int64_t GetFileSize(const std::string& name) const;
+
+    // Reads size bytes from offset of the file into data. Without a jobSystem, all chunks are decompressed on the calling thread.
+    bool Read(const std::string& name, uint64_t offset, uint64_t size, void* data, JobSystem* jobSystem = nullptr) const;
+    bool ReadFile(const std::string& name, std::vector<uint8_t>& data, JobSystem* jobSystem = nullptr) const;
+
+    // Decompresses every file of the archive iterations times, on the calling thread and then across the jobSystem,
+    // and reports the decompression throughput in uncompressed megabytes per second.
+    BenchmarkResult BenchmarkDecompression(JobSystem& jobSystem, uint32_t iterations = 4) const;
+
+    static bool Write(const std::string& path, const std::vector<File>& files, uint32_t chunkSize = 65536);
+
+    // The LZ77 codec: Sequences of a token byte, holding the literal length and the match length - 4 in 4 bits each,
+    // with 255 valued extension bytes for longer lengths, the literals and a 16 bit little endian match offset.
+    // The final sequence has no match.
+    static void Compress(const uint8_t* source, size_t sourceSize, std::vector<uint8_t>& compressed);
+    // The largest compressed size of sourceSize bytes, reached by incompressible data.
+    static size_t GetMaxCompressedSize(size_t sourceSize) { return sourceSize + sourceSize / 255 + 16; }
+    static bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t chunkSize;
+        uint32_t fileCount;
+        uint32_t directorySlotCount;  // A power of two.
+        uint32_t chunkCount;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+    };
+    struct ChunkEntry {
+        uint64_t offset;
+        uint32_t compressedSize;
+        uint32_t uncompressedSize;
+    };
+    struct DirectoryEntry {
+        uint64_t nameHash;  // 0 for empty slots.
+        uint64_t size;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t firstChunk;
+        uint32_t chunkCount;
+    };
+
+    static uint64_t HashName(const char* name, size_t length);
+    const DirectoryEntry* FindFile(const std::string& name) const;
+    bool DecompressChunk(uint32_t chunk, uint8_t* destination, uint32_t size) const;
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    const Header* m_header = nullptr;
+    const ChunkEntry* m_chunks = nullptr;
+    const DirectoryEntry* m_directory = nullptr;
+    const char* m_names = nullptr;
+#if defined(_WIN32)
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,407 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <AutoTuner.h>
+
+#include <chrono>
+
+// Preceded by #version and, for multiview, the MULTIVIEW define.
+static const char *autoTunerVertexShaderSource = R"(
+#ifdef MULTIVIEW
+#extension GL_OVR_multiview2 : require
+layout(num_views = 2) in;
+#endif
+layout(std140, binding = 0) uniform DrawUniforms {
+    vec4 rect;
+    vec4 depthColor;
+};
+layout(std140, binding = 1) uniform ViewUniforms {
+    vec4 shifts;
+};
+layout(location = 0) in vec2 a_Position;
+layout(location = 0) out vec2 o_TexCoord;
+void main() {
+#ifdef MULTIVIEW
+    int viewIndex = int(gl_ViewID_OVR);
+#else
+    int viewIndex = int(shifts.z);
+#endif
+    vec2 position = rect.xy + a_Position * rect.zw;
+    position.x += shifts[viewIndex];
+    o_TexCoord = a_Position;
+    gl_Position = vec4(position, depthColor.x, 1.0);
+}
+)";
+
+static const char *autoTunerFragmentShaderSource = R"(
+#version 450
+layout(std140, binding = 0) uniform DrawUniforms {
+    vec4 rect;
+    vec4 depthColor;
+};
+layout(location = 0) in vec2 i_TexCoord;
+layout(location = 0) out vec4 o_Color;
+void main() {
+    // A fixed cost per fragment, standing in for texturing and lighting.
+    float pattern = 0.0;
+    for (int i = 1; i <= 8; i++) {
+        pattern += sin(i_TexCoord.x * float(i) * 7.0) * cos(i_TexCoord.y * float(i) * 5.0);
+    }
+    o_Color = vec4(depthColor.yzw * (0.75 + pattern / 32.0), 1.0);
+}
+)";
+
+AutoTuner::AutoTuner(GraphicsAPI *graphicsAPI, const CreateInfo &createInfo)
+    : m_graphicsAPI(graphicsAPI), m_createInfo(createInfo) {
+    const std::string vertexSource = std::string("#version 450\n") + autoTunerVertexShaderSource;
+    m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, vertexSource.c_str(), vertexSource.size()});
+    if (m_graphicsAPI->IsMultiviewSupported()) {
+        const std::string multiviewVertexSource = std::string("#version 450\n#define MULTIVIEW\n") + autoTunerVertexShaderSource;
+        m_multiviewVertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, multiviewVertexSource.c_str(), multiviewVertexSource.size()});
+    }
+    m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, autoTunerFragmentShaderSource, strlen(autoTunerFragmentShaderSource)});
+
+    // A unit square of gridSize x gridSize cells.
+    const uint32_t gridSize = std::max(m_createInfo.gridSize, 1u);
+    std::vector<float> vertices;
+    for (uint32_t y = 0; y <= gridSize; y++) {
+        for (uint32_t x = 0; x <= gridSize; x++) {
+            vertices.push_back((float)x / (float)gridSize);
+            vertices.push_back((float)y / (float)gridSize);
+        }
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < gridSize; y++) {
+        for (uint32_t x = 0; x < gridSize; x++) {
+            const uint32_t i = y * (gridSize + 1) + x;
+            indices.insert(indices.end(), {i, i + 1, i + gridSize + 2, i, i + gridSize + 2, i + gridSize + 1});
+        }
+    }
+    m_vertexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::VERTEX, sizeof(float) * 2, vertices.size() * sizeof(float), vertices.data()});
+    m_indexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::INDEX, sizeof(uint32_t), indices.size() * sizeof(uint32_t), indices.data()});
+    m_indexCount = (uint32_t)indices.size();
+
+    // Quads of random sizes and positions, drawn back to front, so that every fragment passes the depth test.
+    uint64_t state = 1;
+    auto Random = [&state]() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return (float)(state >> 40) / (float)(1ull << 24);
+    };
+    m_drawUniforms.resize((size_t)m_createInfo.drawCount * uniformStride);
+    for (uint32_t i = 0; i < m_createInfo.drawCount; i++) {
+        DrawUniforms uniforms{};
+        const float size = 0.1f + 0.3f * Random();
+        uniforms.rect[0] = -1.0f + (2.0f - size) * Random();
+        uniforms.rect[1] = -1.0f + (2.0f - size) * Random();
+        uniforms.rect[2] = size;
+        uniforms.rect[3] = size;
+        uniforms.depth[0] = 1.0f - (float)(i + 1) / (float)(m_createInfo.drawCount + 1);
+        uniforms.depth[1] = Random();
+        uniforms.depth[2] = Random();
+        uniforms.depth[3] = Random();
+        memcpy(m_drawUniforms.data() + i * uniformStride, &uniforms, sizeof(uniforms));
+    }
+    m_drawUniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(DrawUniforms), nullptr});
+    m_drawUniformRingBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, m_drawUniforms.size() * ringFrameCount, nullptr});
+
+    // A small disparity between the views, alternating between the left and the right eye. One pass per view selects
+    // the eye with the index in each block.
+    const size_t viewCount = m_createInfo.viewSizes.size();
+    std::vector<uint8_t> viewUniforms(uniformStride * std::max<size_t>(viewCount, 1));
+    for (size_t i = 0; i < viewCount; i++) {
+        const ViewUniforms uniforms = {{0.02f, -0.02f, (float)(i % 2), 0.0f}};
+        memcpy(viewUniforms.data() + i * uniformStride, &uniforms, sizeof(uniforms));
+    }
+    m_viewUniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, viewUniforms.size(), viewUniforms.data()});
+}
+
+AutoTuner::~AutoTuner() {
+    m_graphicsAPI->DestroyBuffer(m_viewUniformBuffer);
+    m_graphicsAPI->DestroyBuffer(m_drawUniformRingBuffer);
+    m_graphicsAPI->DestroyBuffer(m_drawUniformBuffer);
+    m_graphicsAPI->DestroyBuffer(m_indexBuffer);
+    m_graphicsAPI->DestroyBuffer(m_vertexBuffer);
+    m_graphicsAPI->DestroyShader(m_fragmentShader);
+    if (m_multiviewVertexShader) {
+        m_graphicsAPI->DestroyShader(m_multiviewVertexShader);
+    }
+    m_graphicsAPI->DestroyShader(m_vertexShader);
+}
+
+AutoTuner::Settings AutoTuner::Tune() {
+    Settings settings;
+    auto Log = [](const std::string &candidate, float frameMs) {
+        std::cout << "AutoTuner: " << candidate << ": " << frameMs << " ms" << std::endl;
+    };
+
+    // 1. The largest resolution scale within the budget, or the smallest scale.
+    for (float resolutionScale : m_createInfo.resolutionScales) {
+        settings.resolutionScale = resolutionScale;
+        const float frameMs = MeasureFrameMs(settings);
+        Log("Resolution Scale " + std::to_string(resolutionScale), frameMs);
+        if (frameMs <= m_createInfo.frameBudgetMs) {
+            break;
+        }
+    }
+
+    // 2. The largest sample count within the budget, or none.
+    for (uint32_t msaaSampleCount : m_createInfo.msaaSampleCounts) {
+        Settings candidate = settings;
+        candidate.msaaSampleCount = msaaSampleCount;
+        const float frameMs = MeasureFrameMs(candidate);
+        Log("MSAA " + std::to_string(msaaSampleCount), frameMs);
+        if (frameMs <= m_createInfo.frameBudgetMs) {
+            settings = candidate;
+            break;
+        }
+    }
+
+    // 3. Multiview, if it is faster than one pass per view.
+    const std::vector<ViewSize> &viewSizes = m_createInfo.viewSizes;
+    const bool sameSizeStereo = viewSizes.size() == 2 && viewSizes[0].width == viewSizes[1].width && viewSizes[0].height == viewSizes[1].height;
+    if (settings.msaaSampleCount == 1 && m_multiviewVertexShader && sameSizeStereo) {
+        const float perViewMs = MeasureFrameMs(settings);
+        Log("Per View", perViewMs);
+        Settings candidate = settings;
+        candidate.multiview = true;
+        const float multiviewMs = MeasureFrameMs(candidate);
+        Log("Multiview", multiviewMs);
+        settings.multiview = multiviewMs < perViewMs;
+    }
+
+    // 4. The fastest buffer update strategy.
+    float fastestMs = 0.0f;
+    for (BufferUpdateStrategy strategy : {BufferUpdateStrategy::SET_DATA, BufferUpdateStrategy::MAP, BufferUpdateStrategy::RING}) {
+        Settings candidate = settings;
+        candidate.bufferUpdateStrategy = strategy;
+        const float frameMs = MeasureFrameMs(candidate);
+        Log(std::string("Buffer Update ") + ToString(strategy), frameMs);
+        if (strategy == BufferUpdateStrategy::SET_DATA || frameMs < fastestMs) {
+            settings.bufferUpdateStrategy = strategy;
+            fastestMs = frameMs;
+        }
+    }
+    return settings;
+}
+
+float AutoTuner::MeasureFrameMs(const Settings &settings) {
+    if (settings.multiview && !m_multiviewVertexShader) {
+        std::cout << "ERROR: AutoTuner: Multiview is not supported." << std::endl;
+        return 0.0f;
+    }
+    const uint32_t samples = std::max(settings.msaaSampleCount, 1u);
+
+    // Multiview renders into all layers of an array image at once, at the size of the first view. Otherwise each view
+    // has its own images, at its own resolution.
+    std::vector<ViewSize> viewSizes;
+    std::vector<void *> images;
+    std::vector<void *> colorImageViews;
+    std::vector<void *> depthImageViews;
+    const size_t imageCount = settings.multiview ? std::min<size_t>(m_createInfo.viewSizes.size(), 1) : m_createInfo.viewSizes.size();
+    const uint32_t layers = settings.multiview ? (uint32_t)m_createInfo.viewSizes.size() : 1;
+    const GraphicsAPI::ImageViewCreateInfo::View viewType = settings.multiview ? GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D_ARRAY : GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D;
+    for (size_t i = 0; i < imageCount; i++) {
+        const ViewSize &viewSize = m_createInfo.viewSizes[i];
+        const uint32_t width = std::max((uint32_t)((float)viewSize.width * settings.resolutionScale), 1u);
+        const uint32_t height = std::max((uint32_t)((float)viewSize.height * settings.resolutionScale), 1u);
+        void *colorImage = m_graphicsAPI->CreateImage({2, width, height, 1, 1, layers, samples, m_createInfo.colorFormat, false, true, false, false});
+        void *depthImage = m_graphicsAPI->CreateImage({2, width, height, 1, 1, layers, samples, m_createInfo.depthFormat, false, false, true, false});
+        colorImageViews.push_back(m_graphicsAPI->CreateImageView({colorImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, viewType, m_createInfo.colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, layers}));
+        depthImageViews.push_back(m_graphicsAPI->CreateImageView({depthImage, GraphicsAPI::ImageViewCreateInfo::Type::DSV, viewType, m_createInfo.depthFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::DEPTH_BIT, 0, 1, 0, layers}));
+        images.push_back(colorImage);
+        images.push_back(depthImage);
+        viewSizes.push_back({width, height});
+    }
+
+    GraphicsAPI::PipelineCreateInfo pipelineCI{};
+    pipelineCI.shaders = {settings.multiview ? m_multiviewVertexShader : m_vertexShader, m_fragmentShader};
+    pipelineCI.vertexInputState.attributes = {{0, 0, GraphicsAPI::VertexType::VEC2, 0, "TEXCOORD"}};
+    pipelineCI.vertexInputState.bindings = {{0, 0, sizeof(float) * 2}};
+    pipelineCI.inputAssemblyState = {GraphicsAPI::PrimitiveTopology::TRIANGLE_LIST, false};
+    pipelineCI.rasterisationState = {false, false, GraphicsAPI::PolygonMode::FILL, GraphicsAPI::CullMode::NONE, GraphicsAPI::FrontFace::COUNTER_CLOCKWISE, false, 0.0f, 0.0f, 0.0f, 1.0f};
+    pipelineCI.multisampleState = {samples, false, 1.0f, 0, false, false};
+    pipelineCI.depthStencilState = {true, true, GraphicsAPI::CompareOp::LESS_OR_EQUAL, false, false, {}, {}, 0.0f, 1.0f};
+    pipelineCI.colorBlendState = {false, GraphicsAPI::LogicOp::NO_OP, {{false, GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ZERO, GraphicsAPI::BlendOp::ADD, GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ZERO, GraphicsAPI::BlendOp::ADD, (GraphicsAPI::ColorComponentBit)15}}, {0.0f, 0.0f, 0.0f, 0.0f}};
+    pipelineCI.colorFormats = {m_createInfo.colorFormat};
+    pipelineCI.depthFormat = m_createInfo.depthFormat;
+    pipelineCI.layout = {{0, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX},
+                         {1, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX}};
+    void *pipeline = m_graphicsAPI->CreatePipeline(pipelineCI);
+
+    // The frames are submitted back to back. Waiting for the last one includes the GPU time still queued.
+    auto WaitForGPU = [this]() {
+        void *fence = m_graphicsAPI->CreateFence();
+        m_graphicsAPI->WaitForFence(fence, ~0ull);
+        m_graphicsAPI->DestroyFence(fence);
+    };
+    for (uint32_t frame = 0; frame < m_createInfo.warmupFrames; frame++) {
+        RenderFrame(settings, pipeline, colorImageViews.data(), depthImageViews.data(), viewSizes, frame);
+    }
+    WaitForGPU();
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < m_createInfo.measureFrames; frame++) {
+        RenderFrame(settings, pipeline, colorImageViews.data(), depthImageViews.data(), viewSizes, m_createInfo.warmupFrames + frame);
+    }
+    WaitForGPU();
+    const float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count();
+
+    m_graphicsAPI->DestroyPipeline(pipeline);
+    for (void *&imageView : colorImageViews) {
+        m_graphicsAPI->DestroyImageView(imageView);
+    }
+    for (void *&imageView : depthImageViews) {
+        m_graphicsAPI->DestroyImageView(imageView);
+    }
+    for (void *&image : images) {
+        m_graphicsAPI->DestroyImage(image);
+    }
+    return seconds * 1000.0f / (float)std::max(m_createInfo.measureFrames, 1u);
+}
+
+void AutoTuner::RenderFrame(const Settings &settings, void *pipeline, void **colorImageViews, void **depthImageViews, const std::vector<ViewSize> &viewSizes, uint32_t frameIndex) {
+    m_graphicsAPI->BeginRendering();
+    if (settings.bufferUpdateStrategy == BufferUpdateStrategy::RING) {
+        const size_t regionSize = m_drawUniforms.size();
+        m_graphicsAPI->SetBufferData(m_drawUniformRingBuffer, (frameIndex % ringFrameCount) * regionSize, regionSize, m_drawUniforms.data());
+    }
+
+    for (size_t view = 0; view < viewSizes.size(); view++) {
+        const uint32_t width = viewSizes[view].width;
+        const uint32_t height = viewSizes[view].height;
+        m_graphicsAPI->ClearColor(colorImageViews[view], 0.17f, 0.17f, 0.17f, 1.00f);
+        m_graphicsAPI->ClearDepth(depthImageViews[view], 1.0f);
+        m_graphicsAPI->SetRenderAttachments(&colorImageViews[view], 1, depthImageViews[view], width, height, pipeline);
+        GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f};
+        GraphicsAPI::Rect2D scissor = {{0, 0}, {width, height}};
+        m_graphicsAPI->SetViewports(&viewport, 1);
+        m_graphicsAPI->SetScissors(&scissor, 1);
+
+        m_graphicsAPI->SetPipeline(pipeline);
+        m_graphicsAPI->SetVertexBuffers(&m_vertexBuffer, 1);
+        m_graphicsAPI->SetIndexBuffer(m_indexBuffer);
+        m_graphicsAPI->SetDescriptor({1, m_viewUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, view * uniformStride, sizeof(ViewUniforms)});
+        for (uint32_t i = 0; i < m_createInfo.drawCount; i++) {
+            UpdateDrawUniforms(settings.bufferUpdateStrategy, i, frameIndex);
+            m_graphicsAPI->UpdateDescriptors();
+            m_graphicsAPI->DrawIndexed(m_indexCount);
+        }
+    }
+    m_graphicsAPI->EndRendering();
+}
+
+void AutoTuner::UpdateDrawUniforms(BufferUpdateStrategy strategy, uint32_t drawIndex, uint32_t frameIndex) {
+    uint8_t *uniforms = m_drawUniforms.data() + drawIndex * uniformStride;
+    switch (strategy) {
+    case BufferUpdateStrategy::SET_DATA: {
+        m_graphicsAPI->SetBufferData(m_drawUniformBuffer, 0, sizeof(DrawUniforms), uniforms);
+        m_graphicsAPI->SetDescriptor({0, m_drawUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, 0, sizeof(DrawUniforms)});
+        break;
+    }
+    case BufferUpdateStrategy::MAP: {
+        void *data = m_graphicsAPI->MapBuffer(m_drawUniformBuffer);
+        if (data) {
+            memcpy(data, uniforms, sizeof(DrawUniforms));
+        }
+        m_graphicsAPI->UnmapBuffer(m_drawUniformBuffer);
+        m_graphicsAPI->SetDescriptor({0, m_drawUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, 0, sizeof(DrawUniforms)});
+        break;
+    }
+    case BufferUpdateStrategy::RING: {
+        // Written once per frame in RenderFrame().
+        const size_t offset = (frameIndex % ringFrameCount) * m_drawUniforms.size() + drawIndex * uniformStride;
+        m_graphicsAPI->SetDescriptor({0, m_drawUniformRingBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, offset, sizeof(DrawUniforms)});
+        break;
+    }
+    }
+}
+
+std::string AutoTuner::GetDeviceKey(GraphicsAPI *graphicsAPI, const std::string &systemName) {
+    return graphicsAPI->GetDeviceName() + " | " + systemName;
+}
+
+// The file has a section per device: A line with the device key in square brackets, followed by "name value" lines.
+bool AutoTuner::LoadSettings(const std::string &path, const std::string &deviceKey, Settings &settings) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::string section = "[" + deviceKey + "]";
+    bool inSection = false;
+    bool found = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[0] == '[') {
+            inSection = line == section;
+            found |= inSection;
+            continue;
+        }
+        if (!inSection) {
+            continue;
+        }
+        std::stringstream stream(line);
+        std::string name;
+        std::string value;
+        stream >> name >> value;
+        if (name == "resolutionScale") {
+            settings.resolutionScale = strtof(value.c_str(), nullptr);
+        } else if (name == "msaaSampleCount") {
+            settings.msaaSampleCount = (uint32_t)strtoul(value.c_str(), nullptr, 10);
+        } else if (name == "multiview") {
+            settings.multiview = value == "1";
+        } else if (name == "bufferUpdateStrategy") {
+            for (BufferUpdateStrategy strategy : {BufferUpdateStrategy::SET_DATA, BufferUpdateStrategy::MAP, BufferUpdateStrategy::RING}) {
+                if (value == ToString(strategy)) {
+                    settings.bufferUpdateStrategy = strategy;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+bool AutoTuner::SaveSettings(const std::string &path, const std::string &deviceKey, const Settings &settings) {
+    // Keep the sections of the other devices.
+    std::stringstream others;
+    {
+        std::ifstream file(path);
+        const std::string section = "[" + deviceKey + "]";
+        bool inSection = false;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line[0] == '[') {
+                inSection = line == section;
+            }
+            if (!inSection && !line.empty()) {
+                others << line << "\n";
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cout << "ERROR: AutoTuner: Failed to create " << path << "." << std::endl;
+        return false;
+    }
+    file << others.str();
+    file << "[" << deviceKey << "]\n";
+    file << "resolutionScale " << settings.resolutionScale << "\n";
+    file << "msaaSampleCount " << settings.msaaSampleCount << "\n";
+    file << "multiview " << (settings.multiview ? 1 : 0) << "\n";
+    file << "bufferUpdateStrategy " << ToString(settings.bufferUpdateStrategy) << "\n";
+    return file.good();
+}
+
+const char *AutoTuner::ToString(BufferUpdateStrategy strategy) {
+    switch (strategy) {
+    case BufferUpdateStrategy::SET_DATA:
+        return "SET_DATA";
+    case BufferUpdateStrategy::MAP:
+        return "MAP";
+    case BufferUpdateStrategy::RING:
+        return "RING";
+    }
+    return "";
+}
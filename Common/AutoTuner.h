@@ -0,0 +1,112 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+
+// Startup auto-tuning: Times short synthetic workloads through the GraphicsAPI on the device that renders the
+// application, and chooses the rendering settings for it. The settings are stored in a text file, keyed by the GPU and
+// driver and by the XR system, so that the probe only runs on the first start on a device, and again after a driver
+// update. Delete the device's entry from the file to tune again.
+//
+// The synthetic frame renders each view with drawCount overlapping quads with gridSize x gridSize cells, each with its
+// own uniform data, depth testing and an arithmetic heavy fragment shader, as a stand-in for the application's scene. A
+// candidate's time is the wall clock time per frame over measureFrames frames after warmupFrames, up to the GPU
+// completing them, which is bound by the slower of the CPU and the GPU. The settings are tuned in this order:
+//  1. Resolution scale: The largest scale at which the frame fits into frameBudgetMs, without MSAA.
+//  2. MSAA: The largest sample count at which the frame still fits, at that scale.
+//  3. Multiview or one pass per view: The faster one. Multiview is only a candidate without MSAA, as OVR_multiview
+//     renders into single sampled array images, and for two views of the same size.
+//  4. Buffer update strategy: The fastest way to update the uniforms of each draw.
+class AutoTuner {
+public:
+    enum class BufferUpdateStrategy : uint8_t {
+        SET_DATA,  // SetBufferData() into a single uniform block, per draw.
+        MAP,       // MapBuffer() of a single uniform block, discarding its contents, per draw.
+        RING,      // One SetBufferData() of all uniform blocks of the frame into a ring of regions, bound by offset.
+    };
+
+    struct Settings {
+        float resolutionScale = 1.0f;
+        uint32_t msaaSampleCount = 1;
+        bool multiview = false;
+        BufferUpdateStrategy bufferUpdateStrategy = BufferUpdateStrategy::RING;
+    };
+
+    struct ViewSize {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct CreateInfo {
+        // The resolution of each view at a resolution scale of 1.
+        std::vector<ViewSize> viewSizes;
+        // API specific formats of the render targets.
+        int64_t colorFormat;
+        int64_t depthFormat;
+        // The display period, e.g. XrFrameState::predictedDisplayPeriod.
+        float frameBudgetMs;
+        // Candidates, from the highest to the lowest quality.
+        std::vector<float> resolutionScales = {1.0f, 0.9f, 0.8f, 0.7f, 0.6f};
+        std::vector<uint32_t> msaaSampleCounts = {4, 2};
+        uint32_t drawCount = 200;
+        uint32_t gridSize = 8;
+        uint32_t warmupFrames = 5;
+        uint32_t measureFrames = 20;
+    };
+
+    AutoTuner(GraphicsAPI* graphicsAPI, const CreateInfo& createInfo);
+    ~AutoTuner();
+
+    // Measures the candidates and returns the chosen settings. Each measurement is printed.
+    Settings Tune();
+
+    // The time per frame of the synthetic workload with the settings, in milliseconds.
+    float MeasureFrameMs(const Settings& settings);
+
+    // The key of the settings of the device that graphicsAPI renders with, on the XR system with the systemName of its
+    // XrSystemProperties.
+    static std::string GetDeviceKey(GraphicsAPI* graphicsAPI, const std::string& systemName);
+
+    // Returns false if the file has no settings for the device key.
+    static bool LoadSettings(const std::string& path, const std::string& deviceKey, Settings& settings);
+    // Replaces the settings for the device key, and keeps those of other devices.
+    static bool SaveSettings(const std::string& path, const std::string& deviceKey, const Settings& settings);
+
+    static const char* ToString(BufferUpdateStrategy strategy);
+
+private:
+    // Matches the std140 uniform blocks in the shaders.
+    struct DrawUniforms {
+        float rect[4];   // The offset and size of the quad in normalized device coordinates.
+        float depth[4];  // The depth, and the color.
+    };
+    struct ViewUniforms {
+        float shifts[4];  // The horizontal shift of both eyes, and the eye of the view for one pass per view.
+    };
+    static constexpr size_t uniformStride = 256;
+    static constexpr uint32_t ringFrameCount = 3;
+
+    // Renders one pass per render target, at its size in viewSizes. A multiview render target holds all views.
+    void RenderFrame(const Settings& settings, void* pipeline, void** colorImageViews, void** depthImageViews, const std::vector<ViewSize>& viewSizes, uint32_t frameIndex);
+    void UpdateDrawUniforms(BufferUpdateStrategy strategy, uint32_t drawIndex, uint32_t frameIndex);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    CreateInfo m_createInfo;
+
+    void* m_vertexShader = nullptr;
+    void* m_multiviewVertexShader = nullptr;
+    void* m_fragmentShader = nullptr;
+    void* m_vertexBuffer = nullptr;
+    void* m_indexBuffer = nullptr;
+    uint32_t m_indexCount = 0;
+
+    // Tightly strided by uniformStride, in draw order.
+    std::vector<uint8_t> m_drawUniforms;
+    void* m_drawUniformBuffer = nullptr;
+    void* m_drawUniformRingBuffer = nullptr;
+    void* m_viewUniformBuffer = nullptr;
+};
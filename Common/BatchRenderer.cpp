@@ -0,0 +1,242 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <BatchRenderer.h>
+
+#include <chrono>
+#include <iomanip>
+
+BatchRenderer::BatchRenderer(GraphicsAPI *graphicsAPI, const CreateInfo &createInfo, DrawFunction draw, ImageFunction image)
+    : m_graphicsAPI(graphicsAPI), m_createInfo(createInfo), m_draw(std::move(draw)), m_image(std::move(image)) {
+    if (m_createInfo.width == 0 || m_createInfo.height == 0 || m_createInfo.viewsPerBatch == 0 || m_createInfo.readbackCount == 0) {
+        std::cout << "ERROR: BatchRenderer: width, height, viewsPerBatch and readbackCount must not be 0." << std::endl;
+        return;
+    }
+    m_imageBytes = (size_t)m_createInfo.width * m_createInfo.height * 4;
+
+    // Array images with a render target view per layer. A single layer is a 2D image.
+    const uint32_t layers = m_createInfo.viewsPerBatch;
+    const GraphicsAPI::ImageViewCreateInfo::View viewType = layers > 1 ? GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D_ARRAY : GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D;
+    m_colorImage = m_graphicsAPI->CreateImage({2, m_createInfo.width, m_createInfo.height, 1, 1, layers, 1, m_createInfo.colorFormat, false, true, false, false});
+    m_depthImage = m_graphicsAPI->CreateImage({2, m_createInfo.width, m_createInfo.height, 1, 1, layers, 1, m_createInfo.depthFormat, false, false, true, false});
+    for (uint32_t layer = 0; layer < layers; layer++) {
+        m_colorImageViews.push_back(m_graphicsAPI->CreateImageView({m_colorImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, viewType, m_createInfo.colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, layer, 1}));
+        m_depthImageViews.push_back(m_graphicsAPI->CreateImageView({m_depthImage, GraphicsAPI::ImageViewCreateInfo::Type::DSV, viewType, m_createInfo.depthFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::DEPTH_BIT, 0, 1, layer, 1}));
+    }
+
+    m_readbacks.resize(m_createInfo.readbackCount);
+    for (Readback &readback : m_readbacks) {
+        readback.buffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::READBACK, 0, m_imageBytes * layers, nullptr});
+    }
+
+    if (!m_createInfo.outputDirectory.empty() || m_image) {
+        m_writerJobs = std::make_unique<JobSystem>(std::max(m_createInfo.writerThreadCount, 1u));
+    }
+}
+
+BatchRenderer::~BatchRenderer() {
+    // Finish the queued writes, which read from memory owned by their jobs only.
+    m_writerJobs.reset();
+
+    for (Readback &readback : m_readbacks) {
+        if (readback.fence) {
+            m_graphicsAPI->DestroyFence(readback.fence);
+        }
+        if (readback.buffer) {
+            m_graphicsAPI->DestroyBuffer(readback.buffer);
+        }
+    }
+    for (void *&imageView : m_colorImageViews) {
+        m_graphicsAPI->DestroyImageView(imageView);
+    }
+    for (void *&imageView : m_depthImageViews) {
+        m_graphicsAPI->DestroyImageView(imageView);
+    }
+    if (m_colorImage) {
+        m_graphicsAPI->DestroyImage(m_colorImage);
+    }
+    if (m_depthImage) {
+        m_graphicsAPI->DestroyImage(m_depthImage);
+    }
+}
+
+void BatchRenderer::Render(const std::vector<XrView> &views) {
+    if (!IsValid()) {
+        return;
+    }
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    for (size_t firstView = 0; firstView < views.size(); firstView += m_createInfo.viewsPerBatch) {
+        // Reuse the oldest readback buffer. Consume any other completed readbacks on the way without waiting.
+        Readback &readback = m_readbacks[m_nextReadback];
+        if (readback.fence && !CompleteReadback(readback, 0)) {
+            m_statistics.readbackWaits++;
+            CompleteReadback(readback, ~0ull);
+        }
+        for (Readback &other : m_readbacks) {
+            if (other.fence) {
+                CompleteReadback(other, 0);
+            }
+        }
+
+        const uint32_t viewCount = (uint32_t)std::min<size_t>(m_createInfo.viewsPerBatch, views.size() - firstView);
+        SubmitBatch(views.data() + firstView, viewCount, firstView);
+    }
+
+    // Drain the readbacks in submission order, then the writer threads.
+    for (uint32_t i = 0; i < m_createInfo.readbackCount; i++) {
+        Readback &readback = m_readbacks[(m_nextReadback + i) % m_createInfo.readbackCount];
+        if (readback.fence) {
+            CompleteReadback(readback, ~0ull);
+        }
+    }
+    if (m_writerJobs) {
+        m_writerJobs->Wait();
+    }
+
+    m_statistics.seconds += std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count();
+    m_statistics.imagesPerSecond = m_statistics.seconds > 0.0f ? (float)m_statistics.imagesRendered / m_statistics.seconds : 0.0f;
+}
+
+void BatchRenderer::SubmitBatch(const XrView *views, uint32_t viewCount, uint64_t firstView) {
+    m_graphicsAPI->BeginRendering();
+    for (uint32_t i = 0; i < viewCount; i++) {
+        XrMatrix4x4f projection;
+        XrMatrix4x4f_CreateProjectionFov(&projection, OPENGL, views[i].fov, m_createInfo.nearZ, m_createInfo.farZ);
+        XrMatrix4x4f toView;
+        XrMatrix4x4f_CreateFromRigidTransform(&toView, &views[i].pose);
+        XrMatrix4x4f viewMatrix;
+        XrMatrix4x4f_InvertRigidBody(&viewMatrix, &toView);
+        XrMatrix4x4f viewProjection;
+        XrMatrix4x4f_Multiply(&viewProjection, &projection, &viewMatrix);
+
+        m_graphicsAPI->ClearColor(m_colorImageViews[i], 0.17f, 0.17f, 0.17f, 1.00f);
+        m_graphicsAPI->ClearDepth(m_depthImageViews[i], 1.0f);
+        if (m_draw) {
+            m_draw(views[i], viewProjection, m_colorImageViews[i], m_depthImageViews[i], m_createInfo.width, m_createInfo.height);
+        }
+    }
+    m_graphicsAPI->EndRendering();
+
+    // All layers of the batch in one copy.
+    Readback &readback = m_readbacks[m_nextReadback];
+    GraphicsAPI::BufferImageCopy region{};
+    region.imageSubresource = {0, 0, viewCount};
+    region.imageExtent = {m_createInfo.width, m_createInfo.height, 1};
+    m_graphicsAPI->CopyImageToBuffer(m_colorImage, readback.buffer, region);
+    readback.fence = m_graphicsAPI->CreateFence();
+    readback.firstView = firstView;
+    readback.viewCount = viewCount;
+    m_nextReadback = (m_nextReadback + 1) % m_createInfo.readbackCount;
+
+    m_statistics.imagesRendered += viewCount;
+    m_statistics.batches++;
+}
+
+bool BatchRenderer::CompleteReadback(Readback &readback, uint64_t timeout) {
+    if (!m_graphicsAPI->WaitForFence(readback.fence, timeout)) {
+        return false;
+    }
+    m_graphicsAPI->DestroyFence(readback.fence);
+
+    if (m_writerJobs) {
+        // Bound the memory held by the writer threads.
+        {
+            std::unique_lock<std::mutex> lock(m_writerMutex);
+            if (m_pendingWrites >= m_createInfo.maxPendingWrites) {
+                m_statistics.writerWaits++;
+                m_writeFinished.wait(lock, [this]() { return m_pendingWrites < m_createInfo.maxPendingWrites; });
+            }
+            m_pendingWrites++;
+        }
+
+        // Copy out of the mapped buffer, so that it can be unmapped and reused right away.
+        std::shared_ptr<std::vector<uint8_t>> pixels = std::make_shared<std::vector<uint8_t>>(m_imageBytes * readback.viewCount);
+        const uint8_t *data = (const uint8_t *)m_graphicsAPI->MapBuffer(readback.buffer);
+        if (data) {
+            memcpy(pixels->data(), data, pixels->size());
+        }
+        m_graphicsAPI->UnmapBuffer(readback.buffer);
+
+        const uint64_t firstView = readback.firstView;
+        const uint32_t viewCount = data ? readback.viewCount : 0;
+        m_writerJobs->Submit([this, pixels, firstView, viewCount]() {
+            uint32_t written = 0;
+            for (uint32_t i = 0; i < viewCount; i++) {
+                if (m_image) {
+                    m_image(firstView + i, pixels->data() + m_imageBytes * i);
+                    continue;
+                }
+                std::stringstream path;
+                path << m_createInfo.outputDirectory << "/image_" << std::setw(6) << std::setfill('0') << firstView + i << ".ppm";
+                if (WritePPM(path.str(), pixels->data() + m_imageBytes * i, m_createInfo.width, m_createInfo.height)) {
+                    written++;
+                }
+            }
+            {
+                std::unique_lock<std::mutex> lock(m_writerMutex);
+                m_pendingWrites--;
+                m_statistics.imagesWritten += written;
+                m_statistics.bytesWritten += (uint64_t)written * m_createInfo.width * m_createInfo.height * 3;
+            }
+            m_writeFinished.notify_all();
+        });
+    }
+    return true;
+}
+
+bool BatchRenderer::ReadPoseList(const std::string &path, std::vector<XrView> &views) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cout << "ERROR: BatchRenderer: Failed to open " << path << "." << std::endl;
+        return false;
+    }
+
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        XrView view{XR_TYPE_VIEW};
+        std::stringstream stream(line);
+        stream >> view.pose.position.x >> view.pose.position.y >> view.pose.position.z;
+        stream >> view.pose.orientation.x >> view.pose.orientation.y >> view.pose.orientation.z >> view.pose.orientation.w;
+        stream >> view.fov.angleLeft >> view.fov.angleRight >> view.fov.angleUp >> view.fov.angleDown;
+        if (stream.fail()) {
+            std::cout << "ERROR: BatchRenderer: " << path << ":" << lineNumber << ": Expected 11 numbers." << std::endl;
+            return false;
+        }
+        XrQuaternionf_Normalize(&view.pose.orientation);
+        views.push_back(view);
+    }
+    return true;
+}
+
+bool BatchRenderer::WritePPM(const std::string &path, const uint8_t *rgba8, uint32_t width, uint32_t height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "ERROR: BatchRenderer: Failed to create " << path << "." << std::endl;
+        return false;
+    }
+    file << "P6\n"
+         << width << " " << height << "\n255\n";
+
+    // PPM stores the top row first.
+    std::vector<uint8_t> row((size_t)width * 3);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *src = rgba8 + (size_t)(height - 1 - y) * width * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        file.write((const char *)row.data(), (std::streamsize)row.size());
+    }
+    return file.good();
+}
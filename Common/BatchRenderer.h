@@ -0,0 +1,110 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+#include <JobSystem.h>
+#include <xr_linear_algebra.h>
+
+// Offline rendering of a list of views, e.g. for synthetic image generation, without OpenXR. Use a GraphicsAPI that was
+// created without an XrInstance.
+//
+// The views are rendered in batches of viewsPerBatch into the layers of array images, one submission per batch. Each
+// batch is copied into one of readbackCount readback buffers, which are mapped once their fence has signaled, so the GPU
+// keeps rendering the next batches while earlier ones are read back. The mapped images are handed to writer threads,
+// which write them to outputDirectory as binary PPM files, named by the index of the view in the list, or pass them to
+// an ImageFunction.
+class BatchRenderer {
+public:
+    struct CreateInfo {
+        uint32_t width = 512;
+        uint32_t height = 512;
+        // An API specific four channel, eight bits per channel format, e.g. GL_RGBA8, and a depth format.
+        int64_t colorFormat;
+        int64_t depthFormat;
+        float nearZ = 0.05f;
+        float farZ = 100.0f;
+        // The number of views rendered per submission, which is the number of layers of the array images.
+        uint32_t viewsPerBatch = 16;
+        // The number of batches being read back at once.
+        uint32_t readbackCount = 3;
+        uint32_t writerThreadCount = 2;
+        // The number of batches queued on the writer threads before Render() waits for them.
+        uint32_t maxPendingWrites = 8;
+        // No images are written if empty, e.g. to measure the rendering and readback throughput alone, or with an
+        // ImageFunction.
+        std::string outputDirectory;
+    };
+
+    struct Statistics {
+        uint64_t imagesRendered;
+        uint64_t imagesWritten;
+        uint64_t batches;
+        uint64_t readbackWaits;  // Batches for which the CPU had to wait for the GPU to free a readback buffer.
+        uint64_t writerWaits;    // Batches for which the CPU had to wait for the writer threads.
+        uint64_t bytesWritten;
+        float seconds;
+        float imagesPerSecond;
+    };
+
+    // Draws the scene into the views' render targets, which are already cleared. viewProjection is the OpenGL style
+    // projection of the view's fov multiplied with the inverse of its pose.
+    typedef std::function<void(const XrView& view, const XrMatrix4x4f& viewProjection, void* colorImageView, void* depthImageView, uint32_t width, uint32_t height)> DrawFunction;
+
+    // Receives the tightly packed RGBA8 image of a view, bottom row first, on a writer thread, instead of writing it to
+    // a file. viewIndex is the index of the view in the list passed to Render().
+    typedef std::function<void(uint64_t viewIndex, const uint8_t* rgba8)> ImageFunction;
+
+    BatchRenderer(GraphicsAPI* graphicsAPI, const CreateInfo& createInfo, DrawFunction draw, ImageFunction image = nullptr);
+    ~BatchRenderer();
+
+    bool IsValid() const { return m_colorImage != nullptr; }
+
+    // Renders all views and returns once their images have been written.
+    void Render(const std::vector<XrView>& views);
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+    // Reads a pose list with one view per line: position x y z, orientation x y z w, and the fov angles left right up
+    // down in radians, separated by white space. Empty lines and lines starting with # are skipped.
+    static bool ReadPoseList(const std::string& path, std::vector<XrView>& views);
+
+    // Writes tightly packed RGBA8 rows, bottom row first as read back from OpenGL, as a binary PPM file.
+    static bool WritePPM(const std::string& path, const uint8_t* rgba8, uint32_t width, uint32_t height);
+
+private:
+    struct Readback {
+        void* buffer = nullptr;
+        void* fence = nullptr;  // nullptr when the buffer is free.
+        uint64_t firstView = 0;
+        uint32_t viewCount = 0;
+    };
+
+    void SubmitBatch(const XrView* views, uint32_t viewCount, uint64_t firstView);
+    // Maps a completed readback and queues its images on the writer threads. Returns false if the fence has not
+    // signaled within timeout nanoseconds.
+    bool CompleteReadback(Readback& readback, uint64_t timeout);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    CreateInfo m_createInfo;
+    DrawFunction m_draw;
+    ImageFunction m_image;
+    Statistics m_statistics{};
+    size_t m_imageBytes = 0;
+
+    void* m_colorImage = nullptr;
+    void* m_depthImage = nullptr;
+    std::vector<void*> m_colorImageViews;  // Per layer.
+    std::vector<void*> m_depthImageViews;  // Per layer.
+
+    std::vector<Readback> m_readbacks;
+    uint32_t m_nextReadback = 0;
+
+    std::unique_ptr<JobSystem> m_writerJobs = nullptr;
+    std::mutex m_writerMutex;
+    std::condition_variable m_writeFinished;
+    uint32_t m_pendingWrites = 0;
+};
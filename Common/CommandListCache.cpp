@@ -0,0 +1,158 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <CommandListCache.h>
+
+CommandListCache::CommandListCache(GraphicsAPI *graphicsAPI)
+    : m_graphicsAPI(graphicsAPI) {
+}
+
+CommandListCache::~CommandListCache() {
+    for (CommandList &commandList : m_commandLists) {
+        if (commandList.argumentBuffer) {
+            m_graphicsAPI->DestroyBuffer(commandList.argumentBuffer);
+        }
+    }
+}
+
+CommandListCache::DrawHandle CommandListCache::AddDraw(uint32_t pass, const State &state, const GraphicsAPI::DrawIndexedIndirectCommand &command) {
+    // Find the pass' command list with the same state, or create one.
+    std::vector<uint32_t> &passCommandLists = m_passCommandLists[pass];
+    uint32_t commandListIndex = static_cast<uint32_t>(m_commandLists.size());
+    for (uint32_t index : passCommandLists) {
+        if (IsSameState(m_commandLists[index].state, state)) {
+            commandListIndex = index;
+            break;
+        }
+    }
+    if (commandListIndex == m_commandLists.size()) {
+        m_commandLists.push_back({pass, state, {}, nullptr, 0, 0, true});
+        passCommandLists.push_back(commandListIndex);
+        m_statistics.commandListCount++;
+    }
+
+    const DrawHandle drawHandle = m_nextDrawHandle++;
+    CommandList &commandList = m_commandLists[commandListIndex];
+    commandList.draws.push_back({drawHandle, command});
+    commandList.dirty = true;
+    m_drawCommandLists[drawHandle] = commandListIndex;
+    m_statistics.drawCount++;
+    return drawHandle;
+}
+
+void CommandListCache::UpdateDraw(DrawHandle drawHandle, const GraphicsAPI::DrawIndexedIndirectCommand &command) {
+    std::unordered_map<DrawHandle, uint32_t>::iterator it = m_drawCommandLists.find(drawHandle);
+    if (it == m_drawCommandLists.end()) {
+        std::cout << "ERROR: CommandListCache: Unknown DrawHandle." << std::endl;
+        return;
+    }
+    CommandList &commandList = m_commandLists[it->second];
+    for (Draw &draw : commandList.draws) {
+        if (draw.handle == drawHandle) {
+            draw.command = command;
+            commandList.dirty = true;
+            return;
+        }
+    }
+}
+
+void CommandListCache::RemoveDraw(DrawHandle drawHandle) {
+    std::unordered_map<DrawHandle, uint32_t>::iterator it = m_drawCommandLists.find(drawHandle);
+    if (it == m_drawCommandLists.end()) {
+        std::cout << "ERROR: CommandListCache: Unknown DrawHandle." << std::endl;
+        return;
+    }
+    CommandList &commandList = m_commandLists[it->second];
+    for (size_t i = 0; i < commandList.draws.size(); i++) {
+        if (commandList.draws[i].handle == drawHandle) {
+            // Draw order within a list is not preserved.
+            commandList.draws[i] = commandList.draws.back();
+            commandList.draws.pop_back();
+            commandList.dirty = true;
+            break;
+        }
+    }
+    m_drawCommandLists.erase(it);
+    m_statistics.drawCount--;
+}
+
+void CommandListCache::InvalidatePass(uint32_t pass) {
+    for (uint32_t index : m_passCommandLists[pass]) {
+        m_commandLists[index].dirty = true;
+    }
+}
+
+void CommandListCache::Execute(uint32_t pass, const std::vector<GraphicsAPI::DescriptorInfo> &viewDescriptors) {
+    std::unordered_map<uint32_t, std::vector<uint32_t>>::iterator it = m_passCommandLists.find(pass);
+    if (it == m_passCommandLists.end()) {
+        return;
+    }
+
+    for (uint32_t index : it->second) {
+        CommandList &commandList = m_commandLists[index];
+        if (commandList.dirty) {
+            Record(commandList);
+        }
+        if (commandList.recordedDrawCount == 0) {
+            continue;
+        }
+
+        const State &state = commandList.state;
+        m_graphicsAPI->SetPipeline(state.pipeline);
+        for (const GraphicsAPI::DescriptorInfo &descriptor : state.descriptors) {
+            m_graphicsAPI->SetDescriptor(descriptor);
+        }
+        for (const GraphicsAPI::DescriptorInfo &descriptor : viewDescriptors) {
+            m_graphicsAPI->SetDescriptor(descriptor);
+        }
+        m_graphicsAPI->UpdateDescriptors();
+        m_graphicsAPI->SetVertexBuffers(const_cast<void **>(state.vertexBuffers.data()), state.vertexBuffers.size());
+        m_graphicsAPI->SetIndexBuffer(state.indexBuffer);
+        m_graphicsAPI->DrawIndexedIndirect(commandList.argumentBuffer, 0, commandList.recordedDrawCount, sizeof(GraphicsAPI::DrawIndexedIndirectCommand));
+    }
+}
+
+bool CommandListCache::IsSameState(const State &a, const State &b) {
+    if (a.pipeline != b.pipeline || a.indexBuffer != b.indexBuffer || a.vertexBuffers != b.vertexBuffers || a.descriptors.size() != b.descriptors.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.descriptors.size(); i++) {
+        const GraphicsAPI::DescriptorInfo &descA = a.descriptors[i];
+        const GraphicsAPI::DescriptorInfo &descB = b.descriptors[i];
+        if (descA.bindingIndex != descB.bindingIndex || descA.resource != descB.resource || descA.type != descB.type || descA.bufferOffset != descB.bufferOffset || descA.bufferSize != descB.bufferSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CommandListCache::Record(CommandList &commandList) {
+    const uint32_t drawCount = static_cast<uint32_t>(commandList.draws.size());
+    if (drawCount > commandList.argumentCapacity) {
+        // Grow by powers of two, so that adding draws one at a time does not recreate the buffer every time.
+        uint32_t capacity = std::max(commandList.argumentCapacity, 16u);
+        while (capacity < drawCount) {
+            capacity *= 2;
+        }
+        if (commandList.argumentBuffer) {
+            m_graphicsAPI->DestroyBuffer(commandList.argumentBuffer);
+        }
+        commandList.argumentBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::INDIRECT, sizeof(GraphicsAPI::DrawIndexedIndirectCommand), sizeof(GraphicsAPI::DrawIndexedIndirectCommand) * capacity, nullptr});
+        commandList.argumentCapacity = capacity;
+    }
+
+    std::vector<GraphicsAPI::DrawIndexedIndirectCommand> commands;
+    commands.reserve(drawCount);
+    for (const Draw &draw : commandList.draws) {
+        commands.push_back(draw.command);
+    }
+    if (drawCount > 0) {
+        m_graphicsAPI->SetBufferData(commandList.argumentBuffer, 0, sizeof(GraphicsAPI::DrawIndexedIndirectCommand) * drawCount, commands.data());
+    }
+    commandList.recordedDrawCount = drawCount;
+    commandList.dirty = false;
+    m_statistics.recordedLastFrame++;
+}
@@ -0,0 +1,77 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+
+// Retained rendering for static scene parts. Draws are grouped into cached command lists, keyed by pass and view
+// independent state: pipeline, vertex and index buffers and descriptors. Each list stores its draws as indirect draw
+// arguments in a GPU buffer, which is only re-recorded when a draw of the list was added, updated or removed, or when
+// the scene invalidates the pass.
+// Execute() replays each list with a single DrawIndexedIndirect(), after patching in the view dependent descriptors,
+// so the per frame CPU cost scales with the number of lists and the changes, not with the number of draws.
+class CommandListCache {
+public:
+    struct State {
+        void* pipeline;
+        std::vector<void*> vertexBuffers;
+        void* indexBuffer;
+        // View independent descriptors, e.g. materials, textures and per object storage buffers.
+        std::vector<GraphicsAPI::DescriptorInfo> descriptors;
+    };
+
+    typedef uint64_t DrawHandle;
+
+    struct Statistics {
+        uint32_t commandListCount;
+        uint32_t drawCount;
+        uint32_t recordedLastFrame;
+    };
+
+    CommandListCache(GraphicsAPI* graphicsAPI);
+    ~CommandListCache();
+
+    DrawHandle AddDraw(uint32_t pass, const State& state, const GraphicsAPI::DrawIndexedIndirectCommand& command);
+    void UpdateDraw(DrawHandle drawHandle, const GraphicsAPI::DrawIndexedIndirectCommand& command);
+    void RemoveDraw(DrawHandle drawHandle);
+
+    // Forces all command lists of the pass to be re-recorded, e.g. after the contents of a shared buffer were rebuilt.
+    void InvalidatePass(uint32_t pass);
+
+    // Replays the command lists of the pass into the current render attachments. viewDescriptors are set after each
+    // list's descriptors, e.g. the camera uniform buffer of the current view.
+    void Execute(uint32_t pass, const std::vector<GraphicsAPI::DescriptorInfo>& viewDescriptors);
+
+    // Resets the recorded count of the statistics. Call once per frame.
+    void BeginFrame() { m_statistics.recordedLastFrame = 0; }
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+private:
+    struct Draw {
+        DrawHandle handle;
+        GraphicsAPI::DrawIndexedIndirectCommand command;
+    };
+    struct CommandList {
+        uint32_t pass;
+        State state;
+        std::vector<Draw> draws;
+        void* argumentBuffer;
+        uint32_t argumentCapacity;
+        uint32_t recordedDrawCount;
+        bool dirty;
+    };
+
+    static bool IsSameState(const State& a, const State& b);
+    void Record(CommandList& commandList);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    // Lists are never erased, so that indices stay valid. Empty lists are skipped.
+    std::vector<CommandList> m_commandLists;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_passCommandLists;
+    std::unordered_map<DrawHandle, uint32_t> m_drawCommandLists;
+    DrawHandle m_nextDrawHandle = 1;
+    Statistics m_statistics{};
+};
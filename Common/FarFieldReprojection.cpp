@@ -0,0 +1,200 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <FarFieldReprojection.h>
+
+// GLSL 4.50 fragment shader.
+static const char *farFieldReprojectionShaderSource = R"(
+#version 450
+layout(location = 0) in vec2 i_TexCoord;
+layout(location = 0) out vec4 o_Color;
+
+layout(binding = 0) uniform sampler2D monoColor;
+layout(binding = 1) uniform sampler2D monoDepth;
+layout(std140, binding = 2) uniform ReprojectionUniforms {
+    mat4 viewInverseViewProjection;
+    mat4 monoViewProjection;
+    mat4 monoInverseViewProjection;
+    vec4 viewPosition;
+};
+
+vec2 MonoUV(vec3 position) {
+    vec4 clip = monoViewProjection * vec4(position, 1.0);
+    return (clip.xy / clip.w) * 0.5 + 0.5;
+}
+
+void main() {
+    // The view ray through this pixel, from the view position to the far plane.
+    vec4 farPoint = viewInverseViewProjection * vec4(i_TexCoord * 2.0 - 1.0, 1.0, 1.0);
+    vec3 rayEnd = farPoint.xyz / farPoint.w;
+    vec3 rayDirection = normalize(rayEnd - viewPosition.xyz);
+    float rayLength = distance(rayEnd, viewPosition.xyz);
+
+    // Assume the content is at the far plane, then move the sample point along the view ray to the depth found in the mono image.
+    vec2 uv = MonoUV(rayEnd);
+    for (int i = 0; i < 2; i++) {
+        float depth = textureLod(monoDepth, uv, 0.0).r;
+        if (depth >= 1.0) {
+            break;
+        }
+        vec4 monoPoint = monoInverseViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+        float t = dot(monoPoint.xyz / monoPoint.w - viewPosition.xyz, rayDirection);
+        uv = MonoUV(viewPosition.xyz + rayDirection * clamp(t, 0.0, rayLength));
+    }
+    o_Color = textureLod(monoColor, uv, 0.0);
+}
+)";
+
+FarFieldReprojection::FarFieldReprojection(GraphicsAPI *graphicsAPI, uint32_t width, uint32_t height, int64_t colorFormat, int64_t depthFormat, float farFieldDistance)
+    : m_graphicsAPI(graphicsAPI), m_width(width), m_height(height), m_farFieldDistance(farFieldDistance) {
+    m_colorImage = m_graphicsAPI->CreateImage({2, m_width, m_height, 1, 1, 1, 1, colorFormat, false, true, false, true});
+    m_colorImageView = m_graphicsAPI->CreateImageView({m_colorImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+    m_depthImage = m_graphicsAPI->CreateImage({2, m_width, m_height, 1, 1, 1, 1, depthFormat, false, false, true, true});
+    m_depthImageView = m_graphicsAPI->CreateImageView({m_depthImage, GraphicsAPI::ImageViewCreateInfo::Type::DSV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, depthFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::DEPTH_BIT, 0, 1, 0, 1});
+
+    GraphicsAPI::SamplerCreateInfo samplerCI{};
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.mipmapMode = GraphicsAPI::SamplerCreateInfo::MipmapMode::NOOP;
+    samplerCI.addressModeS = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeT = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeR = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.compareOp = GraphicsAPI::CompareOp::NEVER;
+    m_linearSampler = m_graphicsAPI->CreateSampler(samplerCI);
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    m_nearestSampler = m_graphicsAPI->CreateSampler(samplerCI);
+    m_uniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(ReprojectionUniforms), nullptr});
+
+    m_reprojectionPass = std::make_unique<FullscreenPass>(m_graphicsAPI, farFieldReprojectionShaderSource, std::vector<int64_t>{colorFormat},
+                                                          std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                   {1, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                   {2, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}});
+
+    XrQuaternionf_CreateIdentity(&m_pose.orientation);
+    XrMatrix4x4f_CreateIdentity(&m_viewProjection);
+    XrMatrix4x4f_CreateIdentity(&m_inverseViewProjection);
+}
+
+FarFieldReprojection::~FarFieldReprojection() {
+    m_reprojectionPass.reset();
+    m_graphicsAPI->DestroyBuffer(m_uniformBuffer);
+    m_graphicsAPI->DestroySampler(m_nearestSampler);
+    m_graphicsAPI->DestroySampler(m_linearSampler);
+    m_graphicsAPI->DestroyImageView(m_depthImageView);
+    m_graphicsAPI->DestroyImage(m_depthImage);
+    m_graphicsAPI->DestroyImageView(m_colorImageView);
+    m_graphicsAPI->DestroyImage(m_colorImage);
+}
+
+void FarFieldReprojection::SetViews(const XrView *views, uint32_t viewCount, float farZ) {
+    if (viewCount == 0) {
+        return;
+    }
+    m_farZ = farZ;
+
+    // The central pose: The average of the view positions and orientations.
+    XrVector3f position = {0.0f, 0.0f, 0.0f};
+    XrQuaternionf orientation = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint32_t i = 0; i < viewCount; i++) {
+        XrVector3f_Add(&position, &position, &views[i].pose.position);
+        XrQuaternionf q = views[i].pose.orientation;
+        const float sign = (q.x * views[0].pose.orientation.x + q.y * views[0].pose.orientation.y + q.z * views[0].pose.orientation.z + q.w * views[0].pose.orientation.w) < 0.0f ? -1.0f : 1.0f;
+        orientation = {orientation.x + sign * q.x, orientation.y + sign * q.y, orientation.z + sign * q.z, orientation.w + sign * q.w};
+    }
+    XrVector3f_Scale(&position, &position, 1.0f / (float)viewCount);
+    XrQuaternionf_Normalize(&orientation);
+    m_pose = {orientation, position};
+
+    // The field of view covering the frustum corners of all views, in the central pose's space.
+    XrQuaternionf inverseOrientation;
+    XrQuaternionf_Invert(&inverseOrientation, &orientation);
+    float maxOffset = 0.0f;
+    XrFovf fov = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint32_t i = 0; i < viewCount; i++) {
+        const XrFovf &viewFov = views[i].fov;
+        const float cornerAngles[4][2] = {{viewFov.angleLeft, viewFov.angleDown}, {viewFov.angleRight, viewFov.angleDown}, {viewFov.angleLeft, viewFov.angleUp}, {viewFov.angleRight, viewFov.angleUp}};
+        for (const float(&cornerAngle)[2] : cornerAngles) {
+            XrVector3f direction = {tanf(cornerAngle[0]), tanf(cornerAngle[1]), -1.0f};
+            XrQuaternionf_RotateVector3f(&direction, &views[i].pose.orientation, &direction);
+            XrQuaternionf_RotateVector3f(&direction, &inverseOrientation, &direction);
+            const float angleX = atan2f(direction.x, -direction.z);
+            const float angleY = atan2f(direction.y, -direction.z);
+            fov.angleLeft = std::min(fov.angleLeft, angleX);
+            fov.angleRight = std::max(fov.angleRight, angleX);
+            fov.angleDown = std::min(fov.angleDown, angleY);
+            fov.angleUp = std::max(fov.angleUp, angleY);
+        }
+        XrVector3f offset;
+        XrVector3f_Sub(&offset, &views[i].pose.position, &position);
+        maxOffset = std::max(maxOffset, XrVector3f_Length(&offset));
+    }
+
+    // Widen by the largest parallax of far field content, so that the reprojection never samples outside the image.
+    const float parallax = atanf(maxOffset / m_farFieldDistance);
+    const float maxAngle = 1.5f;  // Keep the tangents finite.
+    fov.angleLeft = std::max(fov.angleLeft - parallax, -maxAngle);
+    fov.angleRight = std::min(fov.angleRight + parallax, maxAngle);
+    fov.angleDown = std::max(fov.angleDown - parallax, -maxAngle);
+    fov.angleUp = std::min(fov.angleUp + parallax, maxAngle);
+
+    // The near plane is pulled in to half the far field distance, as objects are classified by their bounding spheres only.
+    CreateViewProjection(m_viewProjection, m_pose, fov, m_farFieldDistance * 0.5f, m_farZ);
+    XrMatrix4x4f_Invert(&m_inverseViewProjection, &m_viewProjection);
+}
+
+bool FarFieldReprojection::IsFarField(const XrVector3f &center, float radius) const {
+    XrVector3f offset;
+    XrVector3f_Sub(&offset, &center, &m_pose.position);
+    return XrVector3f_Length(&offset) - radius >= m_farFieldDistance;
+}
+
+void FarFieldReprojection::BeginMonoPass(float r, float g, float b, float a) {
+    m_graphicsAPI->ClearColor(m_colorImageView, r, g, b, a);
+    m_graphicsAPI->ClearDepth(m_depthImageView, 1.0f);
+    m_graphicsAPI->SetRenderAttachments(&m_colorImageView, 1, m_depthImageView, m_width, m_height, nullptr);
+
+    GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)m_width, (float)m_height, 0.0f, 1.0f};
+    GraphicsAPI::Rect2D scissor = {{0, 0}, {m_width, m_height}};
+    m_graphicsAPI->SetViewports(&viewport, 1);
+    m_graphicsAPI->SetScissors(&scissor, 1);
+}
+
+void FarFieldReprojection::Reproject(void *colorImageView, uint32_t width, uint32_t height, const XrView &view) {
+    ReprojectionUniforms uniforms{};
+    XrMatrix4x4f viewProjection;
+    CreateViewProjection(viewProjection, view.pose, view.fov, m_farFieldDistance * 0.5f, m_farZ);
+    XrMatrix4x4f_Invert(&uniforms.viewInverseViewProjection, &viewProjection);
+    uniforms.monoViewProjection = m_viewProjection;
+    uniforms.monoInverseViewProjection = m_inverseViewProjection;
+    uniforms.viewPosition = {view.pose.position.x, view.pose.position.y, view.pose.position.z, 1.0f};
+    m_graphicsAPI->SetBufferData(m_uniformBuffer, 0, sizeof(ReprojectionUniforms), &uniforms);
+
+    m_graphicsAPI->SetRenderAttachments(&colorImageView, 1, nullptr, width, height, m_reprojectionPass->GetPipeline());
+    GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f};
+    GraphicsAPI::Rect2D scissor = {{0, 0}, {width, height}};
+    m_graphicsAPI->SetViewports(&viewport, 1);
+    m_graphicsAPI->SetScissors(&scissor, 1);
+
+    m_graphicsAPI->SetPipeline(m_reprojectionPass->GetPipeline());
+    m_graphicsAPI->SetDescriptor({0, m_colorImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({0, m_linearSampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({1, m_depthImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({1, m_nearestSampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({2, m_uniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT, false, 0, sizeof(ReprojectionUniforms)});
+    m_graphicsAPI->UpdateDescriptors();
+    m_reprojectionPass->Draw();
+}
+
+void FarFieldReprojection::CreateViewProjection(XrMatrix4x4f &result, const XrPosef &pose, const XrFovf &fov, float nearZ, float farZ) {
+    XrMatrix4x4f projection;
+    XrMatrix4x4f_CreateProjectionFov(&projection, OPENGL, fov, nearZ, farZ);
+    XrMatrix4x4f toView;
+    XrMatrix4x4f_CreateFromRigidTransform(&toView, &pose);
+    XrMatrix4x4f view;
+    XrMatrix4x4f_InvertRigidBody(&view, &toView);
+    XrMatrix4x4f_Multiply(&result, &projection, &view);
+}
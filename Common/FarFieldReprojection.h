@@ -0,0 +1,64 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <FullscreenPass.h>
+#include <xr_linear_algebra.h>
+
+// Far field rendering: Beyond a few tens of meters the disparity between the eyes is below a pixel, so content beyond
+// farFieldDistance is rendered once, from a central pose with a field of view covering all views, into a mono
+// background target. Reproject() then warps the background into each view, using the mono depth to correct the
+// remaining parallax, before the near content is rendered per view.
+class FarFieldReprojection {
+public:
+    FarFieldReprojection(GraphicsAPI* graphicsAPI, uint32_t width, uint32_t height, int64_t colorFormat, int64_t depthFormat, float farFieldDistance);
+    ~FarFieldReprojection();
+
+    // Computes the central pose and field of view for this frame from the located views.
+    void SetViews(const XrView* views, uint32_t viewCount, float farZ);
+
+    // Objects whose bounding sphere lies entirely beyond the far field distance from the central pose.
+    // Draw these in the mono pass only, and all others per view.
+    bool IsFarField(const XrVector3f& center, float radius) const;
+
+    // Sets and clears the mono render attachments. Draw the far field content with GetViewProjection() afterwards.
+    void BeginMonoPass(float r, float g, float b, float a);
+
+    // Overwrites a view's color image with the reprojected background. Call before rendering the view's near content.
+    void Reproject(void* colorImageView, uint32_t width, uint32_t height, const XrView& view);
+
+    float GetFarFieldDistance() const { return m_farFieldDistance; }
+    const XrMatrix4x4f& GetViewProjection() const { return m_viewProjection; }
+
+private:
+    struct ReprojectionUniforms {
+        XrMatrix4x4f viewInverseViewProjection;
+        XrMatrix4x4f monoViewProjection;
+        XrMatrix4x4f monoInverseViewProjection;
+        XrVector4f viewPosition;
+    };
+
+    static void CreateViewProjection(XrMatrix4x4f& result, const XrPosef& pose, const XrFovf& fov, float nearZ, float farZ);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    float m_farFieldDistance = 0.0f;
+    float m_farZ = 100.0f;
+
+    XrPosef m_pose{};
+    XrMatrix4x4f m_viewProjection{};
+    XrMatrix4x4f m_inverseViewProjection{};
+
+    void* m_colorImage = nullptr;
+    void* m_colorImageView = nullptr;
+    void* m_depthImage = nullptr;
+    void* m_depthImageView = nullptr;
+    void* m_linearSampler = nullptr;
+    void* m_nearestSampler = nullptr;
+    void* m_uniformBuffer = nullptr;
+    std::unique_ptr<FullscreenPass> m_reprojectionPass;
+};
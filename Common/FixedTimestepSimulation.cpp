@@ -0,0 +1,118 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <FixedTimestepSimulation.h>
+
+#include <chrono>
+
+FixedTimestepSimulation::FixedTimestepSimulation(float tickRate, TickFunction tick, JobSystem &jobSystem, uint32_t maxTicksPerFrame)
+    : m_tickRate(tickRate), m_tickDuration(static_cast<XrDuration>(1e9 / static_cast<double>(tickRate))), m_tick(std::move(tick)), m_jobSystem(jobSystem), m_maxTicksPerFrame(maxTicksPerFrame) {
+}
+
+FixedTimestepSimulation::~FixedTimestepSimulation() {
+    WaitForTick();
+}
+
+void FixedTimestepSimulation::SetState(const State &state) {
+    WaitForTick();
+    m_previous = state;
+    m_current = state;
+    m_interpolated = state;
+}
+
+void FixedTimestepSimulation::Update(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod) {
+    // Complete the tick that ran ahead, if any, before touching the states.
+    m_statistics.ticksLastFrame = 0;
+    WaitForTick();
+
+    if (!m_started || predictedDisplayTime < m_currentTime - m_tickDuration) {
+        // Start, or restart after the display time went backwards, with the current state at the display time.
+        m_previous = m_current;
+        m_currentTime = predictedDisplayTime;
+        m_started = true;
+    }
+
+    // Advance the current state to at or after the display time.
+    while (m_currentTime < predictedDisplayTime) {
+        if (m_statistics.ticksLastFrame == m_maxTicksPerFrame) {
+            const XrDuration behind = predictedDisplayTime - m_currentTime;
+            m_statistics.droppedTicks += static_cast<uint64_t>((behind + m_tickDuration - 1) / m_tickDuration);
+            m_previous = m_current;
+            m_currentTime = predictedDisplayTime;
+            break;
+        }
+        Tick();
+        m_statistics.ticksLastFrame++;
+    }
+
+    const float factor = 1.0f - static_cast<float>(static_cast<double>(m_currentTime - predictedDisplayTime) / static_cast<double>(m_tickDuration));
+    Interpolate(std::min(std::max(factor, 0.0f), 1.0f));
+
+    // Run the tick that the next frame needs ahead, on the job system.
+    if (m_currentTime < predictedDisplayTime + predictedDisplayPeriod) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_tickInFlight = true;
+        }
+        m_jobSystem.Submit([this]() {
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            m_tick(m_current, m_next, m_currentTime + m_tickDuration, 1.0f / m_tickRate);
+            const float tickMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_lastTickMs = tickMs;
+                m_tickInFlight = false;
+            }
+            m_tickFinished.notify_all();
+        });
+    }
+}
+
+void FixedTimestepSimulation::Tick() {
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    m_tick(m_current, m_next, m_currentTime + m_tickDuration, 1.0f / m_tickRate);
+    m_lastTickMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::swap(m_previous, m_current);
+    std::swap(m_current, m_next);
+    m_currentTime += m_tickDuration;
+    m_statistics.ticks++;
+    m_statistics.averageTickMs = m_statistics.averageTickMs * 0.95f + m_lastTickMs * 0.05f;
+}
+
+void FixedTimestepSimulation::WaitForTick() {
+    bool ranAhead = false;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ranAhead = m_tickInFlight;
+        m_tickFinished.wait(lock, [this]() { return !m_tickInFlight; });
+    }
+    if (!ranAhead) {
+        return;
+    }
+
+    // The tick that ran ahead completed: m_next becomes the current state.
+    std::swap(m_previous, m_current);
+    std::swap(m_current, m_next);
+    m_currentTime += m_tickDuration;
+    m_statistics.ticks++;
+    m_statistics.ticksLastFrame++;
+    m_statistics.averageTickMs = m_statistics.averageTickMs * 0.95f + m_lastTickMs * 0.05f;
+}
+
+void FixedTimestepSimulation::Interpolate(float factor) {
+    m_statistics.interpolationFactor = factor;
+    const size_t count = std::min(m_previous.size(), m_current.size());
+    m_interpolated.resize(m_current.size());
+    for (size_t i = 0; i < count; i++) {
+        XrVector3f_Lerp(&m_interpolated[i].position, &m_previous[i].position, &m_current[i].position, factor);
+        XrQuaternionf_Lerp(&m_interpolated[i].orientation, &m_previous[i].orientation, &m_current[i].orientation, factor);
+    }
+    // Objects that were added in the last tick have no previous transform.
+    for (size_t i = count; i < m_current.size(); i++) {
+        m_interpolated[i] = m_current[i];
+    }
+}
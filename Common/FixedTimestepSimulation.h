@@ -0,0 +1,75 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <JobSystem.h>
+#include <xr_linear_algebra.h>
+
+// Runs the game logic at a fixed tick rate, independent of the display rate, so that its cost no longer scales with
+// the refresh rate.
+//
+// The simulation keeps the previous and the current state, one tick apart, with the current state at or after the
+// frame's predicted display time. The transforms for rendering are interpolated between them. Ticks that are needed to
+// reach the display time run on the calling thread, and the tick that the next frame will need runs ahead on the job
+// system, concurrently with rendering. If the simulation falls behind by more than maxTicksPerFrame ticks, e.g. after a
+// breakpoint, the missed ticks are dropped.
+//
+// The state is the transforms of the simulated objects. Any other game state is owned by the tick function, which is
+// only ever called for one tick at a time.
+class FixedTimestepSimulation {
+public:
+    typedef std::vector<XrPosef> State;
+    // Computes next, at time, from current, deltaTime seconds earlier.
+    typedef std::function<void(const State& current, State& next, XrTime time, float deltaTime)> TickFunction;
+
+    struct Statistics {
+        uint64_t ticks;
+        uint32_t ticksLastFrame;
+        uint64_t droppedTicks;
+        float averageTickMs;        // Exponential moving average.
+        float interpolationFactor;  // Of the last frame, between the previous and the current state.
+    };
+
+    FixedTimestepSimulation(float tickRate, TickFunction tick, JobSystem& jobSystem, uint32_t maxTicksPerFrame = 4);
+    ~FixedTimestepSimulation();
+
+    // Replaces the previous and current states, e.g. when objects are added or removed.
+    void SetState(const State& state);
+
+    // Call once per frame, before rendering.
+    void Update(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod);
+
+    // The transforms at the predicted display time of the last Update().
+    const State& GetInterpolatedState() const { return m_interpolated; }
+
+    float GetTickRate() const { return m_tickRate; }
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+private:
+    void Tick();
+    void WaitForTick();
+    void Interpolate(float factor);
+
+    float m_tickRate = 60.0f;
+    XrDuration m_tickDuration = 0;
+    TickFunction m_tick;
+    JobSystem& m_jobSystem;
+    uint32_t m_maxTicksPerFrame = 4;
+    Statistics m_statistics{};
+
+    bool m_started = false;
+    XrTime m_currentTime = 0;  // Of m_current. m_previous is one tick earlier.
+    State m_previous;
+    State m_current;
+    State m_next;
+    State m_interpolated;
+
+    // The tick running ahead on the job system, which writes m_next from m_current.
+    std::mutex m_mutex;
+    std::condition_variable m_tickFinished;
+    bool m_tickInFlight = false;
+    float m_lastTickMs = 0.0f;
+};
@@ -0,0 +1,56 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <FrameCodec.h>
+#include <AssetArchive.h>
+
+void FrameCodec::Encode(const uint8_t *rgba8, uint32_t width, uint32_t height, std::vector<uint8_t> &encoded) {
+    const size_t texelCount = (size_t)width * height;
+    std::vector<uint8_t> planes(texelCount * 3);
+    for (uint32_t channel = 0; channel < 3; channel++) {
+        uint8_t *plane = planes.data() + texelCount * channel;
+        for (uint32_t y = 0; y < height; y++) {
+            const uint8_t *row = rgba8 + (size_t)y * width * 4 + channel;
+            uint8_t *planeRow = plane + (size_t)y * width;
+            // The first texel of a row is predicted from the one above it.
+            uint8_t previous = y > 0 ? row[-(ptrdiff_t)width * 4] : 0;
+            for (uint32_t x = 0; x < width; x++) {
+                const uint8_t value = row[x * 4];
+                planeRow[x] = (uint8_t)(value - previous);
+                previous = value;
+            }
+        }
+    }
+    AssetArchive::Compress(planes.data(), planes.size(), encoded);
+}
+
+size_t FrameCodec::GetMaxEncodedSize(uint32_t width, uint32_t height) {
+    return AssetArchive::GetMaxCompressedSize((size_t)width * height * 3);
+}
+
+bool FrameCodec::Decode(const uint8_t *encoded, size_t encodedSize, uint32_t width, uint32_t height, uint8_t *rgba8) {
+    const size_t texelCount = (size_t)width * height;
+    std::vector<uint8_t> planes(texelCount * 3);
+    if (!AssetArchive::Decompress(encoded, encodedSize, planes.data(), planes.size())) {
+        return false;
+    }
+    for (uint32_t channel = 0; channel < 3; channel++) {
+        const uint8_t *plane = planes.data() + texelCount * channel;
+        for (uint32_t y = 0; y < height; y++) {
+            uint8_t *row = rgba8 + (size_t)y * width * 4 + channel;
+            const uint8_t *planeRow = plane + (size_t)y * width;
+            uint8_t previous = y > 0 ? row[-(ptrdiff_t)width * 4] : 0;
+            for (uint32_t x = 0; x < width; x++) {
+                previous = (uint8_t)(previous + planeRow[x]);
+                row[x * 4] = previous;
+            }
+        }
+    }
+    for (size_t i = 0; i < texelCount; i++) {
+        rgba8[i * 4 + 3] = 255;
+    }
+    return true;
+}
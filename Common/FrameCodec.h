@@ -0,0 +1,27 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <HelperFunctions.h>
+
+// A fast lossless codec for rendered RGBA8 images, for streaming frames between processes.
+//
+// The alpha channel is dropped. The red, green and blue channels are split into planes, and each byte is replaced by its
+// difference to the byte on its left, which turns the smooth gradients and flat areas of rendered images into runs of
+// small values. The planes are then compressed with the LZ77 codec of AssetArchive. Without entropy coding, both
+// directions trade some compression ratio for speed.
+class FrameCodec {
+public:
+    // Replaces encoded with the encoded image of width x height tightly packed RGBA8 texels.
+    static void Encode(const uint8_t* rgba8, uint32_t width, uint32_t height, std::vector<uint8_t>& encoded);
+
+    // Decodes into width x height tightly packed RGBA8 texels with an alpha of 255. Returns false if the data is
+    // malformed or does not match the size.
+    static bool Decode(const uint8_t* encoded, size_t encodedSize, uint32_t width, uint32_t height, uint8_t* rgba8);
+
+    // The largest encoded size of a width x height image, e.g. to validate sizes received from another process.
+    static size_t GetMaxEncodedSize(uint32_t width, uint32_t height);
+};
@@ -0,0 +1,303 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <FrameTrace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+FrameTrace::FrameTrace(XrInstance xrInstance, GraphicsAPI *graphicsAPI, bool convertTimespecTimeEnabled, size_t maxFrames)
+    : m_xrInstance(xrInstance), m_graphicsAPI(graphicsAPI), m_maxFrames(maxFrames) {
+#if defined(XR_USE_TIMESPEC)
+    // Load the conversion function pointers as they are not default loaded by the OpenXR loader.
+    if (convertTimespecTimeEnabled) {
+        OPENXR_CHECK(xrGetInstanceProcAddr(m_xrInstance, "xrConvertTimespecTimeToTimeKHR", (PFN_xrVoidFunction *)&xrConvertTimespecTimeToTimeKHR), "Failed to get InstanceProcAddr.");
+        OPENXR_CHECK(xrGetInstanceProcAddr(m_xrInstance, "xrConvertTimeToTimespecTimeKHR", (PFN_xrVoidFunction *)&xrConvertTimeToTimespecTimeKHR), "Failed to get InstanceProcAddr.");
+    }
+    if (xrConvertTimespecTimeToTimeKHR && xrConvertTimeToTimespecTimeKHR) {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        XrTime xrTime = 0;
+        if (XR_SUCCEEDED(xrConvertTimespecTimeToTimeKHR(m_xrInstance, &now, &xrTime))) {
+            m_xrTimeOffset = xrTime - (int64_t(now.tv_sec) * 1000000000 + int64_t(now.tv_nsec));
+            m_xrTimeCorrelated = true;
+        }
+    }
+#endif
+    if (!m_xrTimeCorrelated) {
+        std::cout << "WARNING: FrameTrace: XR_KHR_convert_timespec_time is unavailable. XrTime is not correlated with CLOCK_MONOTONIC." << std::endl;
+    }
+
+    for (FrameQuery &frameQuery : m_frameQueries) {
+        frameQuery.query = m_graphicsAPI->CreateTimestampQuery();
+    }
+    CalibrateGPUTime();
+}
+
+FrameTrace::~FrameTrace() {
+    for (FrameQuery &frameQuery : m_frameQueries) {
+        m_graphicsAPI->DestroyTimestampQuery(frameQuery.query);
+    }
+}
+
+void FrameTrace::BeginFrame(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod) {
+    const int64_t now = GetMonotonicTime();
+
+    ReadGPUTimestamps();
+    if (m_statisticsDirty) {
+        UpdateStatistics();
+    }
+    if (now - m_gpuCalibrationTime > 1000000000) {
+        CalibrateGPUTime();
+    }
+
+    Frame frame{};
+    frame.index = m_frameIndex++;
+    frame.predictedDisplayXrTime = predictedDisplayTime;
+    frame.predictedDisplayPeriod = predictedDisplayPeriod;
+    frame.predictedDisplayTime = ToMonotonicTime(predictedDisplayTime);
+    frame.frameStartTime = now;
+    frame.workStartTime = now;
+    m_frames.push_back(frame);
+    while (m_frames.size() > m_maxFrames) {
+        m_frames.pop_front();
+    }
+}
+
+void FrameTrace::BeginWork() {
+    if (!m_frames.empty()) {
+        m_frames.back().workStartTime = GetMonotonicTime();
+    }
+}
+
+void FrameTrace::LocateViews() {
+    if (!m_frames.empty()) {
+        m_frames.back().locateViewsTime = GetMonotonicTime();
+    }
+}
+
+void FrameTrace::EndFrame() {
+    if (m_frames.empty()) {
+        return;
+    }
+    Frame &frame = m_frames.back();
+    frame.submitTime = GetMonotonicTime();
+
+    // The timestamp is written once all previously submitted GPU work has completed. If the query of this slot is
+    // still pending, the GPU is more than frameQueryCount frames behind and that frame's completion is not recorded.
+    FrameQuery &frameQuery = m_frameQueries[m_frameQueryIndex];
+    m_frameQueryIndex = (m_frameQueryIndex + 1) % frameQueryCount;
+    m_graphicsAPI->WriteTimestamp(frameQuery.query);
+    frameQuery.frameIndex = frame.index;
+    frameQuery.pending = true;
+}
+
+bool FrameTrace::Export(const std::string &path, const std::vector<std::pair<std::string, std::string>> &otherData) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "ERROR: FrameTrace: Failed to open " << path << std::endl;
+        return false;
+    }
+
+    // Trace event timestamps are in microseconds.
+    auto Microseconds = [](int64_t time) -> double { return double(time) * 1e-3; };
+    file.setf(std::ios::fixed);
+    file.precision(3);
+
+    file << "{\"displayTimeUnit\":\"ns\",\"otherData\":{";
+    file << "\"timebase\":\"CLOCK_MONOTONIC\",";
+    file << "\"xrTimeCorrelated\":" << (m_xrTimeCorrelated ? "true" : "false") << ",";
+    file << "\"xrTimeOffsetNs\":" << m_xrTimeOffset << ",";
+    file << "\"gpuTimeCalibrated\":" << (m_gpuTimeCalibrated ? "true" : "false") << ",";
+    file << "\"gpuTimeOffsetNs\":" << m_gpuTimeOffset << ",";
+    auto WriteDistribution = [&file](const char *name, const Distribution &distribution) {
+        file << "\"" << name << "\":{\"meanMs\":" << distribution.mean << ",\"p50Ms\":" << distribution.p50 << ",\"p90Ms\":" << distribution.p90
+             << ",\"p99Ms\":" << distribution.p99 << ",\"maxMs\":" << distribution.max << "},";
+    };
+    WriteDistribution("predictionHorizon", m_statistics.predictionHorizon);
+    WriteDistribution("poseAgeAtDisplay", m_statistics.poseAgeAtDisplay);
+    WriteDistribution("submitToDisplay", m_statistics.submitToDisplay);
+    WriteDistribution("gpuCompleteToDisplay", m_statistics.gpuCompleteToDisplay);
+    file << "\"statisticsFrameCount\":" << m_statistics.frameCount << ",\"lateFrames\":" << m_statistics.lateFrames;
+    for (const std::pair<std::string, std::string> &data : otherData) {
+        file << ",\"" << data.first << "\":" << data.second;
+    }
+    file << "},\n";
+
+    file << "\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"Display\"}}";
+    for (const Frame &frame : m_frames) {
+        if (frame.submitTime == 0) {
+            continue;
+        }
+        if (frame.workStartTime > frame.frameStartTime) {
+            file << ",\n{\"name\":\"Just-In-Time Wait\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << Microseconds(frame.frameStartTime)
+                 << ",\"dur\":" << Microseconds(frame.workStartTime - frame.frameStartTime) << ",\"args\":{\"frame\":" << frame.index << "}}";
+        }
+        file << ",\n{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << Microseconds(frame.workStartTime)
+             << ",\"dur\":" << Microseconds(frame.submitTime - frame.workStartTime)
+             << ",\"args\":{\"frame\":" << frame.index << ",\"predictedDisplayXrTime\":" << frame.predictedDisplayXrTime << "}}";
+        if (frame.locateViewsTime != 0) {
+            file << ",\n{\"name\":\"Locate Views\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,\"ts\":" << Microseconds(frame.locateViewsTime)
+                 << ",\"args\":{\"frame\":" << frame.index << ",\"predictionHorizonMs\":" << double(frame.predictedDisplayTime - frame.locateViewsTime) * 1e-6 << "}}";
+        }
+        if (frame.gpuCompleteTime != 0) {
+            // From submission to completion. This includes any GPU work of earlier frames that was still queued.
+            file << ",\n{\"name\":\"GPU\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":" << Microseconds(frame.submitTime)
+                 << ",\"dur\":" << Microseconds(frame.gpuCompleteTime - frame.submitTime)
+                 << ",\"args\":{\"frame\":" << frame.index << "}}";
+        }
+        file << ",\n{\"name\":\"Predicted Display\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":3,\"ts\":" << Microseconds(frame.predictedDisplayTime)
+             << ",\"args\":{\"frame\":" << frame.index << ",\"frameStartToDisplayMs\":" << double(frame.predictedDisplayTime - frame.frameStartTime) * 1e-6;
+        if (frame.gpuCompleteTime != 0) {
+            const int64_t displayTime = GetEstimatedDisplayTime(frame);
+            file << ",\"gpuCompleteToDisplayMs\":" << double(frame.predictedDisplayTime - frame.gpuCompleteTime) * 1e-6;
+            file << ",\"estimatedDisplayDelayMs\":" << double(displayTime - frame.predictedDisplayTime) * 1e-6;
+            if (frame.locateViewsTime != 0) {
+                file << ",\"poseAgeAtDisplayMs\":" << double(displayTime - frame.locateViewsTime) * 1e-6;
+            }
+        }
+        file << "}}";
+    }
+    file << "\n]}\n";
+    return bool(file);
+}
+
+int64_t FrameTrace::GetEstimatedDisplayTime(const Frame &frame) {
+    const int64_t late = frame.gpuCompleteTime - frame.predictedDisplayTime;
+    if (frame.gpuCompleteTime == 0 || late <= 0 || frame.predictedDisplayPeriod <= 0) {
+        return frame.predictedDisplayTime;
+    }
+    const int64_t periods = (late + frame.predictedDisplayPeriod - 1) / frame.predictedDisplayPeriod;
+    return frame.predictedDisplayTime + periods * frame.predictedDisplayPeriod;
+}
+
+int64_t FrameTrace::GetMonotonicTime() {
+#if defined(XR_USE_TIMESPEC)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return int64_t(now.tv_sec) * 1000000000 + int64_t(now.tv_nsec);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int64_t FrameTrace::ToMonotonicTime(XrTime time) const {
+#if defined(XR_USE_TIMESPEC)
+    if (m_xrTimeCorrelated) {
+        timespec result;
+        if (XR_SUCCEEDED(xrConvertTimeToTimespecTimeKHR(m_xrInstance, time, &result))) {
+            return int64_t(result.tv_sec) * 1000000000 + int64_t(result.tv_nsec);
+        }
+    }
+#endif
+    return time - m_xrTimeOffset;
+}
+
+XrTime FrameTrace::ToXrTime(int64_t monotonicTime) const {
+#if defined(XR_USE_TIMESPEC)
+    if (m_xrTimeCorrelated) {
+        timespec time;
+        time.tv_sec = time_t(monotonicTime / 1000000000);
+        time.tv_nsec = long(monotonicTime % 1000000000);
+        XrTime result = 0;
+        if (XR_SUCCEEDED(xrConvertTimespecTimeToTimeKHR(m_xrInstance, &time, &result))) {
+            return result;
+        }
+    }
+#endif
+    return monotonicTime + m_xrTimeOffset;
+}
+
+void FrameTrace::CalibrateGPUTime() {
+    // Bracket the GPU time query with CPU times, and keep the tightest of a few samples.
+    int64_t bestInterval = INT64_MAX;
+    for (uint32_t i = 0; i < 3; i++) {
+        uint64_t gpuTime = 0;
+        const int64_t before = GetMonotonicTime();
+        const bool available = m_graphicsAPI->GetCurrentTimestamp(gpuTime);
+        const int64_t after = GetMonotonicTime();
+        if (!available) {
+            break;
+        }
+        if (after - before < bestInterval) {
+            bestInterval = after - before;
+            m_gpuTimeOffset = before + (after - before) / 2 - int64_t(gpuTime);
+            m_gpuTimeCalibrated = true;
+        }
+    }
+    m_gpuCalibrationTime = GetMonotonicTime();
+}
+
+void FrameTrace::ReadGPUTimestamps() {
+    for (FrameQuery &frameQuery : m_frameQueries) {
+        uint64_t timestamp = 0;
+        if (!frameQuery.pending || !m_graphicsAPI->GetTimestamp(frameQuery.query, timestamp)) {
+            continue;
+        }
+        frameQuery.pending = false;
+        if (!m_gpuTimeCalibrated || m_frames.empty() || frameQuery.frameIndex < m_frames.front().index) {
+            continue;
+        }
+        Frame &frame = m_frames[size_t(frameQuery.frameIndex - m_frames.front().index)];
+        frame.gpuCompleteTime = int64_t(timestamp) + m_gpuTimeOffset;
+        m_statisticsDirty = true;
+    }
+}
+
+void FrameTrace::UpdateStatistics() {
+    std::vector<float> predictionHorizon;
+    std::vector<float> poseAgeAtDisplay;
+    std::vector<float> submitToDisplay;
+    std::vector<float> gpuCompleteToDisplay;
+    uint32_t lateFrames = 0;
+    for (auto it = m_frames.rbegin(); it != m_frames.rend() && submitToDisplay.size() < statisticsWindow; ++it) {
+        const Frame &frame = *it;
+        if (frame.gpuCompleteTime == 0 || frame.submitTime == 0) {
+            continue;
+        }
+        const int64_t displayTime = GetEstimatedDisplayTime(frame);
+        if (displayTime != frame.predictedDisplayTime) {
+            lateFrames++;
+        }
+        if (frame.locateViewsTime != 0) {
+            predictionHorizon.push_back(float(frame.predictedDisplayTime - frame.locateViewsTime) * 1e-6f);
+            poseAgeAtDisplay.push_back(float(displayTime - frame.locateViewsTime) * 1e-6f);
+        }
+        submitToDisplay.push_back(float(displayTime - frame.submitTime) * 1e-6f);
+        gpuCompleteToDisplay.push_back(float(frame.predictedDisplayTime - frame.gpuCompleteTime) * 1e-6f);
+    }
+
+    m_statistics.frameCount = static_cast<uint32_t>(submitToDisplay.size());
+    m_statistics.lateFrames = lateFrames;
+    m_statistics.predictionHorizon = GetDistribution(predictionHorizon);
+    m_statistics.poseAgeAtDisplay = GetDistribution(poseAgeAtDisplay);
+    m_statistics.submitToDisplay = GetDistribution(submitToDisplay);
+    m_statistics.gpuCompleteToDisplay = GetDistribution(gpuCompleteToDisplay);
+    m_statisticsDirty = false;
+}
+
+FrameTrace::Distribution FrameTrace::GetDistribution(std::vector<float> &samples) {
+    Distribution distribution{};
+    if (samples.empty()) {
+        return distribution;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto Percentile = [&samples](float p) -> float { return samples[std::min(samples.size() - 1, size_t(p * float(samples.size())))]; };
+    float sum = 0.0f;
+    for (float sample : samples) {
+        sum += sample;
+    }
+    distribution.mean = sum / float(samples.size());
+    distribution.p50 = Percentile(0.5f);
+    distribution.p90 = Percentile(0.9f);
+    distribution.p99 = Percentile(0.99f);
+    distribution.max = samples.back();
+    return distribution;
+}
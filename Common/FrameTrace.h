@@ -0,0 +1,128 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+
+#include <deque>
+
+// Records the timing of each frame on a single timebase, CLOCK_MONOTONIC in nanoseconds, so that the frames can be lined
+// up with system traces, e.g. perf, and the GPU timestamps.
+//
+// XrTime is converted to and from CLOCK_MONOTONIC with XR_KHR_convert_timespec_time. GPU timestamps are converted with
+// an offset that is calibrated against the current GPU time about once per second. Without the extension, e.g. on
+// Windows, XrTime values are stored unconverted and the trace marks them as not correlated.
+//
+// Export() writes the Chrome trace event format, which Perfetto and chrome://tracing open, including the offsets
+// between the timebases.
+//
+// Latency: The views are predicted for the predicted display time when xrLocateViews() is called, so the prediction
+// horizon is the time from xrLocateViews() to the predicted display time. A frame whose GPU work completes after the
+// predicted display time is shown at a later display period instead, so the pose age at display is the time from
+// xrLocateViews() to the estimated display time. GetStatistics() reports their distributions over the recent frames.
+class FrameTrace {
+public:
+    struct Frame {
+        uint64_t index;
+        XrTime predictedDisplayXrTime;
+        XrDuration predictedDisplayPeriod;
+        // CLOCK_MONOTONIC in nanoseconds. A time is 0 while unknown.
+        int64_t predictedDisplayTime;
+        int64_t frameStartTime;   // xrWaitFrame() returned.
+        int64_t workStartTime;    // The frame's CPU work started. Later than frameStartTime with a just-in-time start.
+        int64_t locateViewsTime;  // xrLocateViews() returned.
+        int64_t submitTime;       // The frame's GPU work was submitted, before xrEndFrame().
+        int64_t gpuCompleteTime;
+    };
+
+    // In milliseconds.
+    struct Distribution {
+        float mean;
+        float p50;
+        float p90;
+        float p99;
+        float max;
+    };
+    struct Statistics {
+        uint32_t frameCount;  // Frames with a known GPU completion in the window.
+        uint32_t lateFrames;  // Frames whose GPU work completed after the predicted display time.
+        Distribution predictionHorizon;
+        Distribution poseAgeAtDisplay;
+        Distribution submitToDisplay;
+        Distribution gpuCompleteToDisplay;  // Negative when late.
+    };
+
+    // convertTimespecTimeEnabled: XR_KHR_convert_timespec_time is an active instance extension.
+    FrameTrace(XrInstance xrInstance, GraphicsAPI* graphicsAPI, bool convertTimespecTimeEnabled, size_t maxFrames = 10000);
+    ~FrameTrace();
+
+    // Call when xrWaitFrame() returns. Also reads back the GPU completion of older frames.
+    void BeginFrame(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod);
+    // Call when the frame's CPU work starts, if it is later than xrWaitFrame() returning.
+    void BeginWork();
+    // Call when xrLocateViews() returns.
+    void LocateViews();
+    // Call after the frame's rendering has been submitted, before xrEndFrame().
+    void EndFrame();
+
+    // otherData: Additional members of the trace's otherData object, as names and JSON values, e.g. PerfCounters::GetStatisticsJSON().
+    bool Export(const std::string& path, const std::vector<std::pair<std::string, std::string>>& otherData = {}) const;
+
+    static int64_t GetMonotonicTime();
+    int64_t ToMonotonicTime(XrTime time) const;
+    XrTime ToXrTime(int64_t monotonicTime) const;
+
+    bool IsXrTimeCorrelated() const { return m_xrTimeCorrelated; }
+    // XrTime minus CLOCK_MONOTONIC, and CLOCK_MONOTONIC minus the GPU timestamps, in nanoseconds.
+    int64_t GetXrTimeOffset() const { return m_xrTimeOffset; }
+    int64_t GetGPUTimeOffset() const { return m_gpuTimeOffset; }
+
+    const std::deque<Frame>& GetFrames() const { return m_frames; }
+    // Over the last statisticsWindow frames with a known GPU completion.
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+    // The predicted display time, or the first display period after the GPU completion, if the frame was late.
+    static int64_t GetEstimatedDisplayTime(const Frame& frame);
+
+private:
+    struct FrameQuery {
+        void* query;
+        uint64_t frameIndex;
+        bool pending;
+    };
+
+    void CalibrateGPUTime();
+    void ReadGPUTimestamps();
+    void UpdateStatistics();
+    static Distribution GetDistribution(std::vector<float>& samples);
+
+    XrInstance m_xrInstance = XR_NULL_HANDLE;
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    size_t m_maxFrames = 0;
+
+#if defined(XR_USE_TIMESPEC)
+    PFN_xrConvertTimespecTimeToTimeKHR xrConvertTimespecTimeToTimeKHR = nullptr;
+    PFN_xrConvertTimeToTimespecTimeKHR xrConvertTimeToTimespecTimeKHR = nullptr;
+#endif
+    bool m_xrTimeCorrelated = false;
+    int64_t m_xrTimeOffset = 0;
+
+    bool m_gpuTimeCalibrated = false;
+    int64_t m_gpuTimeOffset = 0;
+    int64_t m_gpuCalibrationTime = 0;
+
+    std::deque<Frame> m_frames;
+    uint64_t m_frameIndex = 0;
+
+    static constexpr size_t statisticsWindow = 300;
+    Statistics m_statistics{};
+    bool m_statisticsDirty = false;
+
+    // Timestamps are read a few frames later, so that reading them never stalls.
+    static constexpr uint32_t frameQueryCount = 4;
+    FrameQuery m_frameQueries[frameQueryCount] = {};
+    uint32_t m_frameQueryIndex = 0;
+};
@@ -0,0 +1,58 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <FullscreenPass.h>
+
+// Generates a triangle from gl_VertexID, which covers clip space with texture coordinates from 0 to 1 inside it.
+static const char *fullscreenVertexShaderSource = R"(
+#version 450
+layout(location = 0) out vec2 o_TexCoord;
+void main() {
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    o_TexCoord = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+FullscreenPass::FullscreenPass(GraphicsAPI *graphicsAPI, const char *fragmentSource, const std::vector<int64_t> &colorFormats,
+                               const std::vector<GraphicsAPI::DescriptorInfo> &layout, const GraphicsAPI::ColorBlendAttachmentState *blendState, int64_t depthFormat)
+    : m_graphicsAPI(graphicsAPI) {
+    m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, fullscreenVertexShaderSource, strlen(fullscreenVertexShaderSource)});
+    m_fragmentShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, fragmentSource, strlen(fragmentSource)});
+
+    const GraphicsAPI::ColorBlendAttachmentState attachmentState = blendState ? *blendState : GetOpaqueBlendState();
+    GraphicsAPI::PipelineCreateInfo pipelineCI{};
+    pipelineCI.shaders = {m_vertexShader, m_fragmentShader};
+    pipelineCI.inputAssemblyState = {GraphicsAPI::PrimitiveTopology::TRIANGLE_LIST, false};
+    pipelineCI.rasterisationState = {false, false, GraphicsAPI::PolygonMode::FILL, GraphicsAPI::CullMode::NONE, GraphicsAPI::FrontFace::COUNTER_CLOCKWISE, false, 0.0f, 0.0f, 0.0f, 1.0f};
+    pipelineCI.multisampleState = {1, false, 1.0f, 0, false, false};
+    pipelineCI.depthStencilState = {depthFormat != 0, depthFormat != 0, GraphicsAPI::CompareOp::ALWAYS, false, false, {}, {}, 0.0f, 1.0f};
+    pipelineCI.colorBlendState = {false, GraphicsAPI::LogicOp::NO_OP, std::vector<GraphicsAPI::ColorBlendAttachmentState>(colorFormats.size(), attachmentState), {0.0f, 0.0f, 0.0f, 0.0f}};
+    pipelineCI.colorFormats = colorFormats;
+    pipelineCI.depthFormat = depthFormat;
+    pipelineCI.layout = layout;
+    m_pipeline = m_graphicsAPI->CreatePipeline(pipelineCI);
+}
+
+FullscreenPass::~FullscreenPass() {
+    m_graphicsAPI->DestroyPipeline(m_pipeline);
+    m_graphicsAPI->DestroyShader(m_fragmentShader);
+    m_graphicsAPI->DestroyShader(m_vertexShader);
+}
+
+void FullscreenPass::Draw() {
+    m_graphicsAPI->Draw(3);
+}
+
+GraphicsAPI::ColorBlendAttachmentState FullscreenPass::GetOpaqueBlendState() {
+    return {false, GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ZERO, GraphicsAPI::BlendOp::ADD,
+            GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ZERO, GraphicsAPI::BlendOp::ADD, (GraphicsAPI::ColorComponentBit)15};
+}
+
+GraphicsAPI::ColorBlendAttachmentState FullscreenPass::GetPremultipliedAlphaBlendState() {
+    return {true, GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ONE_MINUS_SRC_ALPHA, GraphicsAPI::BlendOp::ADD,
+            GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ONE_MINUS_SRC_ALPHA, GraphicsAPI::BlendOp::ADD, (GraphicsAPI::ColorComponentBit)15};
+}
@@ -0,0 +1,36 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+
+// A pipeline that draws a single triangle covering the render attachments, for image space passes such as
+// reprojection, upsampling and resolves. The fragment shader receives the attachment's texture coordinate in
+// layout(location = 0) in vec2 i_TexCoord, with (0, 0) at the first texel of the image.
+class FullscreenPass {
+public:
+    // fragmentSource is GLSL 4.50.
+    // Without a blend state, the pass overwrites the attachments. With a depthFormat, the pass writes gl_FragDepth
+    // to the depth attachment without testing.
+    FullscreenPass(GraphicsAPI* graphicsAPI, const char* fragmentSource, const std::vector<int64_t>& colorFormats,
+                   const std::vector<GraphicsAPI::DescriptorInfo>& layout, const GraphicsAPI::ColorBlendAttachmentState* blendState = nullptr, int64_t depthFormat = 0);
+    ~FullscreenPass();
+
+    void* GetPipeline() { return m_pipeline; }
+
+    // Call SetPipeline(GetPipeline()) and set the descriptors before drawing.
+    void Draw();
+
+    // Common states for the blendState parameter.
+    static GraphicsAPI::ColorBlendAttachmentState GetOpaqueBlendState();
+    static GraphicsAPI::ColorBlendAttachmentState GetPremultipliedAlphaBlendState();
+
+private:
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    void* m_vertexShader = nullptr;
+    void* m_fragmentShader = nullptr;
+    void* m_pipeline = nullptr;
+};
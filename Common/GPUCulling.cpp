@@ -0,0 +1,162 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <GPUCulling.h>
+
+// GLSL 4.50 compute shader.
+static const char *cullComputeShaderSource = R"(
+#version 450
+layout(local_size_x = 64) in;
+
+struct DrawRecord {
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint objectIndex;
+};
+struct DrawIndexedIndirectCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std140, binding = 0) uniform CullUniforms {
+    vec4 planes[4 * 6];
+    uint objectCount;
+    uint viewCount;
+};
+layout(std430, binding = 1) readonly buffer Bounds {
+    vec4 bounds[];
+};
+layout(std430, binding = 2) readonly buffer DrawRecords {
+    DrawRecord drawRecords[];
+};
+layout(std430, binding = 3) writeonly buffer DrawCommands {
+    DrawIndexedIndirectCommand drawCommands[];
+};
+layout(std430, binding = 4) buffer DrawCount {
+    uint drawCount;
+};
+
+bool SphereInFrustum(vec4 sphere, uint view) {
+    for (uint i = 0; i < 6; i++) {
+        vec4 plane = planes[view * 6 + i];
+        if (dot(plane.xyz, sphere.xyz) + plane.w < -sphere.w) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void main() {
+    uint objectIndex = gl_GlobalInvocationID.x;
+    if (objectIndex >= objectCount) {
+        return;
+    }
+
+    // An object is drawn if it is visible in any of the views.
+    vec4 sphere = bounds[objectIndex];
+    bool visible = false;
+    for (uint view = 0; view < viewCount && !visible; view++) {
+        visible = SphereInFrustum(sphere, view);
+    }
+    if (!visible) {
+        return;
+    }
+
+    uint drawIndex = atomicAdd(drawCount, 1);
+    DrawRecord drawRecord = drawRecords[objectIndex];
+    drawCommands[drawIndex] = DrawIndexedIndirectCommand(drawRecord.indexCount, 1, drawRecord.firstIndex, drawRecord.vertexOffset, drawRecord.objectIndex);
+}
+)";
+
+GPUCulling::GPUCulling(GraphicsAPI *graphicsAPI, uint32_t maxObjectCount)
+    : m_graphicsAPI(graphicsAPI), m_maxObjectCount(maxObjectCount) {
+    m_computeShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::COMPUTE, cullComputeShaderSource, strlen(cullComputeShaderSource)});
+
+    GraphicsAPI::PipelineCreateInfo pipelineCI{};
+    pipelineCI.shaders = {m_computeShader};
+    pipelineCI.layout = {{0, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE},
+                         {1, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE},
+                         {2, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE},
+                         {3, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE, true},
+                         {4, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE, true}};
+    m_computePipeline = m_graphicsAPI->CreatePipeline(pipelineCI);
+
+    const size_t boundsSize = sizeof(ObjectBounds) * m_maxObjectCount;
+    const size_t drawRecordsSize = sizeof(DrawRecord) * m_maxObjectCount;
+    const size_t drawCommandsSize = sizeof(GraphicsAPI::DrawIndexedIndirectCommand) * m_maxObjectCount;
+    m_uniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(CullUniforms), nullptr});
+    m_stagingBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STAGING, 0, boundsSize + drawRecordsSize, nullptr});
+    m_boundsBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STORAGE, sizeof(ObjectBounds), boundsSize, nullptr});
+    m_drawRecordBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STORAGE, sizeof(DrawRecord), drawRecordsSize, nullptr});
+    m_drawCommandBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::INDIRECT, sizeof(GraphicsAPI::DrawIndexedIndirectCommand), drawCommandsSize, nullptr});
+    m_drawCountBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::INDIRECT, sizeof(uint32_t), sizeof(uint32_t), nullptr});
+}
+
+GPUCulling::~GPUCulling() {
+    m_graphicsAPI->DestroyBuffer(m_drawCountBuffer);
+    m_graphicsAPI->DestroyBuffer(m_drawCommandBuffer);
+    m_graphicsAPI->DestroyBuffer(m_drawRecordBuffer);
+    m_graphicsAPI->DestroyBuffer(m_boundsBuffer);
+    m_graphicsAPI->DestroyBuffer(m_stagingBuffer);
+    m_graphicsAPI->DestroyBuffer(m_uniformBuffer);
+    m_graphicsAPI->DestroyPipeline(m_computePipeline);
+    m_graphicsAPI->DestroyShader(m_computeShader);
+}
+
+void GPUCulling::SetObjects(const std::vector<ObjectBounds> &bounds, const std::vector<DrawRecord> &drawRecords) {
+    if (bounds.size() != drawRecords.size() || bounds.size() > m_maxObjectCount) {
+        std::cout << "ERROR: GPUCulling: Object count mismatch or maxObjectCount exceeded." << std::endl;
+        DEBUG_BREAK;
+        return;
+    }
+    m_objectCount = static_cast<uint32_t>(bounds.size());
+
+    // Write both arrays into the staging buffer once, then copy them into the storage buffers on the GPU.
+    const size_t boundsSize = sizeof(ObjectBounds) * m_objectCount;
+    const size_t drawRecordsSize = sizeof(DrawRecord) * m_objectCount;
+    const size_t drawRecordsOffset = sizeof(ObjectBounds) * m_maxObjectCount;
+    m_graphicsAPI->SetBufferData(m_stagingBuffer, 0, boundsSize, (void *)bounds.data());
+    m_graphicsAPI->SetBufferData(m_stagingBuffer, drawRecordsOffset, drawRecordsSize, (void *)drawRecords.data());
+    m_graphicsAPI->CopyBuffer(m_stagingBuffer, m_boundsBuffer, 0, 0, boundsSize);
+    m_graphicsAPI->CopyBuffer(m_stagingBuffer, m_drawRecordBuffer, drawRecordsOffset, 0, drawRecordsSize);
+}
+
+void GPUCulling::Cull(const XrMatrix4x4f *viewProjections, uint32_t viewCount) {
+    if (m_objectCount == 0) {
+        return;
+    }
+
+    CullUniforms uniforms{};
+    uniforms.objectCount = m_objectCount;
+    uniforms.viewCount = std::min(viewCount, maxViewCount);
+    for (uint32_t i = 0; i < uniforms.viewCount; i++) {
+        XrMatrix4x4f_GetFrustumPlanes(&uniforms.planes[i * 6], &viewProjections[i]);
+    }
+    m_graphicsAPI->SetBufferData(m_uniformBuffer, 0, sizeof(CullUniforms), &uniforms);
+
+    uint32_t zero = 0;
+    m_graphicsAPI->SetBufferData(m_drawCountBuffer, 0, sizeof(uint32_t), &zero);
+
+    m_graphicsAPI->SetPipeline(m_computePipeline);
+    m_graphicsAPI->SetDescriptor({0, m_uniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE, false, 0, sizeof(CullUniforms)});
+    m_graphicsAPI->SetDescriptor({1, m_boundsBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE, false, 0, sizeof(ObjectBounds) * m_objectCount});
+    m_graphicsAPI->SetDescriptor({2, m_drawRecordBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE, false, 0, sizeof(DrawRecord) * m_objectCount});
+    m_graphicsAPI->SetDescriptor({3, m_drawCommandBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE, true, 0, sizeof(GraphicsAPI::DrawIndexedIndirectCommand) * m_objectCount});
+    m_graphicsAPI->SetDescriptor({4, m_drawCountBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::COMPUTE, true, 0, sizeof(uint32_t)});
+    m_graphicsAPI->UpdateDescriptors();
+    m_graphicsAPI->Dispatch((m_objectCount + workGroupSize - 1) / workGroupSize);
+}
+
+void GPUCulling::Draw() {
+    if (m_objectCount == 0) {
+        return;
+    }
+    m_graphicsAPI->DrawIndexedIndirectCount(m_drawCommandBuffer, 0, m_drawCountBuffer, 0, m_objectCount, sizeof(GraphicsAPI::DrawIndexedIndirectCommand));
+}
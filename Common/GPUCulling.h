@@ -0,0 +1,71 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+#include <xr_linear_algebra.h>
+
+// GPU-driven submission: All object bounds and draw records live in storage buffers.
+// A compute shader frustum culls every object against all views, then writes a compacted list of
+// DrawIndexedIndirectCommands and a draw count, which are consumed by a single DrawIndexedIndirectCount().
+// The CPU cost per frame is independent of the object count.
+class GPUCulling {
+public:
+    static constexpr uint32_t maxViewCount = 4;
+    static constexpr uint32_t workGroupSize = 64;
+
+    // A bounding sphere in world space. Matches a std430 vec4.
+    struct ObjectBounds {
+        XrVector3f center;
+        float radius;
+    };
+    // The index range to draw for an object. objectIndex is written to DrawIndexedIndirectCommand::firstInstance,
+    // so that the vertex shader can fetch per object data with gl_BaseInstance / SV_StartInstanceLocation.
+    struct DrawRecord {
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t objectIndex;
+    };
+
+    GPUCulling(GraphicsAPI* graphicsAPI, uint32_t maxObjectCount);
+    ~GPUCulling();
+
+    // Uploads the bounds and draw records through a staging buffer. Call when the scene changes, not every frame.
+    void SetObjects(const std::vector<ObjectBounds>& bounds, const std::vector<DrawRecord>& drawRecords);
+
+    // Culls all objects against the union of the views' frusta and writes the indirect draw arguments.
+    // Call outside of a render pass, before Draw().
+    void Cull(const XrMatrix4x4f* viewProjections, uint32_t viewCount);
+
+    // Draws the visible objects with the currently set pipeline, vertex buffers and index buffer.
+    void Draw();
+
+    void* GetDrawCommandBuffer() { return m_drawCommandBuffer; }
+    void* GetDrawCountBuffer() { return m_drawCountBuffer; }
+
+private:
+    struct CullUniforms {
+        float planes[maxViewCount * 6][4];
+        uint32_t objectCount;
+        uint32_t viewCount;
+        uint32_t pad[2];
+    };
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    uint32_t m_maxObjectCount = 0;
+    uint32_t m_objectCount = 0;
+
+    void* m_computeShader = nullptr;
+    void* m_computePipeline = nullptr;
+
+    void* m_uniformBuffer = nullptr;
+    void* m_stagingBuffer = nullptr;
+    void* m_boundsBuffer = nullptr;
+    void* m_drawRecordBuffer = nullptr;
+    void* m_drawCommandBuffer = nullptr;
+    void* m_drawCountBuffer = nullptr;
+};
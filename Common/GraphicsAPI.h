@@ -49,6 +49,10 @@
 #if defined(XR_TUTORIAL_USE_VULKAN)
 #define XR_USE_GRAPHICS_API_VULKAN
 #endif
+
+// For XR_KHR_convert_timespec_time
+#include <time.h>
+#define XR_USE_TIMESPEC
 #endif  // __linux__
 
 #if defined(__ANDROID__)
@@ -61,6 +65,10 @@
 #if defined(XR_TUTORIAL_USE_VULKAN)
 #define XR_USE_GRAPHICS_API_VULKAN
 #endif
+
+// For XR_KHR_convert_timespec_time
+#include <time.h>
+#define XR_USE_TIMESPEC
 #endif  // __ANDROID__
 
 // Graphic APIs headers
@@ -255,6 +263,7 @@ public:
             FRAGMENT,
             COMPUTE
         } type;
+        // The passes in Common/ only provide GLSL 4.50 source, which only the OpenGL backend is able to consume.
         const char* sourceData;
         size_t sourceSize;
     };
@@ -365,6 +374,10 @@ public:
             VERTEX,
             INDEX,
             UNIFORM,
+            STAGING,
+            STORAGE,
+            INDIRECT,
+            READBACK,
         } type;
         size_t stride;
         size_t size;
@@ -462,6 +475,52 @@ public:
         Offset2D offset;
         Extent2D extent;
     };
+    struct Offset3D {
+        int32_t x;
+        int32_t y;
+        int32_t z;
+    };
+    struct Extent3D {
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+    };
+
+    // Matches VkDrawIndexedIndirectCommand, D3D12_DRAW_INDEXED_ARGUMENTS and OpenGL's DrawElementsIndirectCommand.
+    struct DrawIndexedIndirectCommand {
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t firstInstance;
+    };
+
+    struct ImageSubresourceLayers {
+        uint32_t mipLevel;
+        uint32_t baseArrayLayer;
+        uint32_t layerCount;
+    };
+    struct BufferImageCopy {
+        size_t bufferOffset;
+        uint32_t bufferRowLength;    // In texels. 0 means tightly packed to imageExtent.width.
+        uint32_t bufferImageHeight;  // In texels. 0 means tightly packed to imageExtent.height.
+        ImageSubresourceLayers imageSubresource;
+        Offset3D imageOffset;
+        Extent3D imageExtent;
+    };
+    struct ImageCopy {
+        ImageSubresourceLayers srcSubresource;
+        Offset3D srcOffset;
+        ImageSubresourceLayers dstSubresource;
+        Offset3D dstOffset;
+        Extent3D extent;
+    };
+    struct ImageBlit {
+        ImageSubresourceLayers srcSubresource;
+        Offset3D srcOffsets[2];
+        ImageSubresourceLayers dstSubresource;
+        Offset3D dstOffsets[2];
+    };
 
 public:
     virtual ~GraphicsAPI() = default;
@@ -476,12 +535,29 @@ public:
     virtual void PresentDesktopSwapchainImage(void* swapchain, uint32_t index) = 0;
 
     virtual int64_t GetDepthFormat() = 0;
+    // A two channel float format for screen space motion vectors.
+    virtual int64_t GetMotionVectorFormat() = 0;
+    // A four channel float format for color that exceeds [0, 1] or needs more precision than the swapchain, e.g. for accumulating blended color.
+    virtual int64_t GetHDRColorFormat() = 0;
+    // An 8 bit per channel RGBA format for offscreen color images that are not presented through a swapchain.
+    virtual int64_t GetColorFormat() = 0;
+    // Unsigned normalized eight bit formats with one and two channels, for the luma and chroma planes of YUV video.
+    virtual int64_t GetVideoLumaFormat() = 0;
+    virtual int64_t GetVideoChromaFormat() = 0;
+
+    // Identifies the GPU and its driver, e.g. to key settings that were measured on the device.
+    virtual std::string GetDeviceName() = 0;
+    // Returns true if a render target with a TYPE_2D_ARRAY view renders all of the view's layers in one draw, with
+    // shaders that declare the number of views, e.g. with GL_OVR_multiview2.
+    virtual bool IsMultiviewSupported() = 0;
 
     virtual void* GetGraphicsBinding() = 0;
     virtual XrSwapchainImageBaseHeader* AllocateSwapchainImageData(XrSwapchain swapchain, SwapchainType type, uint32_t count) = 0;
     virtual void FreeSwapchainImageData(XrSwapchain swapchain) = 0;
     virtual XrSwapchainImageBaseHeader* GetSwapchainImageData(XrSwapchain swapchain, uint32_t index) = 0;
     virtual void* GetSwapchainImage(XrSwapchain swapchain, uint32_t index) = 0;
+    // Swapchain images are not created through CreateImage(). Call this after xrEnumerateSwapchainImages(), so that copies and blits know their type and format.
+    virtual void RegisterSwapchainImages(XrSwapchain swapchain, const XrSwapchainCreateInfo& swapchainCI) = 0;
 
     virtual void* CreateImage(const ImageCreateInfo& imageCI) = 0;
     virtual void DestroyImage(void*& image) = 0;
@@ -505,6 +581,29 @@ public:
     virtual void EndRendering() = 0;
 
     virtual void SetBufferData(void* buffer, size_t offset, size_t size, void* data) = 0;
+    virtual void* MapBuffer(void* buffer) = 0;
+    virtual void UnmapBuffer(void* buffer) = 0;
+
+    virtual void CopyBuffer(void* srcBuffer, void* dstBuffer, size_t srcOffset, size_t dstOffset, size_t size) = 0;
+    virtual void CopyBufferToImage(void* srcBuffer, void* dstImage, const BufferImageCopy& region) = 0;
+    virtual void CopyImage(void* srcImage, void* dstImage, const ImageCopy& region) = 0;
+    virtual void BlitImage(void* srcImage, void* dstImage, const ImageBlit& region, SamplerCreateInfo::Filter filter) = 0;
+    virtual void CopyImageToBuffer(void* srcImage, void* dstBuffer, const BufferImageCopy& region) = 0;
+
+    // A fence is signaled once all previously submitted GPU work has completed.
+    virtual void* CreateFence() = 0;
+    virtual void DestroyFence(void*& fence) = 0;
+    // Returns true if the fence was signaled within timeout nanoseconds. A timeout of 0 polls the fence.
+    virtual bool WaitForFence(void* fence, uint64_t timeout) = 0;
+
+    // A timestamp query records the GPU time in nanoseconds once all previously submitted GPU work has completed.
+    virtual void* CreateTimestampQuery() = 0;
+    virtual void DestroyTimestampQuery(void*& query) = 0;
+    virtual void WriteTimestamp(void* query) = 0;
+    // Returns false if the result is not yet available. Never blocks.
+    virtual bool GetTimestamp(void* query, uint64_t& timestamp) = 0;
+    // Returns the current GPU time in nanoseconds, on the timebase of the timestamp queries, without waiting for submitted work.
+    virtual bool GetCurrentTimestamp(uint64_t& timestamp) = 0;
 
     virtual void ClearColor(void* imageView, float r, float g, float b, float a) = 0;
     virtual void ClearDepth(void* imageView, float d) = 0;
@@ -520,6 +619,9 @@ public:
     virtual void SetIndexBuffer(void* indexBuffer) = 0;
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0) = 0;
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) = 0;
+    virtual void DrawIndexedIndirect(void* argumentBuffer, size_t offset, uint32_t drawCount, uint32_t stride) = 0;
+    virtual void DrawIndexedIndirectCount(void* argumentBuffer, size_t offset, void* countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride) = 0;
+    virtual void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) = 0;
 
 protected:
     virtual const std::vector<int64_t> GetSupportedColorSwapchainFormats() = 0;
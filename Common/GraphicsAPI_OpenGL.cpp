@@ -276,6 +276,106 @@ inline GLenum ToGLLogicOp(GraphicsAPI::LogicOp op) {
         return 0;
     }
 };
+inline GLenum ToGLBufferTarget(GraphicsAPI::BufferCreateInfo::Type type) {
+    switch (type) {
+    case GraphicsAPI::BufferCreateInfo::Type::VERTEX:
+        return GL_ARRAY_BUFFER;
+    case GraphicsAPI::BufferCreateInfo::Type::INDEX:
+        return GL_ELEMENT_ARRAY_BUFFER;
+    case GraphicsAPI::BufferCreateInfo::Type::UNIFORM:
+        return GL_UNIFORM_BUFFER;
+    case GraphicsAPI::BufferCreateInfo::Type::STAGING:
+        return GL_COPY_READ_BUFFER;
+    case GraphicsAPI::BufferCreateInfo::Type::STORAGE:
+        return GL_SHADER_STORAGE_BUFFER;
+    case GraphicsAPI::BufferCreateInfo::Type::INDIRECT:
+        return GL_DRAW_INDIRECT_BUFFER;
+    case GraphicsAPI::BufferCreateInfo::Type::READBACK:
+        return GL_PIXEL_PACK_BUFFER;
+    default:
+        return 0;
+    }
+};
+inline bool IsGLDepthFormat(GLenum internalFormat) {
+    return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32 || internalFormat == GL_DEPTH_COMPONENT32F || internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+// Returns the client pixel format and type that matches the internal format for glTexSubImage*().
+inline bool ToGLPixelFormatAndType(GLenum internalFormat, GLenum &format, GLenum &type) {
+    switch (internalFormat) {
+    case GL_R8:
+        format = GL_RED;
+        type = GL_UNSIGNED_BYTE;
+        return true;
+    case GL_RG8:
+        format = GL_RG;
+        type = GL_UNSIGNED_BYTE;
+        return true;
+    case GL_RGBA8:
+    case GL_SRGB8_ALPHA8:
+        format = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+        return true;
+    case GL_RGBA8_SNORM:
+        format = GL_RGBA;
+        type = GL_BYTE;
+        return true;
+    case GL_RGB10_A2:
+        format = GL_RGBA;
+        type = GL_UNSIGNED_INT_2_10_10_10_REV;
+        return true;
+    case GL_R16F:
+        format = GL_RED;
+        type = GL_HALF_FLOAT;
+        return true;
+    case GL_RG16F:
+        format = GL_RG;
+        type = GL_HALF_FLOAT;
+        return true;
+    case GL_RGBA16F:
+        format = GL_RGBA;
+        type = GL_HALF_FLOAT;
+        return true;
+    case GL_R32F:
+        format = GL_RED;
+        type = GL_FLOAT;
+        return true;
+    case GL_RG32F:
+        format = GL_RG;
+        type = GL_FLOAT;
+        return true;
+    case GL_RGBA32F:
+        format = GL_RGBA;
+        type = GL_FLOAT;
+        return true;
+    case GL_R32UI:
+        format = GL_RED_INTEGER;
+        type = GL_UNSIGNED_INT;
+        return true;
+    case GL_DEPTH_COMPONENT16:
+        format = GL_DEPTH_COMPONENT;
+        type = GL_UNSIGNED_SHORT;
+        return true;
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32:
+        format = GL_DEPTH_COMPONENT;
+        type = GL_UNSIGNED_INT;
+        return true;
+    case GL_DEPTH_COMPONENT32F:
+        format = GL_DEPTH_COMPONENT;
+        type = GL_FLOAT;
+        return true;
+    default:
+        return false;
+    }
+}
+inline size_t GetGLPixelSize(GLenum format, GLenum type) {
+    if (type == GL_UNSIGNED_INT_2_10_10_10_REV) {
+        return 4;
+    }
+    size_t componentCount = (format == GL_RGBA) ? 4 : (format == GL_RG) ? 2 : 1;
+    size_t componentSize = (type == GL_FLOAT || type == GL_UNSIGNED_INT) ? 4 : (type == GL_HALF_FLOAT || type == GL_UNSIGNED_SHORT) ? 2 : 1;
+    return componentCount * componentSize;
+}
 #pragma endregion
 
 void GLDebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam) {
@@ -473,6 +573,25 @@ XrSwapchainImageBaseHeader *GraphicsAPI_OpenGL::AllocateSwapchainImageData(XrSwa
 }
 // XR_DOCS_TAG_END_GraphicsAPI_OpenGL_AllocateSwapchainImageData
 
+void GraphicsAPI_OpenGL::RegisterSwapchainImages(XrSwapchain swapchain, const XrSwapchainCreateInfo &swapchainCI) {
+    ImageCreateInfo imageCI;
+    imageCI.dimension = 2;
+    imageCI.width = swapchainCI.width;
+    imageCI.height = swapchainCI.height;
+    imageCI.depth = 1;
+    imageCI.mipLevels = swapchainCI.mipCount;
+    imageCI.arrayLayers = swapchainCI.arraySize * swapchainCI.faceCount;
+    imageCI.sampleCount = swapchainCI.sampleCount;
+    imageCI.format = swapchainCI.format;
+    imageCI.cubemap = swapchainCI.faceCount == 6;
+    imageCI.colorAttachment = (swapchainCI.usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT) != 0;
+    imageCI.depthAttachment = (swapchainCI.usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0;
+    imageCI.sampled = (swapchainCI.usageFlags & XR_SWAPCHAIN_USAGE_SAMPLED_BIT) != 0;
+    for (const XrSwapchainImageOpenGLKHR &swapchainImage : swapchainImagesMap[swapchain].second) {
+        images[swapchainImage.image] = imageCI;
+    }
+}
+
 void *GraphicsAPI_OpenGL::CreateImage(const ImageCreateInfo &imageCI) {
     GLuint texture = 0;
     glGenTextures(1, &texture);
@@ -526,7 +645,9 @@ void *GraphicsAPI_OpenGL::CreateImageView(const ImageViewCreateInfo &imageViewCI
     if (imageViewCI.view == ImageViewCreateInfo::View::TYPE_2D_ARRAY) {
         glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, attachment, (GLuint)(uint64_t)imageViewCI.image, imageViewCI.baseMipLevel, imageViewCI.baseArrayLayer, imageViewCI.layerCount);
     } else if (imageViewCI.view == ImageViewCreateInfo::View::TYPE_2D) {
-        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, attachment, GL_TEXTURE_2D, (GLuint)(uint64_t)imageViewCI.image, imageViewCI.baseMipLevel);
+        // Multisampled images keep their own texture target.
+        const GLuint texture = (GLuint)(uint64_t)imageViewCI.image;
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, attachment, GetImageTarget(texture) == GL_TEXTURE_2D_MULTISAMPLE ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D, texture, imageViewCI.baseMipLevel);
     } else {
         DEBUG_BREAK;
         std::cout << "ERROR: OPENGL: Unknown ImageView View type." << std::endl;
@@ -597,20 +718,25 @@ void *GraphicsAPI_OpenGL::CreateBuffer(const BufferCreateInfo &bufferCI) {
     GLuint buffer = 0;
     glGenBuffers(1, &buffer);
 
-    GLenum target = 0;
-    if (bufferCI.type == BufferCreateInfo::Type::VERTEX) {
-        target = GL_ARRAY_BUFFER;
-    } else if (bufferCI.type == BufferCreateInfo::Type::INDEX) {
-        target = GL_ELEMENT_ARRAY_BUFFER;
-    } else if (bufferCI.type == BufferCreateInfo::Type::UNIFORM) {
-        target = GL_UNIFORM_BUFFER;
-    } else {
+    GLenum target = ToGLBufferTarget(bufferCI.type);
+    if (target == 0) {
         DEBUG_BREAK;
         std::cout << "ERROR: OPENGL: Unknown Buffer Type." << std::endl;
     }
 
+    // Staging buffers are rewritten by the CPU and read once by the GPU for each upload.
+    // Storage and indirect buffers are mostly written by the GPU, e.g. by compute shaders.
+    GLenum usage = GL_STATIC_DRAW;
+    if (bufferCI.type == BufferCreateInfo::Type::STAGING) {
+        usage = GL_STREAM_DRAW;
+    } else if (bufferCI.type == BufferCreateInfo::Type::STORAGE || bufferCI.type == BufferCreateInfo::Type::INDIRECT) {
+        usage = GL_DYNAMIC_COPY;
+    } else if (bufferCI.type == BufferCreateInfo::Type::READBACK) {
+        usage = GL_STREAM_READ;
+    }
+
     glBindBuffer(target, buffer);
-    glBufferData(target, (GLsizeiptr)bufferCI.size, bufferCI.data, GL_STATIC_DRAW);
+    glBufferData(target, (GLsizeiptr)bufferCI.size, bufferCI.data, usage);
     glBindBuffer(target, 0);
 
     buffers[buffer] = bufferCI;
@@ -707,8 +833,15 @@ void *GraphicsAPI_OpenGL::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
     }
 
     PFNGLDETACHSHADERPROC glDetachShader = (PFNGLDETACHSHADERPROC)GetExtension("glDetachShader");  // 2.0+
-    for (const void *const &shader : pipelineCI.shaders)
+    for (const void *const &shader : pipelineCI.shaders) {
+        // Compute pipelines have no fixed function state to set in SetPipeline().
+        GLint shaderType = 0;
+        glGetShaderiv((GLuint)(uint64_t)shader, GL_SHADER_TYPE, &shaderType);
+        if (shaderType == GL_COMPUTE_SHADER) {
+            computePipelines.insert(program);
+        }
         glDetachShader(program, (GLuint)(uint64_t)shader);
+    }
 
     pipelines[program] = pipelineCI;
 
@@ -718,6 +851,7 @@ void *GraphicsAPI_OpenGL::CreatePipeline(const PipelineCreateInfo &pipelineCI) {
 void GraphicsAPI_OpenGL::DestroyPipeline(void *&pipeline) {
     GLint program = (GLuint)(uint64_t)pipeline;
     pipelines.erase(program);
+    computePipelines.erase(program);
     glDeleteProgram(program);
     pipeline = nullptr;
 }
@@ -744,14 +878,8 @@ void GraphicsAPI_OpenGL::SetBufferData(void *buffer, size_t offset, size_t size,
     GLuint glBuffer = (GLuint)(uint64_t)buffer;
     const BufferCreateInfo &bufferCI = buffers[glBuffer];
 
-    GLenum target = 0;
-    if (bufferCI.type == BufferCreateInfo::Type::VERTEX) {
-        target = GL_ARRAY_BUFFER;
-    } else if (bufferCI.type == BufferCreateInfo::Type::INDEX) {
-        target = GL_ELEMENT_ARRAY_BUFFER;
-    } else if (bufferCI.type == BufferCreateInfo::Type::UNIFORM) {
-        target = GL_UNIFORM_BUFFER;
-    } else {
+    GLenum target = ToGLBufferTarget(bufferCI.type);
+    if (target == 0) {
         DEBUG_BREAK;
         std::cout << "ERROR: OPENGL: Unknown Buffer Type." << std::endl;
     }
@@ -763,6 +891,282 @@ void GraphicsAPI_OpenGL::SetBufferData(void *buffer, size_t offset, size_t size,
     }
 }
 
+void *GraphicsAPI_OpenGL::MapBuffer(void *buffer) {
+    GLuint glBuffer = (GLuint)(uint64_t)buffer;
+    const BufferCreateInfo &bufferCI = buffers[glBuffer];
+    GLenum target = ToGLBufferTarget(bufferCI.type);
+
+    // Readback buffers are mapped for reading, all others are mapped for writing and their previous contents are discarded.
+    GLbitfield access = bufferCI.type == BufferCreateInfo::Type::READBACK ? GL_MAP_READ_BIT : (GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(target, glBuffer);
+    void *data = glMapBufferRange(target, 0, (GLsizeiptr)bufferCI.size, access);
+    glBindBuffer(target, 0);
+    return data;
+}
+
+void GraphicsAPI_OpenGL::UnmapBuffer(void *buffer) {
+    GLuint glBuffer = (GLuint)(uint64_t)buffer;
+    GLenum target = ToGLBufferTarget(buffers[glBuffer].type);
+    glBindBuffer(target, glBuffer);
+    glUnmapBuffer(target);
+    glBindBuffer(target, 0);
+}
+
+void GraphicsAPI_OpenGL::CopyBuffer(void *srcBuffer, void *dstBuffer, size_t srcOffset, size_t dstOffset, size_t size) {
+    PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData = (PFNGLCOPYBUFFERSUBDATAPROC)GetExtension("glCopyBufferSubData");  // 3.1+
+    glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)(uint64_t)srcBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, (GLuint)(uint64_t)dstBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)srcOffset, (GLintptr)dstOffset, (GLsizeiptr)size);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+void GraphicsAPI_OpenGL::CopyBufferToImage(void *srcBuffer, void *dstImage, const BufferImageCopy &region) {
+    GLuint texture = (GLuint)(uint64_t)dstImage;
+    GLenum target = GetImageTarget(texture);
+    if (target == 0) {
+        return;
+    }
+    GLenum internalFormat = (GLenum)images[texture].format;
+
+    GLenum format = 0;
+    GLenum type = 0;
+    if (!ToGLPixelFormatAndType(internalFormat, format, type)) {
+        DEBUG_BREAK;
+        std::cout << "ERROR: OPENGL: Unsupported Image format for CopyBufferToImage()." << std::endl;
+        return;
+    }
+
+    // With a buffer bound to GL_PIXEL_UNPACK_BUFFER, the pixel pointer of glTexSubImage*() is an offset into that buffer.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)(uint64_t)srcBuffer);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)region.bufferRowLength);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, (GLint)region.bufferImageHeight);
+    glBindTexture(target, texture);
+
+    const ImageSubresourceLayers &subresource = region.imageSubresource;
+    const Offset3D &offset = region.imageOffset;
+    const Extent3D &extent = region.imageExtent;
+    const void *pixels = (const void *)region.bufferOffset;
+    if (target == GL_TEXTURE_2D) {
+        glTexSubImage2D(target, subresource.mipLevel, offset.x, offset.y, extent.width, extent.height, format, type, pixels);
+    } else if (target == GL_TEXTURE_1D_ARRAY) {
+        glTexSubImage2D(target, subresource.mipLevel, offset.x, subresource.baseArrayLayer, extent.width, subresource.layerCount, format, type, pixels);
+    } else if (target == GL_TEXTURE_3D) {
+        glTexSubImage3D(target, subresource.mipLevel, offset.x, offset.y, offset.z, extent.width, extent.height, extent.depth, format, type, pixels);
+    } else if (target == GL_TEXTURE_2D_ARRAY || target == GL_TEXTURE_CUBE_MAP_ARRAY) {
+        glTexSubImage3D(target, subresource.mipLevel, offset.x, offset.y, subresource.baseArrayLayer, extent.width, extent.height, subresource.layerCount, format, type, pixels);
+    } else if (target == GL_TEXTURE_CUBE_MAP) {
+        // Each face is uploaded separately from consecutive regions of the buffer.
+        uint32_t rowLength = region.bufferRowLength ? region.bufferRowLength : extent.width;
+        uint32_t imageHeight = region.bufferImageHeight ? region.bufferImageHeight : extent.height;
+        size_t faceSize = (size_t)rowLength * imageHeight * GetGLPixelSize(format, type);
+        for (uint32_t i = 0; i < subresource.layerCount; i++) {
+            GLenum face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + subresource.baseArrayLayer + i;
+            glTexSubImage2D(face, subresource.mipLevel, offset.x, offset.y, extent.width, extent.height, format, type, (const void *)(region.bufferOffset + faceSize * i));
+        }
+    } else {
+        DEBUG_BREAK;
+        std::cout << "ERROR: OPENGL: Unsupported Image type for CopyBufferToImage()." << std::endl;
+    }
+
+    glBindTexture(target, 0);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void GraphicsAPI_OpenGL::CopyImage(void *srcImage, void *dstImage, const ImageCopy &region) {
+    PFNGLCOPYIMAGESUBDATAPROC glCopyImageSubData = (PFNGLCOPYIMAGESUBDATAPROC)GetExtension("glCopyImageSubData");  // 4.3+
+    GLuint srcTexture = (GLuint)(uint64_t)srcImage;
+    GLuint dstTexture = (GLuint)(uint64_t)dstImage;
+    GLenum srcTarget = GetImageTarget(srcTexture);
+    GLenum dstTarget = GetImageTarget(dstTexture);
+    if (srcTarget == 0 || dstTarget == 0) {
+        return;
+    }
+
+    // For array and cube map textures the z coordinate selects the layer/face.
+    auto IsLayered = [](GLenum target) -> bool {
+        return target == GL_TEXTURE_2D_ARRAY || target == GL_TEXTURE_CUBE_MAP || target == GL_TEXTURE_CUBE_MAP_ARRAY || target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+    };
+    GLint srcZ = IsLayered(srcTarget) ? (GLint)region.srcSubresource.baseArrayLayer : region.srcOffset.z;
+    GLint dstZ = IsLayered(dstTarget) ? (GLint)region.dstSubresource.baseArrayLayer : region.dstOffset.z;
+    GLsizei depth = IsLayered(srcTarget) ? (GLsizei)region.srcSubresource.layerCount : (GLsizei)region.extent.depth;
+
+    glCopyImageSubData(srcTexture, srcTarget, region.srcSubresource.mipLevel, region.srcOffset.x, region.srcOffset.y, srcZ,
+                       dstTexture, dstTarget, region.dstSubresource.mipLevel, region.dstOffset.x, region.dstOffset.y, dstZ,
+                       region.extent.width, region.extent.height, depth);
+}
+
+void GraphicsAPI_OpenGL::BlitImage(void *srcImage, void *dstImage, const ImageBlit &region, SamplerCreateInfo::Filter filter) {
+    PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)GetExtension("glBlitFramebuffer");                        // 3.0+
+    PFNGLFRAMEBUFFERTEXTURELAYERPROC glFramebufferTextureLayer = (PFNGLFRAMEBUFFERTEXTURELAYERPROC)GetExtension("glFramebufferTextureLayer");  // 3.0+
+
+    GLuint srcTexture = (GLuint)(uint64_t)srcImage;
+    GLuint dstTexture = (GLuint)(uint64_t)dstImage;
+    GLenum srcTarget = GetImageTarget(srcTexture);
+    GLenum dstTarget = GetImageTarget(dstTexture);
+    if (srcTarget == 0 || dstTarget == 0) {
+        return;
+    }
+    bool depth = images.find(srcTexture) != images.end() && IsGLDepthFormat((GLenum)images[srcTexture].format);
+    GLenum attachment = depth ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0;
+    GLbitfield mask = depth ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT;
+
+    // Depth can only be blitted with nearest filtering.
+    GLenum glFilter = (depth || filter == SamplerCreateInfo::Filter::NEAREST) ? GL_NEAREST : GL_LINEAR;
+
+    GLuint framebuffers[2] = {0, 0};
+    glGenFramebuffers(2, framebuffers);
+
+    auto Attach = [&](GLenum framebufferTarget, GLenum target, GLuint texture, const ImageSubresourceLayers &subresource, uint32_t layer) {
+        if (target == GL_TEXTURE_2D || target == GL_TEXTURE_2D_MULTISAMPLE) {
+            glFramebufferTexture2D(framebufferTarget, attachment, target, texture, subresource.mipLevel);
+        } else {
+            glFramebufferTextureLayer(framebufferTarget, attachment, texture, subresource.mipLevel, subresource.baseArrayLayer + layer);
+        }
+    };
+
+    uint32_t layerCount = std::min(region.srcSubresource.layerCount, region.dstSubresource.layerCount);
+    for (uint32_t i = 0; i < std::max(layerCount, 1u); i++) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+        Attach(GL_READ_FRAMEBUFFER, srcTarget, srcTexture, region.srcSubresource, i);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+        Attach(GL_DRAW_FRAMEBUFFER, dstTarget, dstTexture, region.dstSubresource, i);
+
+        glBlitFramebuffer(region.srcOffsets[0].x, region.srcOffsets[0].y, region.srcOffsets[1].x, region.srcOffsets[1].y,
+                          region.dstOffsets[0].x, region.dstOffsets[0].y, region.dstOffsets[1].x, region.dstOffsets[1].y,
+                          mask, glFilter);
+    }
+
+    // Restore the framebuffer set by BeginRendering()/SetRenderAttachments().
+    glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
+    glDeleteFramebuffers(2, framebuffers);
+}
+
+void GraphicsAPI_OpenGL::CopyImageToBuffer(void *srcImage, void *dstBuffer, const BufferImageCopy &region) {
+    PFNGLGETTEXTURESUBIMAGEPROC glGetTextureSubImage = (PFNGLGETTEXTURESUBIMAGEPROC)GetExtension("glGetTextureSubImage");  // 4.5+
+
+    GLuint texture = (GLuint)(uint64_t)srcImage;
+    GLenum target = GetImageTarget(texture);
+    if (target == 0) {
+        return;
+    }
+    GLenum internalFormat = (GLenum)images[texture].format;
+
+    GLenum format = 0;
+    GLenum type = 0;
+    if (!ToGLPixelFormatAndType(internalFormat, format, type)) {
+        DEBUG_BREAK;
+        std::cout << "ERROR: OPENGL: Unsupported Image format for CopyImageToBuffer()." << std::endl;
+        return;
+    }
+
+    // With a buffer bound to GL_PIXEL_PACK_BUFFER, the pixel pointer is an offset into that buffer and the read does not stall the CPU.
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)(uint64_t)dstBuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, (GLint)region.bufferRowLength);
+    glPixelStorei(GL_PACK_IMAGE_HEIGHT, (GLint)region.bufferImageHeight);
+
+    const ImageSubresourceLayers &subresource = region.imageSubresource;
+    const Offset3D &offset = region.imageOffset;
+    const Extent3D &extent = region.imageExtent;
+    const size_t bufferSize = buffers[(GLuint)(uint64_t)dstBuffer].size - region.bufferOffset;
+    bool layered = target == GL_TEXTURE_2D_ARRAY || target == GL_TEXTURE_CUBE_MAP || target == GL_TEXTURE_CUBE_MAP_ARRAY || target == GL_TEXTURE_1D_ARRAY;
+    GLint z = layered ? (GLint)subresource.baseArrayLayer : offset.z;
+    GLsizei depth = layered ? (GLsizei)subresource.layerCount : (GLsizei)std::max(extent.depth, 1u);
+    if (target == GL_TEXTURE_1D_ARRAY && glGetTextureSubImage) {
+        glGetTextureSubImage(texture, subresource.mipLevel, offset.x, z, 0, extent.width, depth, 1, format, type, (GLsizei)bufferSize, (void *)region.bufferOffset);
+    } else if (target == GL_TEXTURE_1D_ARRAY) {
+        // Fallback for 1D array images: Read each layer as a row through a temporary framebuffer.
+        PFNGLFRAMEBUFFERTEXTURELAYERPROC glFramebufferTextureLayer = (PFNGLFRAMEBUFFERTEXTURELAYERPROC)GetExtension("glFramebufferTextureLayer");  // 3.0+
+        const size_t rowSize = (size_t)(region.bufferRowLength ? region.bufferRowLength : extent.width) * GetGLPixelSize(format, type);
+        GLuint framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        for (GLsizei layer = 0; layer < depth; layer++) {
+            glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, IsGLDepthFormat(internalFormat) ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0, texture, subresource.mipLevel, z + layer);
+            glReadPixels(offset.x, 0, extent.width, 1, format, type, (void *)(region.bufferOffset + layer * rowSize));
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+    } else if (glGetTextureSubImage) {
+        glGetTextureSubImage(texture, subresource.mipLevel, offset.x, offset.y, z, extent.width, extent.height, depth, format, type, (GLsizei)bufferSize, (void *)region.bufferOffset);
+    } else {
+        // Fallback for 2D images: Read through a temporary framebuffer.
+        GLuint framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, IsGLDepthFormat(internalFormat) ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, subresource.mipLevel);
+        glReadPixels(offset.x, offset.y, extent.width, extent.height, format, type, (void *)region.bufferOffset);
+        glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    glPixelStorei(GL_PACK_IMAGE_HEIGHT, 0);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void *GraphicsAPI_OpenGL::CreateFence() {
+    GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // Flush, so that the fence reaches the GPU and can be signaled even if it is only ever polled.
+    glFlush();
+    return (void *)sync;
+}
+
+void GraphicsAPI_OpenGL::DestroyFence(void *&fence) {
+    glDeleteSync((GLsync)fence);
+    fence = nullptr;
+}
+
+bool GraphicsAPI_OpenGL::WaitForFence(void *fence, uint64_t timeout) {
+    GLenum result = glClientWaitSync((GLsync)fence, 0, (GLuint64)timeout);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+void *GraphicsAPI_OpenGL::CreateTimestampQuery() {
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    return (void *)(uint64_t)query;
+}
+
+void GraphicsAPI_OpenGL::DestroyTimestampQuery(void *&query) {
+    GLuint glQuery = (GLuint)(uint64_t)query;
+    glDeleteQueries(1, &glQuery);
+    query = nullptr;
+}
+
+void GraphicsAPI_OpenGL::WriteTimestamp(void *query) {
+    PFNGLQUERYCOUNTERPROC glQueryCounter = (PFNGLQUERYCOUNTERPROC)GetExtension("glQueryCounter");  // 3.3+
+    glQueryCounter((GLuint)(uint64_t)query, GL_TIMESTAMP);
+}
+
+bool GraphicsAPI_OpenGL::GetTimestamp(void *query, uint64_t &timestamp) {
+    PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)GetExtension("glGetQueryObjectui64v");  // 3.3+
+    GLuint glQuery = (GLuint)(uint64_t)query;
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(glQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        return false;
+    }
+    GLuint64 result = 0;
+    glGetQueryObjectui64v(glQuery, GL_QUERY_RESULT, &result);
+    timestamp = (uint64_t)result;
+    return true;
+}
+
+bool GraphicsAPI_OpenGL::GetCurrentTimestamp(uint64_t &timestamp) {
+    PFNGLGETINTEGER64VPROC glGetInteger64v = (PFNGLGETINTEGER64VPROC)GetExtension("glGetInteger64v");  // 3.2+
+    GLint64 result = 0;
+    glGetInteger64v(GL_TIMESTAMP, &result);
+    timestamp = (uint64_t)result;
+    return true;
+}
+
 void GraphicsAPI_OpenGL::ClearColor(void *imageView, float r, float g, float b, float a) {
     glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)(uint64_t)imageView);
     glClearColor(r, g, b, a);
@@ -787,21 +1191,28 @@ void GraphicsAPI_OpenGL::SetRenderAttachments(void **colorViews, size_t colorVie
     glBindFramebuffer(GL_FRAMEBUFFER, setFramebuffer);
 
     // Color
+    std::vector<GLenum> drawBuffers;
     for (size_t i = 0; i < colorViewCount; i++) {
-        GLenum attachment = GL_COLOR_ATTACHMENT0;
+        GLenum attachment = GL_COLOR_ATTACHMENT0 + (GLenum)i;
 
         GLuint glColorView = (GLuint)(uint64_t)colorViews[i];
         const ImageViewCreateInfo &imageViewCI = imageViews[glColorView];
 
         if (imageViewCI.view == ImageViewCreateInfo::View::TYPE_2D_ARRAY) {
-            glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, (GLuint)(uint64_t)imageViewCI.image, imageViewCI.baseMipLevel, imageViewCI.baseArrayLayer, imageViewCI.layerCount);
+            glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, attachment, (GLuint)(uint64_t)imageViewCI.image, imageViewCI.baseMipLevel, imageViewCI.baseArrayLayer, imageViewCI.layerCount);
         } else if (imageViewCI.view == ImageViewCreateInfo::View::TYPE_2D) {
-            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, (GLuint)(uint64_t)imageViewCI.image, imageViewCI.baseMipLevel);
+            const GLuint texture = (GLuint)(uint64_t)imageViewCI.image;
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, attachment, GetImageTarget(texture) == GL_TEXTURE_2D_MULTISAMPLE ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D, texture, imageViewCI.baseMipLevel);
         } else {
             DEBUG_BREAK;
             std::cout << "ERROR: OPENGL: Unknown ImageView View type." << std::endl;
         }
+        drawBuffers.push_back(attachment);
+    }
+    if (drawBuffers.empty()) {
+        drawBuffers.push_back(GL_NONE);
     }
+    glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
     // DepthStencil
     if (depthStencilView) {
         GLuint glDepthView = (GLuint)(uint64_t)depthStencilView;
@@ -810,7 +1221,8 @@ void GraphicsAPI_OpenGL::SetRenderAttachments(void **colorViews, size_t colorVie
         if (imageViewCI.view == ImageViewCreateInfo::View::TYPE_2D_ARRAY) {
             glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, (GLuint)(uint64_t)imageViewCI.image, imageViewCI.baseMipLevel, imageViewCI.baseArrayLayer, imageViewCI.layerCount);
         } else if (imageViewCI.view == ImageViewCreateInfo::View::TYPE_2D) {
-            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, (GLuint)(uint64_t)imageViewCI.image, imageViewCI.baseMipLevel);
+            const GLuint texture = (GLuint)(uint64_t)imageViewCI.image;
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GetImageTarget(texture) == GL_TEXTURE_2D_MULTISAMPLE ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D, texture, imageViewCI.baseMipLevel);
         } else {
             DEBUG_BREAK;
             std::cout << "ERROR: OPENGL: Unknown ImageView View type." << std::endl;
@@ -849,6 +1261,10 @@ void GraphicsAPI_OpenGL::SetPipeline(void *pipeline) {
     glUseProgram(program);
     setPipeline = program;
 
+    if (computePipelines.find(program) != computePipelines.end()) {
+        return;
+    }
+
     const PipelineCreateInfo &pipelineCI = pipelines[program];
 
     // InputAssemblyState
@@ -1050,10 +1466,12 @@ void GraphicsAPI_OpenGL::SetDescriptor(const DescriptorInfo &descriptorInfo) {
     const GLuint &bindingIndex = descriptorInfo.bindingIndex;
     if (descriptorInfo.type == DescriptorInfo::Type::BUFFER) {
         PFNGLBINDBUFFERRANGEPROC glBindBufferRange = (PFNGLBINDBUFFERRANGEPROC)GetExtension("glBindBufferRange");  // 3.0+
-        glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, glResource, (GLintptr)descriptorInfo.bufferOffset, (GLsizeiptr)descriptorInfo.bufferSize);
+        // Uniform buffers bind to the uniform block bindings, all other buffer types bind to the shader storage block bindings.
+        GLenum target = buffers[glResource].type == BufferCreateInfo::Type::UNIFORM ? GL_UNIFORM_BUFFER : GL_SHADER_STORAGE_BUFFER;
+        glBindBufferRange(target, bindingIndex, glResource, (GLintptr)descriptorInfo.bufferOffset, (GLsizeiptr)descriptorInfo.bufferSize);
     } else if (descriptorInfo.type == DescriptorInfo::Type::IMAGE) {
         glActiveTexture(GL_TEXTURE0 + bindingIndex);
-        glBindTexture(GetGLTextureTarget(images[glResource]), glResource);
+        glBindTexture(GetImageTarget(glResource), glResource);
     } else if (descriptorInfo.type == DescriptorInfo::Type::SAMPLER) {
         PFNGLBINDSAMPLERPROC glBindSampler = (PFNGLBINDSAMPLERPROC)GetExtension("glBindSampler");  // 3.0+
         glBindSampler(bindingIndex, glResource);
@@ -1115,6 +1533,80 @@ void GraphicsAPI_OpenGL::Draw(uint32_t vertexCount, uint32_t instanceCount, uint
     glDrawArraysInstancedBaseInstance(ToGLTopology(pipelines[setPipeline].inputAssemblyState.topology), firstVertex, vertexCount, instanceCount, firstInstance);
 }
 
+void GraphicsAPI_OpenGL::DrawIndexedIndirect(void *argumentBuffer, size_t offset, uint32_t drawCount, uint32_t stride) {
+    PFNGLMULTIDRAWELEMENTSINDIRECTPROC glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)GetExtension("glMultiDrawElementsIndirect");  // 4.3+
+    GLenum indexType = buffers[setIndexBuffer].stride == 4 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, (GLuint)(uint64_t)argumentBuffer);
+    glMultiDrawElementsIndirect(ToGLTopology(pipelines[setPipeline].inputAssemblyState.topology), indexType, (const void *)offset, (GLsizei)drawCount, (GLsizei)stride);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GraphicsAPI_OpenGL::DrawIndexedIndirectCount(void *argumentBuffer, size_t offset, void *countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride) {
+    PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC glMultiDrawElementsIndirectCount = (PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC)GetExtension("glMultiDrawElementsIndirectCount");  // 4.6+
+    if (!glMultiDrawElementsIndirectCount) {
+        glMultiDrawElementsIndirectCount = (PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC)GetExtension("glMultiDrawElementsIndirectCountARB");  // ARB_indirect_parameters
+    }
+    if (!glMultiDrawElementsIndirectCount) {
+        // Fallback: Read the draw count back to the CPU. This stalls until the GPU has written the count.
+        uint32_t drawCount = 0;
+        glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)(uint64_t)countBuffer);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, (GLintptr)countOffset, sizeof(uint32_t), &drawCount);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        DrawIndexedIndirect(argumentBuffer, offset, std::min(drawCount, maxDrawCount), stride);
+        return;
+    }
+
+    GLenum indexType = buffers[setIndexBuffer].stride == 4 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, (GLuint)(uint64_t)argumentBuffer);
+    glBindBuffer(GL_PARAMETER_BUFFER, (GLuint)(uint64_t)countBuffer);
+    glMultiDrawElementsIndirectCount(ToGLTopology(pipelines[setPipeline].inputAssemblyState.topology), indexType, (const void *)offset, (GLintptr)countOffset, (GLsizei)maxDrawCount, (GLsizei)stride);
+    glBindBuffer(GL_PARAMETER_BUFFER, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GraphicsAPI_OpenGL::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+    PFNGLDISPATCHCOMPUTEPROC glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)GetExtension("glDispatchCompute");  // 4.3+
+    PFNGLMEMORYBARRIERPROC glMemoryBarrier = (PFNGLMEMORYBARRIERPROC)GetExtension("glMemoryBarrier");          // 4.2+
+    glDispatchCompute(groupCountX, groupCountY, groupCountZ);
+    // Make the compute shader's writes visible to subsequent indirect draws, vertex fetches, uniform/storage reads and texture fetches.
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+std::string GraphicsAPI_OpenGL::GetDeviceName() {
+    // The version string of most drivers ends with the driver's own version.
+    const GLubyte *vendor = glGetString(GL_VENDOR);
+    const GLubyte *renderer = glGetString(GL_RENDERER);
+    const GLubyte *version = glGetString(GL_VERSION);
+    std::stringstream name;
+    name << (vendor ? (const char *)vendor : "") << " " << (renderer ? (const char *)renderer : "") << " " << (version ? (const char *)version : "");
+    return name.str();
+}
+
+bool GraphicsAPI_OpenGL::IsMultiviewSupported() {
+    PFNGLGETSTRINGIPROC glGetStringi = (PFNGLGETSTRINGIPROC)GetExtension("glGetStringi");  // 3.0+
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; i++) {
+        const GLubyte *extension = glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension && strcmp((const char *)extension, "GL_OVR_multiview2") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+GLenum GraphicsAPI_OpenGL::GetImageTarget(GLuint texture) {
+    std::unordered_map<GLuint, ImageCreateInfo>::const_iterator imageIt = images.find(texture);
+    if (imageIt == images.end()) {
+        DEBUG_BREAK;
+        std::cout << "ERROR: OPENGL: Unknown texture " << texture << ". Swapchain images must be registered with RegisterSwapchainImages()." << std::endl;
+        return 0;
+    }
+    GLenum target = GetGLTextureTarget(imageIt->second);
+    // See CreateImage(): GL_TEXTURE_1D images are allocated as GL_TEXTURE_2D with a height of 1.
+    return target == GL_TEXTURE_1D ? GL_TEXTURE_2D : target;
+}
+
 // XR_DOCS_TAG_BEGIN_GraphicsAPI_OpenGL_GetSupportedSwapchainFormats
 const std::vector<int64_t> GraphicsAPI_OpenGL::GetSupportedColorSwapchainFormats() {
     // https://github.com/KhronosGroup/OpenXR-SDK-Source/blob/f122f9f1fc729e2dc82e12c3ce73efa875182854/src/tests/hello_xr/graphicsplugin_opengl.cpp#L229-L236
@@ -23,10 +23,21 @@ public:
     // XR_DOCS_TAG_BEGIN_GetDepthFormat_OpenGL
     virtual int64_t GetDepthFormat() override { return (int64_t)GL_DEPTH_COMPONENT32F; }
     // XR_DOCS_TAG_END_GetDepthFormat_OpenGL
+    virtual int64_t GetMotionVectorFormat() override { return (int64_t)GL_RG16F; }
+    virtual int64_t GetHDRColorFormat() override { return (int64_t)GL_RGBA16F; }
+    virtual int64_t GetColorFormat() override { return (int64_t)GL_RGBA8; }
+    virtual int64_t GetVideoLumaFormat() override { return (int64_t)GL_R8; }
+    virtual int64_t GetVideoChromaFormat() override { return (int64_t)GL_RG8; }
+
+    virtual std::string GetDeviceName() override;
+    virtual bool IsMultiviewSupported() override;
 
     virtual void* GetGraphicsBinding() override;
     virtual XrSwapchainImageBaseHeader* AllocateSwapchainImageData(XrSwapchain swapchain, SwapchainType type, uint32_t count) override;
     virtual void FreeSwapchainImageData(XrSwapchain swapchain) override {
+        for (const XrSwapchainImageOpenGLKHR& swapchainImage : swapchainImagesMap[swapchain].second) {
+            images.erase(swapchainImage.image);
+        }
         swapchainImagesMap[swapchain].second.clear();
         swapchainImagesMap.erase(swapchain);
     }
@@ -34,6 +45,7 @@ public:
     // XR_DOCS_TAG_BEGIN_GetSwapchainImage_OpenGL
     virtual void* GetSwapchainImage(XrSwapchain swapchain, uint32_t index) override { return (void*)(uint64_t)swapchainImagesMap[swapchain].second[index].image; }
     // XR_DOCS_TAG_END_GetSwapchainImage_OpenGL
+    virtual void RegisterSwapchainImages(XrSwapchain swapchain, const XrSwapchainCreateInfo& swapchainCI) override;
 
     virtual void* CreateImage(const ImageCreateInfo& imageCI) override;
     virtual void DestroyImage(void*& image) override;
@@ -57,6 +69,24 @@ public:
     virtual void EndRendering() override;
 
     virtual void SetBufferData(void* buffer, size_t offset, size_t size, void* data) override;
+    virtual void* MapBuffer(void* buffer) override;
+    virtual void UnmapBuffer(void* buffer) override;
+
+    virtual void CopyBuffer(void* srcBuffer, void* dstBuffer, size_t srcOffset, size_t dstOffset, size_t size) override;
+    virtual void CopyBufferToImage(void* srcBuffer, void* dstImage, const BufferImageCopy& region) override;
+    virtual void CopyImage(void* srcImage, void* dstImage, const ImageCopy& region) override;
+    virtual void BlitImage(void* srcImage, void* dstImage, const ImageBlit& region, SamplerCreateInfo::Filter filter) override;
+    virtual void CopyImageToBuffer(void* srcImage, void* dstBuffer, const BufferImageCopy& region) override;
+
+    virtual void* CreateFence() override;
+    virtual void DestroyFence(void*& fence) override;
+    virtual bool WaitForFence(void* fence, uint64_t timeout) override;
+
+    virtual void* CreateTimestampQuery() override;
+    virtual void DestroyTimestampQuery(void*& query) override;
+    virtual void WriteTimestamp(void* query) override;
+    virtual bool GetTimestamp(void* query, uint64_t& timestamp) override;
+    virtual bool GetCurrentTimestamp(uint64_t& timestamp) override;
 
     virtual void ClearColor(void* imageView, float r, float g, float b, float a) override;
     virtual void ClearDepth(void* imageView, float d) override;
@@ -72,11 +102,17 @@ public:
     virtual void SetIndexBuffer(void* indexBuffer) override;
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0) override;
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) override;
+    virtual void DrawIndexedIndirect(void* argumentBuffer, size_t offset, uint32_t drawCount, uint32_t stride) override;
+    virtual void DrawIndexedIndirectCount(void* argumentBuffer, size_t offset, void* countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride) override;
+    virtual void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) override;
 
 private:
     virtual const std::vector<int64_t> GetSupportedColorSwapchainFormats() override;
     virtual const std::vector<int64_t> GetSupportedDepthSwapchainFormats() override;
 
+    // Returns 0 for textures that were neither created through CreateImage() nor registered with RegisterSwapchainImages().
+    GLenum GetImageTarget(GLuint texture);
+
 private:
     ksGpuWindow window{};
 
@@ -99,6 +135,7 @@ private:
 
     GLuint setFramebuffer = 0;
     std::unordered_map<GLuint, PipelineCreateInfo> pipelines{};
+    std::unordered_set<GLuint> computePipelines{};
     GLuint setPipeline = 0;
     GLuint vertexArray = 0;
     GLuint setIndexBuffer = 0;
@@ -0,0 +1,160 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <HalfResolutionTransparency.h>
+
+// GLSL 4.50 fragment shaders.
+static const char *depthDownsampleShaderSource = R"(
+#version 450
+layout(binding = 0) uniform sampler2D fullDepth;
+
+void main() {
+    ivec2 base = ivec2(gl_FragCoord.xy) * 2;
+    ivec2 maxTexel = textureSize(fullDepth, 0) - 1;
+    float d0 = texelFetch(fullDepth, min(base, maxTexel), 0).r;
+    float d1 = texelFetch(fullDepth, min(base + ivec2(1, 0), maxTexel), 0).r;
+    float d2 = texelFetch(fullDepth, min(base + ivec2(0, 1), maxTexel), 0).r;
+    float d3 = texelFetch(fullDepth, min(base + ivec2(1, 1), maxTexel), 0).r;
+    gl_FragDepth = max(max(d0, d1), max(d2, d3));
+}
+)";
+
+static const char *bilateralUpsampleShaderSource = R"(
+#version 450
+layout(location = 0) out vec4 o_Color;
+
+layout(binding = 0) uniform sampler2D halfColor;
+layout(binding = 1) uniform sampler2D halfDepth;
+layout(binding = 2) uniform sampler2D fullDepth;
+layout(std140, binding = 3) uniform UpsampleUniforms {
+    float nearZ;
+    float farZ;
+    float depthSigma;
+};
+
+float LinearDepth(float depth) {
+    float z = depth * 2.0 - 1.0;
+    return (2.0 * nearZ * farZ) / (farZ + nearZ - z * (farZ - nearZ));
+}
+
+void main() {
+    ivec2 fullTexel = ivec2(gl_FragCoord.xy);
+    float depth = LinearDepth(texelFetch(fullDepth, fullTexel, 0).r);
+
+    // The four half resolution texels around this pixel and their bilinear weights.
+    vec2 halfPosition = (vec2(fullTexel) + 0.5) * 0.5 - 0.5;
+    ivec2 base = ivec2(floor(halfPosition));
+    vec2 f = halfPosition - vec2(base);
+    ivec2 maxTexel = textureSize(halfColor, 0) - 1;
+    const ivec2 offsets[4] = ivec2[4](ivec2(0, 0), ivec2(1, 0), ivec2(0, 1), ivec2(1, 1));
+    float bilinearWeights[4] = float[4]((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y), (1.0 - f.x) * f.y, f.x * f.y);
+
+    vec4 color = vec4(0.0);
+    float totalWeight = 0.0;
+    vec4 nearestColor = vec4(0.0);
+    float nearestDifference = 1e30;
+    for (int i = 0; i < 4; i++) {
+        ivec2 texel = clamp(base + offsets[i], ivec2(0), maxTexel);
+        vec4 sampleColor = texelFetch(halfColor, texel, 0);
+        float difference = abs(LinearDepth(texelFetch(halfDepth, texel, 0).r) - depth) / depth;
+        float weight = bilinearWeights[i] * exp(-difference / depthSigma);
+        color += sampleColor * weight;
+        totalWeight += weight;
+        if (difference < nearestDifference) {
+            nearestDifference = difference;
+            nearestColor = sampleColor;
+        }
+    }
+
+    // If no texel matches the depth, fall back to the texel with the closest depth.
+    o_Color = totalWeight > 1e-4 ? color / totalWeight : nearestColor;
+}
+)";
+
+HalfResolutionTransparency::HalfResolutionTransparency(GraphicsAPI *graphicsAPI, uint32_t width, uint32_t height, int64_t colorFormat, int64_t depthFormat, int64_t targetColorFormat)
+    : m_graphicsAPI(graphicsAPI), m_halfWidth((width + 1) / 2), m_halfHeight((height + 1) / 2) {
+    m_colorImage = m_graphicsAPI->CreateImage({2, m_halfWidth, m_halfHeight, 1, 1, 1, 1, colorFormat, false, true, false, true});
+    m_colorImageView = m_graphicsAPI->CreateImageView({m_colorImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+    m_depthImage = m_graphicsAPI->CreateImage({2, m_halfWidth, m_halfHeight, 1, 1, 1, 1, depthFormat, false, false, true, true});
+    m_depthImageView = m_graphicsAPI->CreateImageView({m_depthImage, GraphicsAPI::ImageViewCreateInfo::Type::DSV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, depthFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::DEPTH_BIT, 0, 1, 0, 1});
+
+    GraphicsAPI::SamplerCreateInfo samplerCI{};
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.mipmapMode = GraphicsAPI::SamplerCreateInfo::MipmapMode::NOOP;
+    samplerCI.addressModeS = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeT = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeR = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.compareOp = GraphicsAPI::CompareOp::NEVER;
+    m_sampler = m_graphicsAPI->CreateSampler(samplerCI);
+    m_uniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(UpsampleUniforms), nullptr});
+
+    m_downsamplePass = std::make_unique<FullscreenPass>(m_graphicsAPI, depthDownsampleShaderSource, std::vector<int64_t>{},
+                                                        std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}},
+                                                        nullptr, depthFormat);
+    const GraphicsAPI::ColorBlendAttachmentState blendState = FullscreenPass::GetPremultipliedAlphaBlendState();
+    m_upsamplePass = std::make_unique<FullscreenPass>(m_graphicsAPI, bilateralUpsampleShaderSource, std::vector<int64_t>{targetColorFormat},
+                                                      std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                               {1, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                               {2, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                               {3, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}},
+                                                      &blendState);
+}
+
+HalfResolutionTransparency::~HalfResolutionTransparency() {
+    m_upsamplePass.reset();
+    m_downsamplePass.reset();
+    m_graphicsAPI->DestroyBuffer(m_uniformBuffer);
+    m_graphicsAPI->DestroySampler(m_sampler);
+    m_graphicsAPI->DestroyImageView(m_depthImageView);
+    m_graphicsAPI->DestroyImage(m_depthImage);
+    m_graphicsAPI->DestroyImageView(m_colorImageView);
+    m_graphicsAPI->DestroyImage(m_colorImage);
+}
+
+void HalfResolutionTransparency::Begin(void *opaqueDepthImage, uint32_t width, uint32_t height) {
+    m_activeHalfWidth = std::min((width + 1) / 2, m_halfWidth);
+    m_activeHalfHeight = std::min((height + 1) / 2, m_halfHeight);
+
+    // Downsample the opaque depth.
+    m_graphicsAPI->SetRenderAttachments(nullptr, 0, m_depthImageView, m_halfWidth, m_halfHeight, m_downsamplePass->GetPipeline());
+    SetRenderTargetState(m_activeHalfWidth, m_activeHalfHeight);
+    m_graphicsAPI->SetPipeline(m_downsamplePass->GetPipeline());
+    m_graphicsAPI->SetDescriptor({0, opaqueDepthImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({0, m_sampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->UpdateDescriptors();
+    m_downsamplePass->Draw();
+
+    // Clear to transparent black, which is the identity for premultiplied alpha blending.
+    m_graphicsAPI->ClearColor(m_colorImageView, 0.0f, 0.0f, 0.0f, 0.0f);
+    m_graphicsAPI->SetRenderAttachments(&m_colorImageView, 1, m_depthImageView, m_halfWidth, m_halfHeight, nullptr);
+    SetRenderTargetState(m_activeHalfWidth, m_activeHalfHeight);
+}
+
+void HalfResolutionTransparency::Composite(void *colorImageView, void *opaqueDepthImage, uint32_t width, uint32_t height, float nearZ, float farZ) {
+    // Depths within 10% of each other count as the same surface.
+    UpsampleUniforms uniforms = {nearZ, farZ, 0.1f, 0.0f};
+    m_graphicsAPI->SetBufferData(m_uniformBuffer, 0, sizeof(UpsampleUniforms), &uniforms);
+
+    m_graphicsAPI->SetRenderAttachments(&colorImageView, 1, nullptr, width, height, m_upsamplePass->GetPipeline());
+    SetRenderTargetState(width, height);
+    m_graphicsAPI->SetPipeline(m_upsamplePass->GetPipeline());
+    void *images[3] = {m_colorImage, m_depthImage, opaqueDepthImage};
+    for (uint32_t i = 0; i < 3; i++) {
+        m_graphicsAPI->SetDescriptor({i, images[i], GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+        m_graphicsAPI->SetDescriptor({i, m_sampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    }
+    m_graphicsAPI->SetDescriptor({3, m_uniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT, false, 0, sizeof(UpsampleUniforms)});
+    m_graphicsAPI->UpdateDescriptors();
+    m_upsamplePass->Draw();
+}
+
+void HalfResolutionTransparency::SetRenderTargetState(uint32_t width, uint32_t height) {
+    GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f};
+    GraphicsAPI::Rect2D scissor = {{0, 0}, {width, height}};
+    m_graphicsAPI->SetViewports(&viewport, 1);
+    m_graphicsAPI->SetScissors(&scissor, 1);
+}
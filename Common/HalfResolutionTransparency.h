@@ -0,0 +1,57 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <FullscreenPass.h>
+
+// Renders transparent content, e.g. particles and glass, at half resolution in each dimension, which quarters its fill
+// rate cost, and composites it over the full resolution opaque image.
+//
+// Per view, after the opaque content:
+//  1. Begin(): Downsamples the opaque depth, keeping the farthest depth of each 2x2 block, clears the half resolution color
+//     and sets both as the render attachments.
+//  2. Draw the transparent content with depth testing, without depth writes and with premultiplied alpha blending.
+//  3. Composite(): Upsamples with a depth aware bilateral filter, which only uses half resolution texels whose depth matches
+//     the full resolution pixel, so that transparency does not bleed across opaque edges. Blends over the view's color.
+class HalfResolutionTransparency {
+public:
+    // colorFormat is the half resolution accumulation format. It should be a float format with an alpha channel, e.g.
+    // GL_RGBA16F, as 8 and 10 bit formats band and clamp the premultiplied accumulation. targetColorFormat is the format
+    // of the views. width and height are the largest full resolution.
+    HalfResolutionTransparency(GraphicsAPI* graphicsAPI, uint32_t width, uint32_t height, int64_t colorFormat, int64_t depthFormat, int64_t targetColorFormat);
+    ~HalfResolutionTransparency();
+
+    void Begin(void* opaqueDepthImage, uint32_t width, uint32_t height);
+    void Composite(void* colorImageView, void* opaqueDepthImage, uint32_t width, uint32_t height, float nearZ, float farZ);
+
+    uint32_t GetWidth() const { return m_halfWidth; }
+    uint32_t GetHeight() const { return m_halfHeight; }
+
+private:
+    struct UpsampleUniforms {
+        float nearZ;
+        float farZ;
+        float depthSigma;
+        float pad;
+    };
+
+    void SetRenderTargetState(uint32_t width, uint32_t height);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    uint32_t m_halfWidth = 0;
+    uint32_t m_halfHeight = 0;
+    uint32_t m_activeHalfWidth = 0;
+    uint32_t m_activeHalfHeight = 0;
+
+    void* m_colorImage = nullptr;
+    void* m_colorImageView = nullptr;
+    void* m_depthImage = nullptr;
+    void* m_depthImageView = nullptr;
+    void* m_sampler = nullptr;
+    void* m_uniformBuffer = nullptr;
+    std::unique_ptr<FullscreenPass> m_downsamplePass;
+    std::unique_ptr<FullscreenPass> m_upsamplePass;
+};
@@ -0,0 +1,115 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <IdleTaskScheduler.h>
+
+// xrWaitFrame() returning within this time, in seconds, after the tasks counts as an overrun.
+static constexpr float overrunThreshold = 0.0002f;
+
+IdleTaskScheduler::IdleTaskScheduler(const CreateInfo &createInfo)
+    : m_createInfo(createInfo) {
+}
+
+IdleTaskScheduler::TaskHandle IdleTaskScheduler::AddTask(const std::string &name, Task task, bool recurring) {
+    const TaskHandle taskHandle = m_nextTaskHandle++;
+    m_tasks.push_back({taskHandle, name, std::move(task), recurring, m_createInfo.initialStepDuration, false});
+    return taskHandle;
+}
+
+void IdleTaskScheduler::RemoveTask(TaskHandle taskHandle) {
+    for (auto it = m_tasks.begin(); it != m_tasks.end(); ++it) {
+        if (it->handle == taskHandle) {
+            m_tasks.erase(it);
+            return;
+        }
+    }
+}
+
+void IdleTaskScheduler::RunIdleTasks() {
+    const Clock::time_point begin = Clock::now();
+    m_statistics.stepsRun = 0;
+    m_statistics.stepsDeferred = 0;
+    m_taskTime = 0.0f;
+
+    // Until the first frames have been measured, there is no window to use.
+    float idleWindow = 0.0f;
+    if (!m_idleWindows.empty()) {
+        idleWindow = m_idleWindows.front();
+        for (float window : m_idleWindows) {
+            idleWindow = std::min(idleWindow, window);
+        }
+    }
+    m_statistics.idleWindowMs = idleWindow * 1000.0f;
+    const float budget = idleWindow * m_createInfo.windowFraction - m_createInfo.safetyMargin;
+
+    // Round robin over the tasks: each pass gives every task at most one step, so that a long task cannot starve the
+    // others. A task whose step does not fit is skipped, as a shorter one further on may still fit. Tasks that finish are
+    // moved out of the first eligible tasks, so that recurring tasks run again in the next frame's window only.
+    // The estimate of a deferred task decays once per frame, in the first pass.
+    size_t eligible = budget > 0.0f ? m_tasks.size() : 0;
+    bool progress = true;
+    bool firstPass = true;
+    while (progress && eligible > 0) {
+        progress = false;
+        for (size_t i = 0; i < eligible;) {
+            TaskInfo &taskInfo = m_tasks[i];
+            const float remaining = budget - Seconds(Clock::now() - begin);
+            if (taskInfo.stepDuration > remaining) {
+                if (firstPass) {
+                    taskInfo.stepDuration *= m_createInfo.deferralDecay;
+                }
+                m_statistics.stepsDeferred++;
+                i++;
+                continue;
+            }
+
+            const Clock::time_point stepBegin = Clock::now();
+            const bool moreWork = taskInfo.task();
+            const float stepDuration = Seconds(Clock::now() - stepBegin);
+            taskInfo.stepDuration = taskInfo.measured ? taskInfo.stepDuration * 0.8f + stepDuration * 0.2f : stepDuration;
+            taskInfo.measured = true;
+            m_statistics.stepsRun++;
+            progress = true;
+
+            if (!moreWork) {
+                TaskInfo finished = std::move(taskInfo);
+                m_tasks.erase(m_tasks.begin() + i);
+                eligible--;
+                if (finished.recurring) {
+                    m_tasks.push_back(std::move(finished));
+                }
+                continue;
+            }
+            i++;
+        }
+        firstPass = false;
+    }
+
+    m_taskTime = Seconds(Clock::now() - begin);
+    m_statistics.taskTimeMs = m_taskTime * 1000.0f;
+    m_statistics.pendingTasks = static_cast<uint32_t>(m_tasks.size());
+}
+
+void IdleTaskScheduler::BeginWait() {
+    m_waitBegin = Clock::now();
+}
+
+void IdleTaskScheduler::EndWait() {
+    const float waitTime = Seconds(Clock::now() - m_waitBegin);
+    m_statistics.waitTimeMs = waitTime * 1000.0f;
+    if (m_statistics.stepsRun > 0 && waitTime < overrunThreshold) {
+        m_statistics.overruns++;
+    }
+
+    m_idleWindows.push_back(m_taskTime + waitTime);
+    while (m_idleWindows.size() > m_createInfo.windowHistory) {
+        m_idleWindows.pop_front();
+    }
+}
+
+float IdleTaskScheduler::Seconds(Clock::duration duration) {
+    return std::chrono::duration<float>(duration).count();
+}
@@ -0,0 +1,90 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <HelperFunctions.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+
+// Runs small background tasks on the frame thread in the time it would otherwise spend blocked in xrWaitFrame().
+//
+// The idle window of a frame is the time spent in RunIdleTasks() plus the time spent in xrWaitFrame(). Before the wait,
+// RunIdleTasks() estimates the next window from the shortest of the recent windows, minus a safety margin, and runs
+// tasks until their estimated durations no longer fit. Tasks are preemptible between steps: a task does one small step
+// of work per call and returns true while it has more work, e.g. one streaming callback or one deferred destruction.
+// Its step duration is learned, so a step that does not fit the remaining window waits for a later frame. The estimate
+// decays in every frame in which the step is deferred, so that a task whose estimate was inflated by one slow step, or
+// whose step only fits the longest windows, still runs eventually.
+//
+// As long as the tasks finish before the runtime would have released xrWaitFrame(), they only shorten the wait and
+// the frame starts at the same time.
+class IdleTaskScheduler {
+public:
+    struct CreateInfo {
+        uint32_t windowHistory = 8;        // Frames over which the shortest idle window is taken.
+        float windowFraction = 0.8f;       // Of the estimated window that tasks may use.
+        float safetyMargin = 0.001f;       // Seconds, subtracted from the usable window.
+        float initialStepDuration = 0.0005f;  // Seconds, assumed for a task's steps until it has been measured.
+        float deferralDecay = 0.9f;           // Applied to a task's step duration in each frame in which it is deferred.
+    };
+
+    struct Statistics {
+        float idleWindowMs;      // The estimated window of the last frame.
+        float taskTimeMs;        // Spent in tasks during the last frame.
+        float waitTimeMs;        // Spent in xrWaitFrame() during the last frame.
+        uint32_t stepsRun;       // During the last frame.
+        uint32_t stepsDeferred;  // Steps that did not fit the remaining window during the last frame.
+        uint32_t pendingTasks;
+        // Frames in which xrWaitFrame() returned almost immediately after the tasks, so the tasks may have delayed the
+        // frame start.
+        uint32_t overruns;
+    };
+
+    typedef uint64_t TaskHandle;
+    // Does one step of work. Returns true while the task has more work.
+    typedef std::function<bool()> Task;
+
+    IdleTaskScheduler(const CreateInfo& createInfo);
+
+    // A recurring task stays scheduled after it returns false, and runs again in the next frame's window.
+    // Tasks may add tasks, but must not remove any.
+    TaskHandle AddTask(const std::string& name, Task task, bool recurring = false);
+    void RemoveTask(TaskHandle taskHandle);
+
+    // Call immediately before xrWaitFrame().
+    void RunIdleTasks();
+    // Bracket xrWaitFrame().
+    void BeginWait();
+    void EndWait();
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct TaskInfo {
+        TaskHandle handle;
+        std::string name;
+        Task task;
+        bool recurring;
+        float stepDuration;  // Exponential moving average, in seconds.
+        bool measured;
+    };
+
+    static float Seconds(Clock::duration duration);
+
+    CreateInfo m_createInfo;
+    Statistics m_statistics{};
+
+    std::deque<TaskInfo> m_tasks;
+    TaskHandle m_nextTaskHandle = 1;
+
+    std::deque<float> m_idleWindows;  // In seconds.
+    float m_taskTime = 0.0f;
+    Clock::time_point m_waitBegin;
+};
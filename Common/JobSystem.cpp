@@ -0,0 +1,114 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <JobSystem.h>
+
+JobSystem::JobSystem(uint32_t threadCount) {
+    if (threadCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    for (uint32_t i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&JobSystem::WorkerThread, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    m_jobAvailable.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void JobSystem::Submit(Job job) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob &job) {
+    if (count == 0) {
+        return;
+    }
+    batchSize = std::max(batchSize, 1u);
+    const uint32_t batchCount = (count + batchSize - 1) / batchSize;
+    if (batchCount == 1) {
+        job(0, count);
+        return;
+    }
+
+    // Workers and the calling thread pull batches from a shared counter until none are left.
+    struct SharedState {
+        std::atomic<uint32_t> nextBatch{0};
+        std::atomic<uint32_t> completedBatches{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<SharedState> state = std::make_shared<SharedState>();
+
+    auto RunBatches = [state, count, batchSize, batchCount, &job]() {
+        uint32_t batch = 0;
+        while ((batch = state->nextBatch.fetch_add(1)) < batchCount) {
+            const uint32_t begin = batch * batchSize;
+            job(begin, std::min(begin + batchSize, count));
+            if (state->completedBatches.fetch_add(1) + 1 == batchCount) {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    const uint32_t helperCount = std::min(GetThreadCount(), batchCount - 1);
+    for (uint32_t i = 0; i < helperCount; i++) {
+        Submit(RunBatches);
+    }
+    RunBatches();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->completedBatches.load() == batchCount; });
+}
+
+void JobSystem::Wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobsFinished.wait(lock, [this]() { return m_jobs.empty() && m_activeJobs == 0; });
+}
+
+JobSystem &JobSystem::Get() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+void JobSystem::WorkerThread() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this]() { return m_exit || !m_jobs.empty(); });
+            if (m_exit && m_jobs.empty()) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_activeJobs++;
+        }
+
+        job();
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_activeJobs--;
+            if (m_jobs.empty() && m_activeJobs == 0) {
+                m_jobsFinished.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <HelperFunctions.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// A fixed size pool of worker threads that run jobs from a shared FIFO queue.
+class JobSystem {
+public:
+    typedef std::function<void()> Job;
+    typedef std::function<void(uint32_t begin, uint32_t end)> RangeJob;
+
+    // A threadCount of 0 uses one worker per hardware thread, minus one for the calling thread.
+    JobSystem(uint32_t threadCount = 0);
+    ~JobSystem();
+
+    // Queues a job to be run by a worker thread.
+    void Submit(Job job);
+
+    // Splits [0, count) into batches of batchSize and runs them on the workers and the calling thread.
+    // Returns once all batches have completed.
+    void ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job);
+
+    // Blocks until the queue is empty and no job is running.
+    void Wait();
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_threads.size()); }
+
+    // A process wide instance, created on first use.
+    static JobSystem& Get();
+
+private:
+    void WorkerThread();
+
+    std::vector<std::thread> m_threads;
+    std::deque<Job> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_jobsFinished;
+    uint32_t m_activeJobs = 0;
+    bool m_exit = false;
+};
@@ -0,0 +1,89 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <JustInTimeFrameStart.h>
+
+#include <algorithm>
+#include <thread>
+
+// Frames are learned from once they are this many frames old, after their GPU timestamps have been read back.
+// A frame without a recorded GPU completion by then is skipped.
+static constexpr uint64_t learningDelay = 8;
+
+JustInTimeFrameStart::JustInTimeFrameStart(const CreateInfo &createInfo)
+    : m_createInfo(createInfo), m_safetyMargin(createInfo.minSafetyMargin) {
+}
+
+void JustInTimeFrameStart::Update(const FrameTrace &frameTrace) {
+    const std::deque<FrameTrace::Frame> &frames = frameTrace.GetFrames();
+    if (frames.empty() || frames.back().index < learningDelay) {
+        return;
+    }
+    const uint64_t lastFrameIndex = frames.back().index - learningDelay;
+
+    bool learned = false;
+    for (const FrameTrace::Frame &frame : frames) {
+        if (frame.index < m_nextFrameIndex || frame.gpuCompleteTime == 0) {
+            continue;
+        }
+        if (frame.index > lastFrameIndex) {
+            break;
+        }
+
+        m_costs.push_back(float(frame.gpuCompleteTime - frame.workStartTime) * 1e-9f);
+        if (m_costs.size() > m_createInfo.historyFrames) {
+            m_costs.pop_front();
+        }
+        if (frame.gpuCompleteTime > GetDeadline(frame, m_createInfo.compositorPeriods)) {
+            m_safetyMargin = std::min(m_safetyMargin * m_createInfo.lateBackoff, m_createInfo.maxSafetyMargin);
+            m_statistics.lateFrames++;
+        } else {
+            m_safetyMargin = std::max(m_safetyMargin * m_createInfo.marginDecay, m_createInfo.minSafetyMargin);
+        }
+        m_statistics.learnedFrames++;
+        learned = true;
+    }
+    m_nextFrameIndex = lastFrameIndex + 1;
+
+    if (learned) {
+        std::vector<float> costs(m_costs.begin(), m_costs.end());
+        std::sort(costs.begin(), costs.end());
+        auto Percentile = [&costs](float p) -> float { return costs[std::min(costs.size() - 1, size_t(p * float(costs.size())))]; };
+        m_costModel = Percentile(m_createInfo.costPercentile);
+        m_statistics.costP50Ms = Percentile(0.5f) * 1000.0f;
+        m_statistics.costModelMs = m_costModel * 1000.0f;
+    }
+    m_statistics.safetyMarginMs = m_safetyMargin * 1000.0f;
+}
+
+void JustInTimeFrameStart::Wait(FrameTrace &frameTrace) {
+    const std::deque<FrameTrace::Frame> &frames = frameTrace.GetFrames();
+    m_statistics.sleepMs = 0.0f;
+
+    // Until a quarter of the history has been learned, the frame starts right away. Without a correlated display time,
+    // the deadline is unknown.
+    if (!frames.empty() && frameTrace.IsXrTimeCorrelated() && m_costs.size() >= m_createInfo.historyFrames / 4) {
+        const FrameTrace::Frame &frame = frames.back();
+        const int64_t latestStart = GetDeadline(frame, m_createInfo.compositorPeriods) - int64_t(double(m_costModel + m_safetyMargin + m_oversleep) * 1e9);
+        const int64_t sleepBegin = FrameTrace::GetMonotonicTime();
+        if (latestStart > sleepBegin) {
+            // Never sleep for more than a display period, whatever the model says.
+            std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(latestStart - sleepBegin, int64_t(frame.predictedDisplayPeriod))));
+            const int64_t sleepEnd = FrameTrace::GetMonotonicTime();
+            const float oversleep = std::max(float(sleepEnd - latestStart) * 1e-9f, 0.0f);
+            m_oversleep = m_oversleep * 0.9f + oversleep * 0.1f;
+            m_statistics.sleepMs = float(sleepEnd - sleepBegin) * 1e-6f;
+        }
+    }
+    m_statistics.averageSleepMs = m_statistics.averageSleepMs * 0.95f + m_statistics.sleepMs * 0.05f;
+    m_statistics.oversleepMs = m_oversleep * 1000.0f;
+
+    frameTrace.BeginWork();
+}
+
+int64_t JustInTimeFrameStart::GetDeadline(const FrameTrace::Frame &frame, float compositorPeriods) {
+    return frame.predictedDisplayTime - int64_t(double(frame.predictedDisplayPeriod) * double(compositorPeriods));
+}
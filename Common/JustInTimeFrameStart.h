@@ -0,0 +1,67 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <FrameTrace.h>
+
+// Just-in-time frame start: xrWaitFrame() returns early enough for the most expensive frames, so a cheap frame that
+// starts right away samples its poses earlier than it needs to. Wait() sleeps after xrWaitFrame() until the latest safe
+// start time, so that xrLocateViews() predicts over a shorter horizon.
+//
+// The cost model is a high percentile of the recent frames' times from the start of their CPU work to the completion of
+// their GPU work, as recorded by a FrameTrace. The GPU work has to complete compositorPeriods display periods before the
+// predicted display time, for the compositor. The latest safe start is that deadline minus the modeled cost, a safety
+// margin and the measured oversleep of the OS. Frames that miss the deadline grow the safety margin, which decays back
+// while frames are on time.
+class JustInTimeFrameStart {
+public:
+    struct CreateInfo {
+        uint32_t historyFrames = 90;
+        float costPercentile = 0.95f;
+        float compositorPeriods = 1.0f;
+        // In seconds.
+        float minSafetyMargin = 0.002f;
+        float maxSafetyMargin = 0.008f;
+        float lateBackoff = 1.5f;     // Safety margin multiplier for a late frame.
+        float marginDecay = 0.995f;   // Safety margin multiplier for an on time frame.
+    };
+
+    struct Statistics {
+        uint32_t learnedFrames;
+        uint32_t lateFrames;
+        // The learned model, in milliseconds.
+        float costP50Ms;
+        float costModelMs;  // At costPercentile.
+        float safetyMarginMs;
+        float oversleepMs;
+        // The sleep delays xrLocateViews() and so reduces the pose age at display by the same time.
+        float sleepMs;         // Of the last frame.
+        float averageSleepMs;  // Exponential moving average.
+    };
+
+    JustInTimeFrameStart(const CreateInfo& createInfo);
+
+    // Learns from the frames whose GPU completion has been recorded since the last call.
+    void Update(const FrameTrace& frameTrace);
+
+    // Call after xrWaitFrame() and FrameTrace::BeginFrame(). Sleeps until the latest safe start of the frame, and then
+    // calls FrameTrace::BeginWork().
+    void Wait(FrameTrace& frameTrace);
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+private:
+    static int64_t GetDeadline(const FrameTrace::Frame& frame, float compositorPeriods);
+
+    CreateInfo m_createInfo;
+    Statistics m_statistics{};
+
+    std::deque<float> m_costs;  // In seconds.
+    float m_costModel = 0.0f;
+    float m_safetyMargin = 0.0f;
+    float m_oversleep = 0.0f;
+    uint64_t m_nextFrameIndex = 0;
+};
@@ -0,0 +1,252 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <Meshlets.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define XR_TUTORIAL_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+static XrVector3f GetPosition(const float *positions, size_t positionStride, uint32_t index) {
+    const float *p = reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(positions) + positionStride * index);
+    return {p[0], p[1], p[2]};
+}
+
+// Ritter's bounding sphere: Start with the two most distant points found by two sweeps, then grow to include all points.
+static void ComputeBoundingSphere(const std::vector<XrVector3f> &points, XrVector3f &center, float &radius) {
+    auto DistanceSquared = [](const XrVector3f &a, const XrVector3f &b) -> float {
+        XrVector3f d;
+        XrVector3f_Sub(&d, &a, &b);
+        return XrVector3f_Dot(&d, &d);
+    };
+    auto Farthest = [&](const XrVector3f &from) -> const XrVector3f & {
+        size_t farthest = 0;
+        for (size_t i = 1; i < points.size(); i++) {
+            if (DistanceSquared(points[i], from) > DistanceSquared(points[farthest], from)) {
+                farthest = i;
+            }
+        }
+        return points[farthest];
+    };
+
+    const XrVector3f &a = Farthest(points[0]);
+    const XrVector3f &b = Farthest(a);
+    XrVector3f_Lerp(&center, &a, &b, 0.5f);
+    radius = sqrtf(DistanceSquared(a, b)) * 0.5f;
+
+    for (const XrVector3f &point : points) {
+        const float distance = sqrtf(DistanceSquared(point, center));
+        if (distance > radius) {
+            const float newRadius = (radius + distance) * 0.5f;
+            XrVector3f direction;
+            XrVector3f_Sub(&direction, &point, &center);
+            XrVector3f_Scale(&direction, &direction, (newRadius - radius) / distance);
+            XrVector3f_Add(&center, &center, &direction);
+            radius = newRadius;
+        }
+    }
+}
+
+static void ComputeNormalCone(const std::vector<XrVector3f> &normals, XrVector3f &coneAxis, float &coneCutoff) {
+    XrVector3f_Set(&coneAxis, 0.0f);
+    for (const XrVector3f &normal : normals) {
+        XrVector3f_Add(&coneAxis, &coneAxis, &normal);
+    }
+    XrVector3f_Normalize(&coneAxis);
+
+    float minDot = 1.0f;
+    for (const XrVector3f &normal : normals) {
+        minDot = std::min(minDot, XrVector3f_Dot(&normal, &coneAxis));
+    }
+
+    // If the normals spread over more than ~84 degrees from the axis, the cone rarely culls anything.
+    if (normals.empty() || minDot <= 0.1f) {
+        coneCutoff = 1.0f;
+    } else {
+        coneCutoff = sqrtf(1.0f - minDot * minDot);
+    }
+}
+
+MeshletMesh BuildMeshlets(const float *positions, size_t vertexCount, size_t positionStride, const uint32_t *indices, size_t indexCount, uint32_t maxVertices, uint32_t maxTriangles) {
+    MeshletMesh mesh;
+    mesh.indices.reserve(indexCount);
+
+    // Maps a vertex index to the meshlet that last used it, to count unique vertices per meshlet.
+    std::vector<uint32_t> vertexMeshlet(vertexCount, ~0u);
+    std::vector<XrVector3f> points;
+    std::vector<XrVector3f> normals;
+
+    Meshlet meshlet{};
+    auto FinishMeshlet = [&]() {
+        if (meshlet.indexCount == 0) {
+            return;
+        }
+        ComputeBoundingSphere(points, meshlet.center, meshlet.radius);
+        ComputeNormalCone(normals, meshlet.coneAxis, meshlet.coneCutoff);
+        mesh.meshlets.push_back(meshlet);
+
+        meshlet = {};
+        meshlet.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+        points.clear();
+        normals.clear();
+    };
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        const uint32_t triangle[3] = {indices[i + 0], indices[i + 1], indices[i + 2]};
+        const uint32_t meshletIndex = static_cast<uint32_t>(mesh.meshlets.size());
+
+        uint32_t newVertexCount = 0;
+        for (uint32_t index : triangle) {
+            newVertexCount += (vertexMeshlet[index] != meshletIndex) ? 1 : 0;
+        }
+        if (meshlet.vertexCount + newVertexCount > maxVertices || meshlet.indexCount / 3 + 1 > maxTriangles) {
+            FinishMeshlet();
+        }
+
+        const uint32_t currentMeshlet = static_cast<uint32_t>(mesh.meshlets.size());
+        for (uint32_t index : triangle) {
+            if (vertexMeshlet[index] != currentMeshlet) {
+                vertexMeshlet[index] = currentMeshlet;
+                points.push_back(GetPosition(positions, positionStride, index));
+                meshlet.vertexCount++;
+            }
+            mesh.indices.push_back(index);
+        }
+        meshlet.indexCount += 3;
+
+        XrVector3f p0 = GetPosition(positions, positionStride, triangle[0]);
+        XrVector3f p1 = GetPosition(positions, positionStride, triangle[1]);
+        XrVector3f p2 = GetPosition(positions, positionStride, triangle[2]);
+        XrVector3f e1, e2, normal;
+        XrVector3f_Sub(&e1, &p1, &p0);
+        XrVector3f_Sub(&e2, &p2, &p0);
+        XrVector3f_Cross(&normal, &e1, &e2);
+        if (XrVector3f_Length(&normal) > 0.0f) {
+            XrVector3f_Normalize(&normal);
+            normals.push_back(normal);
+        }
+    }
+    FinishMeshlet();
+
+    return mesh;
+}
+
+MeshletCuller::MeshletCuller(const std::vector<Meshlet> &meshlets)
+    : m_meshletCount(static_cast<uint32_t>(meshlets.size())) {
+    const size_t paddedCount = Align<size_t>(meshlets.size(), 4);
+    for (std::vector<float> *array : {&m_centerX, &m_centerY, &m_centerZ, &m_radius, &m_coneAxisX, &m_coneAxisY, &m_coneAxisZ, &m_coneCutoff}) {
+        array->resize(paddedCount, 0.0f);
+    }
+    m_firstIndices.resize(meshlets.size());
+    m_indexCounts.resize(meshlets.size());
+
+    for (size_t i = 0; i < meshlets.size(); i++) {
+        const Meshlet &meshlet = meshlets[i];
+        m_firstIndices[i] = meshlet.firstIndex;
+        m_indexCounts[i] = meshlet.indexCount;
+        m_centerX[i] = meshlet.center.x;
+        m_centerY[i] = meshlet.center.y;
+        m_centerZ[i] = meshlet.center.z;
+        m_radius[i] = meshlet.radius;
+        m_coneAxisX[i] = meshlet.coneAxis.x;
+        m_coneAxisY[i] = meshlet.coneAxis.y;
+        m_coneAxisZ[i] = meshlet.coneAxis.z;
+        m_coneCutoff[i] = meshlet.coneCutoff;
+    }
+}
+
+void MeshletCuller::CullRange(const MeshletCullView *views, uint32_t viewCount, uint32_t begin, uint32_t end, uint8_t *visible) const {
+#if defined(XR_TUTORIAL_USE_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    for (uint32_t i = begin; i < end; i += 4) {
+        const __m128 centerX = _mm_loadu_ps(&m_centerX[i]);
+        const __m128 centerY = _mm_loadu_ps(&m_centerY[i]);
+        const __m128 centerZ = _mm_loadu_ps(&m_centerZ[i]);
+        const __m128 radius = _mm_loadu_ps(&m_radius[i]);
+        const __m128 negRadius = _mm_sub_ps(zero, radius);
+
+        __m128 anyViewVisible = zero;
+        for (uint32_t v = 0; v < viewCount; v++) {
+            const MeshletCullView &view = views[v];
+
+            // Frustum: The sphere is outside if it is fully behind any plane.
+            __m128 inside = _mm_cmpeq_ps(zero, zero);
+            for (uint32_t p = 0; p < 6; p++) {
+                const float *plane = view.frustumPlanes[p];
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), centerX), _mm_mul_ps(_mm_set1_ps(plane[1]), centerY)),
+                                             _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), centerZ), _mm_set1_ps(plane[3])));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+            }
+
+            // Normal cone: Culled if all triangles face away from this view.
+            const __m128 dx = _mm_sub_ps(centerX, _mm_set1_ps(view.position.x));
+            const __m128 dy = _mm_sub_ps(centerY, _mm_set1_ps(view.position.y));
+            const __m128 dz = _mm_sub_ps(centerZ, _mm_set1_ps(view.position.z));
+            const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(&m_coneAxisX[i])), _mm_mul_ps(dy, _mm_loadu_ps(&m_coneAxisY[i]))), _mm_mul_ps(dz, _mm_loadu_ps(&m_coneAxisZ[i])));
+            const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+            const __m128 backfacing = _mm_cmpge_ps(dot, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_coneCutoff[i]), length), radius));
+
+            anyViewVisible = _mm_or_ps(anyViewVisible, _mm_andnot_ps(backfacing, inside));
+        }
+
+        const int mask = _mm_movemask_ps(anyViewVisible);
+        for (uint32_t j = 0; j < 4 && i + j < end; j++) {
+            visible[i + j] = (mask >> j) & 1;
+        }
+    }
+#else
+    for (uint32_t i = begin; i < end; i++) {
+        bool anyViewVisible = false;
+        for (uint32_t v = 0; v < viewCount && !anyViewVisible; v++) {
+            const MeshletCullView &view = views[v];
+
+            bool inside = true;
+            for (uint32_t p = 0; p < 6 && inside; p++) {
+                const float *plane = view.frustumPlanes[p];
+                inside = plane[0] * m_centerX[i] + plane[1] * m_centerY[i] + plane[2] * m_centerZ[i] + plane[3] >= -m_radius[i];
+            }
+
+            const float dx = m_centerX[i] - view.position.x;
+            const float dy = m_centerY[i] - view.position.y;
+            const float dz = m_centerZ[i] - view.position.z;
+            const float dot = dx * m_coneAxisX[i] + dy * m_coneAxisY[i] + dz * m_coneAxisZ[i];
+            const bool backfacing = dot >= m_coneCutoff[i] * sqrtf(dx * dx + dy * dy + dz * dz) + m_radius[i];
+
+            anyViewVisible = inside && !backfacing;
+        }
+        visible[i] = anyViewVisible ? 1 : 0;
+    }
+#endif
+}
+
+void MeshletCuller::Cull(const MeshletCullView *views, uint32_t viewCount, int32_t vertexOffset, uint32_t firstInstance, std::vector<GraphicsAPI::DrawIndexedIndirectCommand> &drawCommands, JobSystem *jobSystem) {
+    std::vector<uint8_t> visible(m_meshletCount, 0);
+
+    // Batches are multiples of 4 meshlets, so that each SSE group is within one batch.
+    const uint32_t batchSize = 256;
+    auto CullBatch = [&](uint32_t begin, uint32_t end) {
+        CullRange(views, viewCount, begin, end, visible.data());
+    };
+    if (jobSystem) {
+        jobSystem->ParallelFor(m_meshletCount, batchSize, CullBatch);
+    } else {
+        CullBatch(0, m_meshletCount);
+    }
+
+    // Emit one index range per visible meshlet. Adjacent visible meshlets are merged into one draw.
+    const size_t firstDrawCommand = drawCommands.size();
+    for (uint32_t i = 0; i < m_meshletCount; i++) {
+        if (!visible[i]) {
+            continue;
+        }
+        if (drawCommands.size() > firstDrawCommand && visible[i - 1] && drawCommands.back().firstIndex + drawCommands.back().indexCount == m_firstIndices[i]) {
+            drawCommands.back().indexCount += m_indexCounts[i];
+        } else {
+            drawCommands.push_back({m_indexCounts[i], 1, m_firstIndices[i], vertexOffset, firstInstance});
+        }
+    }
+}
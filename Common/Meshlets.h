@@ -0,0 +1,71 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+#include <JobSystem.h>
+#include <xr_linear_algebra.h>
+
+// Meshlets (clusters) split a large mesh into small groups of triangles, so that parts of the mesh can be culled individually.
+// BuildMeshlets() reorders a triangle list so that each meshlet is a contiguous index range of the returned index buffer,
+// which is drawn with the original vertex buffer.
+struct Meshlet {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t vertexCount;
+
+    // Bounding sphere in object space.
+    XrVector3f center;
+    float radius;
+
+    // Normal cone: All triangles face away from a viewer at p if dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius.
+    // A coneCutoff of 1 disables cone culling, e.g. for meshlets with widely spread normals.
+    XrVector3f coneAxis;
+    float coneCutoff;
+};
+
+struct MeshletMesh {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> indices;
+};
+
+static constexpr uint32_t meshletMaxVertices = 64;
+static constexpr uint32_t meshletMaxTriangles = 124;
+
+// Builds meshlets from an indexed triangle list. positions has a stride of positionStride bytes.
+MeshletMesh BuildMeshlets(const float* positions, size_t vertexCount, size_t positionStride, const uint32_t* indices, size_t indexCount,
+                          uint32_t maxVertices = meshletMaxVertices, uint32_t maxTriangles = meshletMaxTriangles);
+
+// Per view data for culling, in the meshlets' object space.
+struct MeshletCullView {
+    float frustumPlanes[6][4];
+    XrVector3f position;
+};
+
+// Culls meshlets against the frusta and normal cones of the views. Stores the meshlet culling data as structure of arrays,
+// so that four meshlets are tested at once with SSE where available.
+class MeshletCuller {
+public:
+    MeshletCuller(const std::vector<Meshlet>& meshlets);
+
+    // Appends an indirect draw command for each meshlet visible in at least one view.
+    // The work is split into batches on the JobSystem; the output order is the meshlet order.
+    void Cull(const MeshletCullView* views, uint32_t viewCount, int32_t vertexOffset, uint32_t firstInstance, std::vector<GraphicsAPI::DrawIndexedIndirectCommand>& drawCommands, JobSystem* jobSystem = nullptr);
+
+    uint32_t GetMeshletCount() const { return m_meshletCount; }
+
+private:
+    // Culls meshlets [begin, end), where begin is a multiple of 4. Writes 1 to visible[i] for visible meshlets.
+    void CullRange(const MeshletCullView* views, uint32_t viewCount, uint32_t begin, uint32_t end, uint8_t* visible) const;
+
+    uint32_t m_meshletCount = 0;
+    std::vector<uint32_t> m_firstIndices;
+    std::vector<uint32_t> m_indexCounts;
+
+    // Structure of arrays, padded to a multiple of 4.
+    std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+    std::vector<float> m_coneAxisX, m_coneAxisY, m_coneAxisZ, m_coneCutoff;
+};
@@ -0,0 +1,196 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <PerfCounters.h>
+
+#include <sstream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PerfCounters::PerfCounters() {
+#if defined(__linux__)
+    struct CounterConfig {
+        uint32_t type;
+        uint64_t config;
+    };
+    const CounterConfig counterConfigs[COUNTER_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    };
+
+    // The first counter that opens leads the group. Counters that fail to open are left out.
+    for (uint32_t i = 0; i < COUNTER_COUNT; i++) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = counterConfigs[i].type;
+        attr.config = counterConfigs[i].config;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_hv = 1;
+        // Context switches happen in the kernel. Count them there if permitted, and only user space otherwise.
+        int fd = -1;
+        for (uint32_t excludeKernel = (attr.type == PERF_TYPE_SOFTWARE ? 0 : 1); excludeKernel <= 1 && fd < 0; excludeKernel++) {
+            attr.exclude_kernel = excludeKernel;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, m_groupFd, 0));
+        }
+        if (fd < 0) {
+            continue;
+        }
+        if (m_groupFd < 0) {
+            m_groupFd = fd;
+        }
+        m_valueIndices[i] = static_cast<int32_t>(m_fds.size());
+        m_fds.push_back(fd);
+    }
+
+    if (m_groupFd < 0) {
+        std::cout << "WARNING: PerfCounters: perf_event_open() failed. Check /proc/sys/kernel/perf_event_paranoid. Hardware counters are disabled." << std::endl;
+        return;
+    }
+    for (uint32_t i = 0; i < COUNTER_COUNT; i++) {
+        if (m_valueIndices[i] < 0) {
+            std::cout << "WARNING: PerfCounters: " << GetCounterName(Counter(i)) << " is unavailable." << std::endl;
+        }
+    }
+    ioctl(m_groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+    std::cout << "WARNING: PerfCounters: Hardware counters are only supported on Linux." << std::endl;
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    // Close the members before the leader.
+    for (auto it = m_fds.rbegin(); it != m_fds.rend(); ++it) {
+        close(*it);
+    }
+#endif
+}
+
+const char *PerfCounters::GetCounterName(Counter counter) {
+    switch (counter) {
+    case CYCLES:
+        return "Cycles";
+    case INSTRUCTIONS:
+        return "Instructions";
+    case LLC_MISSES:
+        return "LLC Misses";
+    case BRANCH_MISSES:
+        return "Branch Misses";
+    case CONTEXT_SWITCHES:
+        return "Context Switches";
+    default:
+        return "Unknown";
+    }
+}
+
+PerfCounters::PhaseHandle PerfCounters::GetPhase(const std::string &name) {
+    for (size_t i = 0; i < m_phases.size(); i++) {
+        if (m_phases[i].name == name) {
+            return static_cast<PhaseHandle>(i);
+        }
+    }
+    Phase phase{};
+    phase.name = name;
+    m_phases.push_back(phase);
+    return static_cast<PhaseHandle>(m_phases.size() - 1);
+}
+
+void PerfCounters::BeginPhase(PhaseHandle phase) {
+    if (IsAvailable()) {
+        Read(m_phases[phase].begin);
+    }
+}
+
+void PerfCounters::EndPhase(PhaseHandle phase) {
+    double values[COUNTER_COUNT];
+    if (!IsAvailable() || !Read(values)) {
+        return;
+    }
+    Phase &p = m_phases[phase];
+    for (uint32_t i = 0; i < COUNTER_COUNT; i++) {
+        p.totals[i] += values[i] - p.begin[i];
+    }
+    p.samples++;
+}
+
+std::vector<PerfCounters::PhaseStatistics> PerfCounters::GetStatistics() const {
+    std::vector<PhaseStatistics> statistics;
+    for (const Phase &phase : m_phases) {
+        PhaseStatistics phaseStatistics{};
+        phaseStatistics.name = phase.name;
+        phaseStatistics.samples = phase.samples;
+        memcpy(phaseStatistics.totals, phase.totals, sizeof(phase.totals));
+        const double cycles = phase.totals[CYCLES];
+        const double kiloInstructions = phase.totals[INSTRUCTIONS] * 1e-3;
+        if (IsCounterAvailable(CYCLES) && IsCounterAvailable(INSTRUCTIONS) && cycles > 0.0) {
+            phaseStatistics.instructionsPerCycle = static_cast<float>(phase.totals[INSTRUCTIONS] / cycles);
+        }
+        if (IsCounterAvailable(INSTRUCTIONS) && kiloInstructions > 0.0) {
+            phaseStatistics.llcMissesPerKiloInstruction = IsCounterAvailable(LLC_MISSES) ? static_cast<float>(phase.totals[LLC_MISSES] / kiloInstructions) : 0.0f;
+            phaseStatistics.branchMissesPerKiloInstruction = IsCounterAvailable(BRANCH_MISSES) ? static_cast<float>(phase.totals[BRANCH_MISSES] / kiloInstructions) : 0.0f;
+        }
+        if (phase.samples > 0) {
+            phaseStatistics.contextSwitchesPerSample = static_cast<float>(phase.totals[CONTEXT_SWITCHES] / static_cast<double>(phase.samples));
+        }
+        statistics.push_back(phaseStatistics);
+    }
+    return statistics;
+}
+
+void PerfCounters::Reset() {
+    for (Phase &phase : m_phases) {
+        phase.samples = 0;
+        memset(phase.totals, 0, sizeof(phase.totals));
+    }
+}
+
+std::string PerfCounters::GetStatisticsJSON() const {
+    std::stringstream json;
+    json << "{";
+    bool first = true;
+    for (const PhaseStatistics &phase : GetStatistics()) {
+        json << (first ? "" : ",") << "\"" << phase.name << "\":{\"samples\":" << phase.samples;
+        for (uint32_t i = 0; i < COUNTER_COUNT; i++) {
+            if (IsCounterAvailable(Counter(i))) {
+                json << ",\"" << GetCounterName(Counter(i)) << "\":" << static_cast<uint64_t>(phase.totals[i]);
+            }
+        }
+        json << ",\"ipc\":" << phase.instructionsPerCycle << ",\"llcMissesPerKiloInstruction\":" << phase.llcMissesPerKiloInstruction
+             << ",\"branchMissesPerKiloInstruction\":" << phase.branchMissesPerKiloInstruction << ",\"contextSwitchesPerSample\":" << phase.contextSwitchesPerSample << "}";
+        first = false;
+    }
+    json << "}";
+    return json.str();
+}
+
+bool PerfCounters::Read(double *values) const {
+#if defined(__linux__)
+    // PERF_FORMAT_GROUP with the total times: nr, time_enabled, time_running, values[nr].
+    uint64_t data[3 + COUNTER_COUNT] = {};
+    const ssize_t size = read(m_groupFd, data, sizeof(data));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[0] != m_fds.size()) {
+        return false;
+    }
+    // Scale up for the time the group was multiplexed off the counters.
+    const double scale = data[2] > 0 ? static_cast<double>(data[1]) / static_cast<double>(data[2]) : 1.0;
+    for (uint32_t i = 0; i < COUNTER_COUNT; i++) {
+        values[i] = m_valueIndices[i] >= 0 ? static_cast<double>(data[3 + m_valueIndices[i]]) * scale : 0.0;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,96 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <HelperFunctions.h>
+
+// Samples hardware performance counters of the calling thread around named phases of the frame loop, to tell why a
+// phase took its time: IPC, cache misses and branch misses per thousand instructions, and context switches.
+//
+// The counters are read with perf_event_open() on Linux and Android, as a single group, so one read() per phase boundary
+// samples all of them at once. Counters the CPU or the permissions do not provide, e.g. with
+// /proc/sys/kernel/perf_event_paranoid above 2 or in a virtual machine, are left out and reported as unavailable.
+// Without any counter, e.g. on other platforms, all calls are no-ops.
+//
+// Only the calling thread is counted, so work that a phase hands to a JobSystem is not included.
+class PerfCounters {
+public:
+    enum Counter : uint32_t {
+        CYCLES,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        CONTEXT_SWITCHES,
+        COUNTER_COUNT
+    };
+
+    struct PhaseStatistics {
+        std::string name;
+        uint64_t samples;
+        double totals[COUNTER_COUNT];
+        // Derived from the totals. 0 if a counter is unavailable.
+        float instructionsPerCycle;
+        float llcMissesPerKiloInstruction;
+        float branchMissesPerKiloInstruction;
+        float contextSwitchesPerSample;
+    };
+
+    typedef uint32_t PhaseHandle;
+
+    // RAII helper that brackets a scope with BeginPhase() and EndPhase().
+    class Scope {
+    public:
+        Scope(PerfCounters* perfCounters, PhaseHandle phase)
+            : m_perfCounters(perfCounters), m_phase(phase) {
+            if (m_perfCounters) {
+                m_perfCounters->BeginPhase(m_phase);
+            }
+        }
+        ~Scope() {
+            if (m_perfCounters) {
+                m_perfCounters->EndPhase(m_phase);
+            }
+        }
+
+    private:
+        PerfCounters* m_perfCounters;
+        PhaseHandle m_phase;
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    bool IsAvailable() const { return m_groupFd >= 0; }
+    bool IsCounterAvailable(Counter counter) const { return m_valueIndices[counter] >= 0; }
+    static const char* GetCounterName(Counter counter);
+
+    // Returns the handle of the named phase, creating it on first use. Phases may nest, but a phase must not be begun
+    // again before it has ended.
+    PhaseHandle GetPhase(const std::string& name);
+    void BeginPhase(PhaseHandle phase);
+    void EndPhase(PhaseHandle phase);
+
+    std::vector<PhaseStatistics> GetStatistics() const;
+    void Reset();
+
+    // The statistics as a JSON object, keyed by phase name, for trace exports.
+    std::string GetStatisticsJSON() const;
+
+private:
+    struct Phase {
+        std::string name;
+        uint64_t samples;
+        double begin[COUNTER_COUNT];
+        double totals[COUNTER_COUNT];
+    };
+
+    bool Read(double* values) const;
+
+    int m_groupFd = -1;
+    std::vector<int> m_fds;
+    int32_t m_valueIndices[COUNTER_COUNT] = {-1, -1, -1, -1, -1};  // Index of each counter in the group's read() values.
+    std::vector<Phase> m_phases;
+};
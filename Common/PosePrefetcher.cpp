@@ -0,0 +1,229 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <PosePrefetcher.h>
+
+// The velocity is estimated over at least this time, in nanoseconds, to smooth out tracking noise.
+static constexpr XrTime velocityWindow = 50000000;
+static constexpr size_t maxPoseSamples = 16;
+
+static float ToSeconds(XrTime duration) {
+    return static_cast<float>(static_cast<double>(duration) * 1e-9);
+}
+
+PosePrefetcher::PosePrefetcher(const CreateInfo &createInfo)
+    : m_createInfo(createInfo) {
+}
+
+PosePrefetcher::AssetHandle PosePrefetcher::AddAsset(const XrVector3f &center, float radius, RequestCallback request) {
+    const AssetHandle assetHandle = m_nextAssetHandle++;
+    m_assets[assetHandle] = {center, radius, std::move(request), false, 0};
+    return assetHandle;
+}
+
+void PosePrefetcher::RemoveAsset(AssetHandle assetHandle) {
+    m_assets.erase(assetHandle);
+}
+
+void PosePrefetcher::Update(XrTime time, const XrView *views, uint32_t viewCount, float nearZ, float farZ) {
+    if (viewCount == 0) {
+        return;
+    }
+
+    PoseSample sample{time, views[0].pose};
+    XrVector3f_Set(&sample.pose.position, 0.0f);
+    for (uint32_t i = 0; i < viewCount; i++) {
+        XrVector3f_Add(&sample.pose.position, &sample.pose.position, &views[i].pose.position);
+    }
+    XrVector3f_Scale(&sample.pose.position, &sample.pose.position, 1.0f / static_cast<float>(viewCount));
+    if (!m_poseSamples.empty() && m_poseSamples.back().time >= time) {
+        m_poseSamples.clear();
+    }
+    m_poseSamples.push_back(sample);
+    if (m_poseSamples.size() > maxPoseSamples) {
+        m_poseSamples.pop_front();
+    }
+    EstimateVelocity();
+
+    // Visibility in the current views.
+    std::vector<Frustum> frusta(viewCount);
+    for (uint32_t i = 0; i < viewCount; i++) {
+        CreateFrustum(frusta[i], views[i].pose, views[i].fov, nearZ, farZ);
+    }
+    const XrTime prefetchTimeout = static_cast<XrTime>(static_cast<double>(m_createInfo.prefetchTimeout) * 1e9);
+    for (std::pair<const AssetHandle, Asset> &it : m_assets) {
+        Asset &asset = it.second;
+        const bool visible = IsVisible(asset, frusta);
+        if (visible && !asset.visible) {
+            if (asset.prefetchTime != 0) {
+                m_statistics.hits++;
+                m_totalLeadTime += ToSeconds(time - asset.prefetchTime);
+            } else {
+                m_statistics.misses++;
+            }
+        }
+        if (visible || (asset.prefetchTime != 0 && time - asset.prefetchTime > prefetchTimeout)) {
+            if (!visible) {
+                m_statistics.wasted++;
+            }
+            asset.prefetchTime = 0;
+        }
+        asset.visible = visible;
+    }
+    const uint32_t resolved = m_statistics.hits + m_statistics.misses;
+    m_statistics.hitRate = resolved > 0 ? static_cast<float>(m_statistics.hits) / static_cast<float>(resolved) : 0.0f;
+    m_statistics.averageLeadTimeMs = m_statistics.hits > 0 ? static_cast<float>(m_totalLeadTime * 1000.0 / m_statistics.hits) : 0.0f;
+    m_statistics.angularSpeed = m_angularSpeed;
+
+    if (!m_velocityValid) {
+        return;
+    }
+
+    // Prefetch the assets in the predicted frusta, the nearest lead time first.
+    uint32_t requests = 0;
+    const uint32_t steps = std::max(m_createInfo.leadTimeSteps, 1u);
+    for (uint32_t step = 0; step < steps && requests < m_createInfo.maxRequestsPerFrame; step++) {
+        const float leadTime = steps > 1 ? m_createInfo.minLeadTime + (m_createInfo.maxLeadTime - m_createInfo.minLeadTime) * static_cast<float>(step) / static_cast<float>(steps - 1) : m_createInfo.minLeadTime;
+        for (uint32_t i = 0; i < viewCount; i++) {
+            XrPosef viewPose;
+            PredictViewPose(leadTime, sample.pose, views[i].pose, viewPose);
+            XrFovf fov = views[i].fov;
+            fov.angleLeft -= m_createInfo.fovMargin;
+            fov.angleRight += m_createInfo.fovMargin;
+            fov.angleDown -= m_createInfo.fovMargin;
+            fov.angleUp += m_createInfo.fovMargin;
+            CreateFrustum(frusta[i], viewPose, fov, nearZ, farZ);
+        }
+
+        for (std::pair<const AssetHandle, Asset> &it : m_assets) {
+            Asset &asset = it.second;
+            if (asset.visible || asset.prefetchTime != 0 || !IsVisible(asset, frusta)) {
+                continue;
+            }
+            asset.request();
+            asset.prefetchTime = time;
+            m_statistics.prefetches++;
+            if (++requests >= m_createInfo.maxRequestsPerFrame) {
+                break;
+            }
+        }
+    }
+}
+
+bool PosePrefetcher::PredictPose(float leadTime, XrPosef &pose) const {
+    if (!m_velocityValid) {
+        return false;
+    }
+    const XrPosef &headPose = m_poseSamples.back().pose;
+    PredictViewPose(leadTime, headPose, headPose, pose);
+    return true;
+}
+
+std::string PosePrefetcher::GetStatisticsJSON() const {
+    std::stringstream json;
+    json << "{\"prefetches\":" << m_statistics.prefetches << ",\"hits\":" << m_statistics.hits << ",\"misses\":" << m_statistics.misses
+         << ",\"wasted\":" << m_statistics.wasted << ",\"hitRate\":" << m_statistics.hitRate << ",\"averageLeadTimeMs\":" << m_statistics.averageLeadTimeMs << "}";
+    return json.str();
+}
+
+void PosePrefetcher::EstimateVelocity() {
+    // Difference the newest sample with the newest one that is at least velocityWindow older.
+    m_velocityValid = false;
+    if (m_poseSamples.size() < 2) {
+        return;
+    }
+    const PoseSample &newest = m_poseSamples.back();
+    const PoseSample *oldest = &m_poseSamples.front();
+    for (size_t i = m_poseSamples.size() - 1; i-- > 0;) {
+        if (newest.time - m_poseSamples[i].time >= velocityWindow) {
+            oldest = &m_poseSamples[i];
+            break;
+        }
+    }
+    const float deltaTime = ToSeconds(newest.time - oldest->time);
+    if (deltaTime <= 0.0f) {
+        return;
+    }
+
+    XrVector3f_Sub(&m_linearVelocity, &newest.pose.position, &oldest->pose.position);
+    XrVector3f_Scale(&m_linearVelocity, &m_linearVelocity, 1.0f / deltaTime);
+
+    // The rotation from the oldest to the newest orientation, as an axis and an angle.
+    XrQuaternionf inverseOldest;
+    XrQuaternionf_Invert(&inverseOldest, &oldest->pose.orientation);
+    XrQuaternionf delta;
+    XrQuaternionf_Multiply(&delta, &inverseOldest, &newest.pose.orientation);
+    XrQuaternionf_Normalize(&delta);
+    if (delta.w < 0.0f) {
+        delta = {-delta.x, -delta.y, -delta.z, -delta.w};
+    }
+    const XrVector3f axis = {delta.x, delta.y, delta.z};
+    const float sinHalfAngle = XrVector3f_Length(&axis);
+    if (sinHalfAngle > 1e-6f) {
+        m_angularAxis = axis;
+        XrVector3f_Normalize(&m_angularAxis);
+        m_angularSpeed = 2.0f * atan2f(sinHalfAngle, delta.w) / deltaTime;
+    } else {
+        m_angularSpeed = 0.0f;
+    }
+    m_velocityValid = true;
+}
+
+void PosePrefetcher::PredictViewPose(float leadTime, const XrPosef &headPose, const XrPosef &viewPose, XrPosef &result) const {
+    // The predicted head orientation is the head orientation, rotated further about the world space angular velocity axis.
+    // Head rotations rarely continue beyond a quarter turn, so the extrapolated angle is limited to that.
+    XrQuaternionf rotation;
+    XrQuaternionf_CreateFromAxisAngle(&rotation, &m_angularAxis, std::min(m_angularSpeed * leadTime, MATH_PI / 2.0f));
+    XrQuaternionf predictedHeadOrientation;
+    XrQuaternionf_Multiply(&predictedHeadOrientation, &headPose.orientation, &rotation);
+    XrQuaternionf_Normalize(&predictedHeadOrientation);
+
+    // The view's orientation and eye offset relative to the head stay fixed, so they are composed with the predicted head
+    // orientation.
+    XrQuaternionf inverseHeadOrientation;
+    XrQuaternionf_Invert(&inverseHeadOrientation, &headPose.orientation);
+    XrQuaternionf viewInHead;
+    XrQuaternionf_Multiply(&viewInHead, &viewPose.orientation, &inverseHeadOrientation);
+    XrQuaternionf_Multiply(&result.orientation, &viewInHead, &predictedHeadOrientation);
+    XrQuaternionf_Normalize(&result.orientation);
+
+    XrVector3f offset;
+    XrVector3f_Sub(&offset, &viewPose.position, &headPose.position);
+    XrQuaternionf_RotateVector3f(&offset, &inverseHeadOrientation, &offset);
+    XrQuaternionf_RotateVector3f(&offset, &predictedHeadOrientation, &offset);
+
+    // The head translates with the linear velocity.
+    XrVector3f translation;
+    XrVector3f_Scale(&translation, &m_linearVelocity, leadTime);
+    XrVector3f_Add(&result.position, &headPose.position, &translation);
+    XrVector3f_Add(&result.position, &result.position, &offset);
+}
+
+void PosePrefetcher::CreateFrustum(Frustum &frustum, const XrPosef &pose, XrFovf fov, float nearZ, float farZ) {
+    XrMatrix4x4f projection;
+    XrMatrix4x4f_CreateProjectionFov(&projection, OPENGL, fov, nearZ, farZ);
+    XrMatrix4x4f toView;
+    XrMatrix4x4f_CreateFromRigidTransform(&toView, &pose);
+    XrMatrix4x4f view;
+    XrMatrix4x4f_InvertRigidBody(&view, &toView);
+    XrMatrix4x4f viewProjection;
+    XrMatrix4x4f_Multiply(&viewProjection, &projection, &view);
+    XrMatrix4x4f_GetFrustumPlanes(frustum.planes, &viewProjection);
+}
+
+bool PosePrefetcher::IsVisible(const Asset &asset, const std::vector<Frustum> &frusta) {
+    for (const Frustum &frustum : frusta) {
+        bool inside = true;
+        for (int i = 0; i < 6 && inside; i++) {
+            const float *plane = frustum.planes[i];
+            inside = plane[0] * asset.center.x + plane[1] * asset.center.y + plane[2] * asset.center.z + plane[3] >= -asset.radius;
+        }
+        if (inside) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,102 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <xr_linear_algebra.h>
+
+#include <deque>
+#include <functional>
+
+// Pose predictive prefetching: Streaming that reacts to visibility only starts loading once content is on screen, which
+// shows as pop-in when the user turns their head quickly. The prefetcher extrapolates the head pose from the recent
+// located views with the head's linear and angular velocity, predicts the view frusta minLeadTime to maxLeadTime ahead,
+// and calls the request callback of each registered asset that is about to enter the view. The callbacks should queue
+// low priority loads, e.g. with VirtualTexture::Prefetch().
+//
+// An asset that becomes visible after it was prefetched counts as a hit, with the time between the prefetch and the
+// visibility as its lead time. An asset that becomes visible without a prefetch counts as a miss.
+class PosePrefetcher {
+public:
+    struct CreateInfo {
+        // The prediction horizon in seconds, sampled in leadTimeSteps frusta.
+        float minLeadTime = 0.3f;
+        float maxLeadTime = 0.5f;
+        uint32_t leadTimeSteps = 3;
+        // Widens each side of the predicted frusta, in radians, to cover the prediction error.
+        float fovMargin = 0.1f;
+        // A prefetched asset that does not become visible within this time, in seconds, counts as wasted and may be
+        // prefetched again.
+        float prefetchTimeout = 1.0f;
+        uint32_t maxRequestsPerFrame = 16;
+    };
+
+    struct Statistics {
+        uint32_t prefetches;
+        uint32_t hits;
+        uint32_t misses;
+        uint32_t wasted;
+        float hitRate;             // hits / (hits + misses)
+        float averageLeadTimeMs;   // Of the hits.
+        float angularSpeed;        // The current estimate, in radians per second.
+    };
+
+    typedef uint64_t AssetHandle;
+    typedef std::function<void()> RequestCallback;
+
+    PosePrefetcher(const CreateInfo& createInfo);
+
+    // center and radius bound the asset in the space the views are located in.
+    AssetHandle AddAsset(const XrVector3f& center, float radius, RequestCallback request);
+    void RemoveAsset(AssetHandle assetHandle);
+
+    // Call once per frame with the located views.
+    void Update(XrTime time, const XrView* views, uint32_t viewCount, float nearZ, float farZ);
+
+    // The extrapolated head pose leadTime seconds after the last update. Returns false before two updates.
+    bool PredictPose(float leadTime, XrPosef& pose) const;
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+    // The statistics as a JSON object, for trace exports.
+    std::string GetStatisticsJSON() const;
+
+private:
+    struct PoseSample {
+        XrTime time;
+        XrPosef pose;
+    };
+    struct Asset {
+        XrVector3f center;
+        float radius;
+        RequestCallback request;
+        bool visible;
+        XrTime prefetchTime;  // 0 if not prefetched.
+    };
+
+    struct Frustum {
+        float planes[6][4];
+    };
+
+    void EstimateVelocity();
+    void PredictViewPose(float leadTime, const XrPosef& headPose, const XrPosef& viewPose, XrPosef& result) const;
+    static void CreateFrustum(Frustum& frustum, const XrPosef& pose, XrFovf fov, float nearZ, float farZ);
+    static bool IsVisible(const Asset& asset, const std::vector<Frustum>& frusta);
+
+    CreateInfo m_createInfo;
+    Statistics m_statistics{};
+    double m_totalLeadTime = 0.0;
+
+    // Head poses of the recent frames, oldest first. The head pose is the mean of the view positions with the first
+    // view's orientation.
+    std::deque<PoseSample> m_poseSamples;
+    bool m_velocityValid = false;
+    XrVector3f m_linearVelocity{};
+    XrVector3f m_angularAxis{0.0f, 1.0f, 0.0f};
+    float m_angularSpeed = 0.0f;
+
+    std::unordered_map<AssetHandle, Asset> m_assets;
+    AssetHandle m_nextAssetHandle = 1;
+};
@@ -0,0 +1,457 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <SplitRendering.h>
+
+#include <chrono>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#if !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+static int64_t GetSteadyTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#if !defined(_WIN32)
+// Fills address for "unix:<path>" or "<IPv4 address>:<port>". Returns the socket family, or -1 if the address is malformed.
+static int ParseAddress(const std::string &address, sockaddr_storage &storage, socklen_t &length) {
+    memset(&storage, 0, sizeof(storage));
+    if (address.compare(0, 5, "unix:") == 0) {
+        sockaddr_un &unixAddress = reinterpret_cast<sockaddr_un &>(storage);
+        const std::string path = address.substr(5);
+        if (path.empty() || path.size() >= sizeof(unixAddress.sun_path)) {
+            return -1;
+        }
+        unixAddress.sun_family = AF_UNIX;
+        memcpy(unixAddress.sun_path, path.c_str(), path.size() + 1);
+        length = sizeof(sockaddr_un);
+        return AF_UNIX;
+    }
+    const size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        return -1;
+    }
+    sockaddr_in &inetAddress = reinterpret_cast<sockaddr_in &>(storage);
+    inetAddress.sin_family = AF_INET;
+    inetAddress.sin_port = htons((uint16_t)atoi(address.substr(colon + 1).c_str()));
+    if (inet_pton(AF_INET, address.substr(0, colon).c_str(), &inetAddress.sin_addr) != 1) {
+        return -1;
+    }
+    length = sizeof(sockaddr_in);
+    return AF_INET;
+}
+#endif
+
+std::unique_ptr<SplitRenderingConnection> SplitRenderingConnection::Connect(const std::string &address) {
+#if !defined(_WIN32)
+    sockaddr_storage storage;
+    socklen_t length = 0;
+    const int family = ParseAddress(address, storage, length);
+    if (family < 0) {
+        std::cout << "ERROR: SplitRendering: Invalid address " << address << "." << std::endl;
+        return nullptr;
+    }
+    const int fd = socket(family, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&storage), length) != 0) {
+        std::cout << "ERROR: SplitRendering: Failed to connect to " << address << "." << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return nullptr;
+    }
+    if (family == AF_INET) {
+        // Send the small pose messages right away instead of coalescing them.
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return std::unique_ptr<SplitRenderingConnection>(new SplitRenderingConnection(fd));
+#else
+    std::cout << "ERROR: SplitRendering: Only POSIX sockets are supported." << std::endl;
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<SplitRenderingConnection> SplitRenderingConnection::Accept(const std::string &address) {
+#if !defined(_WIN32)
+    sockaddr_storage storage;
+    socklen_t length = 0;
+    const int family = ParseAddress(address, storage, length);
+    if (family < 0) {
+        std::cout << "ERROR: SplitRendering: Invalid address " << address << "." << std::endl;
+        return nullptr;
+    }
+    const int listenFd = socket(family, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cout << "ERROR: SplitRendering: Failed to create a socket." << std::endl;
+        return nullptr;
+    }
+    if (family == AF_UNIX) {
+        // Remove the socket file of a previous server.
+        unlink(reinterpret_cast<sockaddr_un &>(storage).sun_path);
+    } else {
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+    if (bind(listenFd, reinterpret_cast<sockaddr *>(&storage), length) != 0 || listen(listenFd, 1) != 0) {
+        std::cout << "ERROR: SplitRendering: Failed to listen on " << address << "." << std::endl;
+        close(listenFd);
+        return nullptr;
+    }
+    const int fd = accept(listenFd, nullptr, nullptr);
+    close(listenFd);
+    if (fd < 0) {
+        std::cout << "ERROR: SplitRendering: Failed to accept a connection on " << address << "." << std::endl;
+        return nullptr;
+    }
+    if (family == AF_INET) {
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return std::unique_ptr<SplitRenderingConnection>(new SplitRenderingConnection(fd));
+#else
+    std::cout << "ERROR: SplitRendering: Only POSIX sockets are supported." << std::endl;
+    return nullptr;
+#endif
+}
+
+SplitRenderingConnection::~SplitRenderingConnection() {
+#if !defined(_WIN32)
+    close(m_socket);
+#endif
+}
+
+bool SplitRenderingConnection::Send(const void *data, size_t size) {
+#if !defined(_WIN32)
+    const uint8_t *bytes = (const uint8_t *)data;
+    while (size > 0) {
+        const ssize_t sent = send(m_socket, bytes, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= (size_t)sent;
+        m_bytesSent += (uint64_t)sent;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SplitRenderingConnection::Receive(void *data, size_t size) {
+#if !defined(_WIN32)
+    uint8_t *bytes = (uint8_t *)data;
+    while (size > 0) {
+        const ssize_t received = recv(m_socket, bytes, size, 0);
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= (size_t)received;
+        m_bytesReceived += (uint64_t)received;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SplitRenderingConnection::Poll(int timeoutMs) {
+#if !defined(_WIN32)
+    pollfd pollFd = {m_socket, POLLIN, 0};
+    return poll(&pollFd, 1, timeoutMs) > 0 && (pollFd.revents & POLLIN);
+#else
+    return false;
+#endif
+}
+
+void SplitRenderingConnection::Shutdown() {
+#if !defined(_WIN32)
+    shutdown(m_socket, SHUT_RDWR);
+#endif
+}
+
+SplitRenderServer::SplitRenderServer(GraphicsAPI *graphicsAPI, const CreateInfo &createInfo, BatchRenderer::DrawFunction draw)
+    : m_graphicsAPI(graphicsAPI), m_createInfo(createInfo), m_draw(std::move(draw)) {
+}
+
+void SplitRenderServer::Serve() {
+    std::unique_ptr<SplitRenderingConnection> connection = SplitRenderingConnection::Accept(m_createInfo.address);
+    if (!connection) {
+        return;
+    }
+
+    std::vector<uint8_t> encoded[SplitRenderingConnection::maxViews];
+    int64_t encodeTimes[SplitRenderingConnection::maxViews] = {};
+    // Views with the same resolution are rendered by the same batch renderer.
+    struct ResolutionGroup {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint32_t> viewIndices;
+        std::unique_ptr<BatchRenderer> batchRenderer;
+    };
+    std::vector<ResolutionGroup> resolutionGroups;
+    uint32_t viewCount = 0;
+    uint32_t widths[SplitRenderingConnection::maxViews] = {};
+    uint32_t heights[SplitRenderingConnection::maxViews] = {};
+
+    SplitRenderingConnection::PoseMessage poses;
+    while (connection->Receive(&poses, sizeof(poses))) {
+        // Render the latest poses only. Older ones would only add latency.
+        bool valid = true;
+        while (valid && connection->Poll(0)) {
+            valid = connection->Receive(&poses, sizeof(poses));
+            m_statistics.skippedPoses += valid ? 1 : 0;
+        }
+        if (!valid) {
+            break;
+        }
+        const int64_t receiveTime = GetSteadyTime();
+        bool validSizes = poses.magic == SplitRenderingConnection::poseMagic && poses.viewCount > 0 && poses.viewCount <= SplitRenderingConnection::maxViews;
+        for (uint32_t i = 0; validSizes && i < poses.viewCount; i++) {
+            validSizes = poses.widths[i] > 0 && poses.heights[i] > 0;
+        }
+        if (!validSizes) {
+            std::cout << "ERROR: SplitRenderServer: Invalid pose message." << std::endl;
+            break;
+        }
+
+        bool resolutionsChanged = poses.viewCount != viewCount;
+        for (uint32_t i = 0; !resolutionsChanged && i < viewCount; i++) {
+            resolutionsChanged = poses.widths[i] != widths[i] || poses.heights[i] != heights[i];
+        }
+        if (resolutionsChanged) {
+            viewCount = poses.viewCount;
+            resolutionGroups.clear();
+            for (uint32_t i = 0; i < viewCount; i++) {
+                widths[i] = poses.widths[i];
+                heights[i] = poses.heights[i];
+                auto it = std::find_if(resolutionGroups.begin(), resolutionGroups.end(), [&](const ResolutionGroup &resolutionGroup) {
+                    return resolutionGroup.width == widths[i] && resolutionGroup.height == heights[i];
+                });
+                if (it == resolutionGroups.end()) {
+                    resolutionGroups.push_back({widths[i], heights[i], {}, nullptr});
+                    it = resolutionGroups.end() - 1;
+                }
+                it->viewIndices.push_back(i);
+            }
+
+            bool valid = true;
+            for (ResolutionGroup &resolutionGroup : resolutionGroups) {
+                // One view per batch, so that the views are read back and encoded in parallel on the writer threads.
+                const uint32_t width = resolutionGroup.width;
+                const uint32_t height = resolutionGroup.height;
+                const std::vector<uint32_t> viewIndices = resolutionGroup.viewIndices;
+                BatchRenderer::CreateInfo batchRendererCI;
+                batchRendererCI.width = width;
+                batchRendererCI.height = height;
+                batchRendererCI.colorFormat = m_createInfo.colorFormat;
+                batchRendererCI.depthFormat = m_createInfo.depthFormat;
+                batchRendererCI.nearZ = m_createInfo.nearZ;
+                batchRendererCI.farZ = m_createInfo.farZ;
+                batchRendererCI.viewsPerBatch = 1;
+                batchRendererCI.readbackCount = static_cast<uint32_t>(viewIndices.size());
+                batchRendererCI.writerThreadCount = static_cast<uint32_t>(viewIndices.size());
+                resolutionGroup.batchRenderer = std::make_unique<BatchRenderer>(m_graphicsAPI, batchRendererCI, m_draw, [&encoded, &encodeTimes, viewIndices, width, height](uint64_t groupViewIndex, const uint8_t *rgba8) {
+                    const uint32_t viewIndex = viewIndices[groupViewIndex];
+                    const int64_t begin = GetSteadyTime();
+                    FrameCodec::Encode(rgba8, width, height, encoded[viewIndex]);
+                    encodeTimes[viewIndex] = GetSteadyTime() - begin;
+                });
+                valid = valid && resolutionGroup.batchRenderer->IsValid();
+            }
+            if (!valid) {
+                break;
+            }
+        }
+
+        for (ResolutionGroup &resolutionGroup : resolutionGroups) {
+            std::vector<XrView> views(resolutionGroup.viewIndices.size(), {XR_TYPE_VIEW});
+            for (size_t i = 0; i < views.size(); i++) {
+                views[i].pose = poses.poses[resolutionGroup.viewIndices[i]];
+                views[i].fov = poses.fovs[resolutionGroup.viewIndices[i]];
+            }
+            resolutionGroup.batchRenderer->Render(views);
+        }
+
+        SplitRenderingConnection::FrameMessage frame{};
+        frame.magic = SplitRenderingConnection::frameMagic;
+        frame.viewCount = poses.viewCount;
+        frame.frameIndex = poses.frameIndex;
+        frame.displayTime = poses.displayTime;
+        frame.clientTime = poses.clientTime;
+        frame.renderTime = GetSteadyTime() - receiveTime;
+        int64_t encodeTime = 0;
+        size_t encodedSize = 0;
+        size_t imageSize = 0;
+        for (uint32_t i = 0; i < poses.viewCount; i++) {
+            frame.widths[i] = widths[i];
+            frame.heights[i] = heights[i];
+            frame.poses[i] = poses.poses[i];
+            frame.fovs[i] = poses.fovs[i];
+            frame.encodedSizes[i] = encoded[i].size();
+            encodeTime = std::max(encodeTime, encodeTimes[i]);
+            encodedSize += encoded[i].size();
+            imageSize += (size_t)widths[i] * heights[i] * 4;
+        }
+        bool sent = connection->Send(&frame, sizeof(frame));
+        for (uint32_t i = 0; sent && i < poses.viewCount; i++) {
+            sent = connection->Send(encoded[i].data(), encoded[i].size());
+        }
+        if (!sent) {
+            break;
+        }
+
+        m_statistics.frames++;
+        m_statistics.renderMs = m_statistics.renderMs * 0.95f + (float)frame.renderTime * 1e-6f * 0.05f;
+        m_statistics.encodeMs = m_statistics.encodeMs * 0.95f + (float)encodeTime * 1e-6f * 0.05f;
+        m_statistics.compressionRatio = (float)imageSize / (float)std::max<size_t>(encodedSize, 1);
+    }
+    std::cout << "SplitRenderServer: Client disconnected after " << m_statistics.frames << " frames." << std::endl;
+}
+
+SplitRenderClient::SplitRenderClient(const std::string &address) {
+    m_connection = SplitRenderingConnection::Connect(address);
+    if (m_connection) {
+        m_connected = true;
+        m_receiveThread = std::thread(&SplitRenderClient::ReceiveThread, this);
+    }
+}
+
+SplitRenderClient::~SplitRenderClient() {
+    if (m_connection) {
+        m_connection->Shutdown();
+    }
+    if (m_receiveThread.joinable()) {
+        m_receiveThread.join();
+    }
+}
+
+void SplitRenderClient::SendPoses(uint64_t frameIndex, XrTime displayTime, const XrView *views, const XrViewConfigurationView *viewConfigurationViews, uint32_t viewCount) {
+    if (!m_connected || viewCount == 0 || viewCount > SplitRenderingConnection::maxViews) {
+        return;
+    }
+    SplitRenderingConnection::PoseMessage poses{};
+    poses.magic = SplitRenderingConnection::poseMagic;
+    poses.viewCount = viewCount;
+    poses.frameIndex = frameIndex;
+    poses.displayTime = displayTime;
+    poses.clientTime = GetSteadyTime();
+    for (uint32_t i = 0; i < viewCount; i++) {
+        poses.widths[i] = viewConfigurationViews[i].recommendedImageRectWidth;
+        poses.heights[i] = viewConfigurationViews[i].recommendedImageRectHeight;
+        poses.poses[i] = views[i].pose;
+        poses.fovs[i] = views[i].fov;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_requestedViewCount = viewCount;
+        std::copy(poses.widths, poses.widths + viewCount, m_requestedWidths);
+        std::copy(poses.heights, poses.heights + viewCount, m_requestedHeights);
+    }
+    if (!m_connection->Send(&poses, sizeof(poses))) {
+        m_connected = false;
+    }
+}
+
+bool SplitRenderClient::GetLatestFrame(Frame &frame) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_latestFrameValid) {
+        return false;
+    }
+    std::swap(frame, m_latestFrame);
+    m_latestFrameValid = false;
+    return true;
+}
+
+SplitRenderClient::Statistics SplitRenderClient::GetStatistics() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void SplitRenderClient::ReceiveThread() {
+    Frame frame{};
+    std::vector<uint8_t> encoded;
+    int64_t bandwidthBegin = GetSteadyTime();
+    uint64_t bandwidthBytes = m_connection->GetBytesReceived();
+
+    SplitRenderingConnection::FrameMessage message;
+    while (m_connection->Receive(&message, sizeof(message))) {
+        if (message.magic != SplitRenderingConnection::frameMagic || message.viewCount == 0 || message.viewCount > SplitRenderingConnection::maxViews) {
+            std::cout << "ERROR: SplitRenderClient: Invalid frame message." << std::endl;
+            break;
+        }
+        // The sizes are only trusted if they match the poses that were sent, and the encoded images are bounded by them.
+        bool validSizes = true;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            validSizes = message.viewCount == m_requestedViewCount;
+            for (uint32_t i = 0; validSizes && i < message.viewCount; i++) {
+                validSizes = message.widths[i] == m_requestedWidths[i] && message.heights[i] == m_requestedHeights[i] &&
+                             message.encodedSizes[i] <= FrameCodec::GetMaxEncodedSize(message.widths[i], message.heights[i]);
+            }
+        }
+        if (!validSizes) {
+            std::cout << "ERROR: SplitRenderClient: Frame sizes do not match the requested views." << std::endl;
+            break;
+        }
+        frame.frameIndex = message.frameIndex;
+        frame.displayTime = message.displayTime;
+        frame.viewCount = message.viewCount;
+
+        bool valid = true;
+        size_t encodedSize = 0;
+        size_t imageSize = 0;
+        int64_t decodeTime = 0;
+        for (uint32_t i = 0; i < message.viewCount && valid; i++) {
+            frame.widths[i] = message.widths[i];
+            frame.heights[i] = message.heights[i];
+            frame.poses[i] = message.poses[i];
+            frame.fovs[i] = message.fovs[i];
+            encoded.resize(message.encodedSizes[i]);
+            valid = m_connection->Receive(encoded.data(), encoded.size());
+            const int64_t decodeBegin = GetSteadyTime();
+            frame.images[i].resize((size_t)message.widths[i] * message.heights[i] * 4);
+            valid = valid && FrameCodec::Decode(encoded.data(), encoded.size(), message.widths[i], message.heights[i], frame.images[i].data());
+            decodeTime += GetSteadyTime() - decodeBegin;
+            encodedSize += encoded.size();
+            imageSize += frame.images[i].size();
+        }
+        if (!valid) {
+            std::cout << "ERROR: SplitRenderClient: Failed to receive or decode a frame." << std::endl;
+            break;
+        }
+        const int64_t now = GetSteadyTime();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_statistics.framesDropped += m_latestFrameValid ? 1 : 0;
+        std::swap(frame, m_latestFrame);
+        m_latestFrameValid = true;
+
+        m_statistics.framesReceived++;
+        m_statistics.latencyMs = m_statistics.latencyMs * 0.95f + (float)(now - message.clientTime) * 1e-6f * 0.05f;
+        m_statistics.serverMs = m_statistics.serverMs * 0.95f + (float)message.renderTime * 1e-6f * 0.05f;
+        m_statistics.decodeMs = m_statistics.decodeMs * 0.95f + (float)decodeTime * 1e-6f * 0.05f;
+        m_statistics.compressionRatio = (float)imageSize / (float)std::max<size_t>(encodedSize, 1);
+        if (now - bandwidthBegin >= 1000000000) {
+            const uint64_t bytes = m_connection->GetBytesReceived();
+            m_statistics.receivedMbps = (float)((double)(bytes - bandwidthBytes) * 8.0 / ((double)(now - bandwidthBegin) * 1e-3));
+            bandwidthBegin = now;
+            bandwidthBytes = bytes;
+        }
+    }
+    m_connected = false;
+}
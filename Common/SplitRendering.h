@@ -0,0 +1,171 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <BatchRenderer.h>
+#include <FrameCodec.h>
+
+// Split rendering: The views of a thin client are rendered by a server in another process or on another machine.
+//
+// Each frame, the client sends the predicted poses and fields of view of its views to the server. The server renders
+// them on a GraphicsAPI without OpenXR, encodes them with the FrameCodec and sends them back together with the poses
+// they were rendered with. The client shows the latest frame it received in its projection layer, with those original
+// poses, so that the runtime reprojects it to the current head pose.
+//
+// Connections are Unix domain sockets, with addresses of the form "unix:<path>", or TCP connections, with addresses of
+// the form "<IPv4 address>:<port>", e.g. "127.0.0.1:7420". Only POSIX sockets are supported.
+class SplitRenderingConnection {
+public:
+    // Enough for the quad views of XR_VARJO_quad_views.
+    static constexpr uint32_t maxViews = 4;
+
+    // Sent by the client.
+    struct PoseMessage {
+        uint32_t magic;
+        uint32_t viewCount;
+        uint32_t widths[maxViews];
+        uint32_t heights[maxViews];
+        uint64_t frameIndex;
+        XrTime displayTime;
+        int64_t clientTime;  // The client's steady clock in nanoseconds, returned with the frame.
+        XrPosef poses[maxViews];
+        XrFovf fovs[maxViews];
+    };
+
+    // Sent by the server, followed by the encoded images of the views.
+    struct FrameMessage {
+        uint32_t magic;
+        uint32_t viewCount;
+        uint32_t widths[maxViews];
+        uint32_t heights[maxViews];
+        uint64_t frameIndex;
+        XrTime displayTime;
+        int64_t clientTime;
+        int64_t renderTime;  // Nanoseconds from receiving the poses to the encoded images, on the server.
+        XrPosef poses[maxViews];
+        XrFovf fovs[maxViews];
+        uint64_t encodedSizes[maxViews];
+    };
+
+    static constexpr uint32_t poseMagic = 0x45534F50;   // "POSE"
+    static constexpr uint32_t frameMagic = 0x4D415246;  // "FRAM"
+
+    // Connects to a server. Returns nullptr on failure.
+    static std::unique_ptr<SplitRenderingConnection> Connect(const std::string& address);
+    // Listens on the address and returns the connection of the first client that connects. Returns nullptr on failure.
+    static std::unique_ptr<SplitRenderingConnection> Accept(const std::string& address);
+
+    ~SplitRenderingConnection();
+
+    // Send and receive the whole size, blocking. Return false once the connection is closed.
+    bool Send(const void* data, size_t size);
+    bool Receive(void* data, size_t size);
+    // Returns true if data can be received within timeoutMs.
+    bool Poll(int timeoutMs);
+    // Unblocks Receive() on another thread.
+    void Shutdown();
+
+    uint64_t GetBytesSent() const { return m_bytesSent; }
+    uint64_t GetBytesReceived() const { return m_bytesReceived; }
+
+private:
+    SplitRenderingConnection(int socket)
+        : m_socket(socket) {}
+
+    int m_socket = -1;
+    std::atomic<uint64_t> m_bytesSent{0};
+    std::atomic<uint64_t> m_bytesReceived{0};
+};
+
+// Renders the poses of one client at a time, until the client disconnects.
+class SplitRenderServer {
+public:
+    struct CreateInfo {
+        std::string address;
+        // API specific formats, see BatchRenderer::CreateInfo.
+        int64_t colorFormat;
+        int64_t depthFormat;
+        float nearZ = 0.05f;
+        float farZ = 100.0f;
+    };
+
+    struct Statistics {
+        uint64_t frames;
+        uint64_t skippedPoses;  // Poses replaced by newer ones before they were rendered.
+        float renderMs;         // Averages over the last frames.
+        float encodeMs;
+        float compressionRatio;
+    };
+
+    SplitRenderServer(GraphicsAPI* graphicsAPI, const CreateInfo& createInfo, BatchRenderer::DrawFunction draw);
+
+    // Waits for a client and serves it. Returns when the client has disconnected.
+    void Serve();
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+private:
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    CreateInfo m_createInfo;
+    BatchRenderer::DrawFunction m_draw;
+    Statistics m_statistics{};
+};
+
+// Sends the poses of the client's views and receives and decodes the rendered frames on a background thread.
+class SplitRenderClient {
+public:
+    struct Frame {
+        uint64_t frameIndex;
+        XrTime displayTime;
+        uint32_t viewCount;
+        uint32_t widths[SplitRenderingConnection::maxViews];
+        uint32_t heights[SplitRenderingConnection::maxViews];
+        XrPosef poses[SplitRenderingConnection::maxViews];
+        XrFovf fovs[SplitRenderingConnection::maxViews];
+        // Tightly packed RGBA8, bottom row first.
+        std::vector<uint8_t> images[SplitRenderingConnection::maxViews];
+    };
+
+    struct Statistics {
+        uint64_t framesReceived;
+        uint64_t framesDropped;  // Received frames replaced by newer ones before they were shown.
+        // Averages over the last frames. The latency is from sending the poses to the decoded frame.
+        float latencyMs;
+        float serverMs;
+        float decodeMs;
+        float receivedMbps;  // Over the last second.
+        float compressionRatio;
+    };
+
+    SplitRenderClient(const std::string& address);
+    ~SplitRenderClient();
+
+    bool IsConnected() const { return m_connected; }
+
+    // Each view is rendered at the recommended resolution of its view configuration view.
+    void SendPoses(uint64_t frameIndex, XrTime displayTime, const XrView* views, const XrViewConfigurationView* viewConfigurationViews, uint32_t viewCount);
+
+    // Swaps the latest frame into frame, if a frame was received since the last call. Returns false otherwise.
+    bool GetLatestFrame(Frame& frame);
+
+    Statistics GetStatistics();
+
+private:
+    void ReceiveThread();
+
+    std::unique_ptr<SplitRenderingConnection> m_connection = nullptr;
+    std::atomic<bool> m_connected{false};
+    std::thread m_receiveThread;
+
+    std::mutex m_mutex;
+    // The view sizes of the last poses sent. Frames of other sizes are rejected.
+    uint32_t m_requestedViewCount = 0;
+    uint32_t m_requestedWidths[SplitRenderingConnection::maxViews] = {};
+    uint32_t m_requestedHeights[SplitRenderingConnection::maxViews] = {};
+    Frame m_latestFrame{};
+    bool m_latestFrameValid = false;
+    Statistics m_statistics{};
+};
@@ -0,0 +1,214 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <StereoShadingReuse.h>
+
+// GLSL 4.50 shaders.
+static const char *reprojectionFragmentShaderSource = R"(
+#version 450
+layout(location = 0) in vec2 i_TexCoord;
+layout(location = 0) out vec4 o_Color;
+
+layout(binding = 0) uniform sampler2D sourceDiffuse;
+layout(binding = 1) uniform sampler2D sourceDepth;
+layout(binding = 2) uniform sampler2D targetDepth;
+layout(std140, binding = 3) uniform ReprojectionUniforms {
+    mat4 targetInverseViewProjection;
+    mat4 sourceViewProjection;
+    mat4 sourceInverseViewProjection;
+    float depthTolerance;
+};
+
+vec3 WorldPosition(mat4 inverseViewProjection, vec2 uv, float depth) {
+    vec4 position = inverseViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
+
+void main() {
+    // Alpha 0 marks the pixel as invalid, so that the target view shades it itself.
+    o_Color = vec4(0.0);
+    float depth = texelFetch(targetDepth, ivec2(gl_FragCoord.xy), 0).r;
+    if (depth >= 1.0) {
+        return;
+    }
+
+    vec3 position = WorldPosition(targetInverseViewProjection, i_TexCoord, depth);
+    vec4 sourceClip = sourceViewProjection * vec4(position, 1.0);
+    if (sourceClip.w <= 0.0) {
+        return;
+    }
+    vec2 sourceUV = (sourceClip.xy / sourceClip.w) * 0.5 + 0.5;
+    if (any(lessThan(sourceUV, vec2(0.0))) || any(greaterThanEqual(sourceUV, vec2(1.0)))) {
+        return;
+    }
+
+    // The surface is disoccluded if the source view sees a different surface at that pixel.
+    ivec2 sourceTexel = ivec2(sourceUV * vec2(textureSize(sourceDepth, 0)));
+    vec3 sourcePosition = WorldPosition(sourceInverseViewProjection, sourceUV, texelFetch(sourceDepth, sourceTexel, 0).r);
+    if (distance(position, sourcePosition) > depthTolerance * sourceClip.w) {
+        return;
+    }
+    o_Color = vec4(texelFetch(sourceDiffuse, sourceTexel, 0).rgb, 1.0);
+}
+)";
+
+static const char *stereoReuseGLSLSource = R"(
+layout(binding = STEREO_REUSE_BINDING) uniform sampler2D srReusedDiffuse;
+
+// Returns true and the diffuse term shaded by the source view, if it is valid for this pixel.
+bool StereoReuseFetchDiffuse(out vec3 diffuse) {
+    vec4 reused = texelFetch(srReusedDiffuse, ivec2(gl_FragCoord.xy), 0);
+    diffuse = reused.rgb;
+    return reused.a > 0.5;
+}
+)";
+
+StereoShadingReuse::StereoShadingReuse(GraphicsAPI *graphicsAPI, uint32_t width, uint32_t height, int64_t diffuseFormat)
+    : m_graphicsAPI(graphicsAPI), m_width(width), m_height(height) {
+    m_diffuseImage = m_graphicsAPI->CreateImage({2, m_width, m_height, 1, 1, 1, 1, diffuseFormat, false, true, false, true});
+    m_diffuseImageView = m_graphicsAPI->CreateImageView({m_diffuseImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, diffuseFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+    m_reusedImage = m_graphicsAPI->CreateImage({2, m_width, m_height, 1, 1, 1, 1, diffuseFormat, false, true, false, true});
+    m_reusedImageView = m_graphicsAPI->CreateImageView({m_reusedImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, diffuseFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+
+    GraphicsAPI::SamplerCreateInfo samplerCI{};
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.mipmapMode = GraphicsAPI::SamplerCreateInfo::MipmapMode::NOOP;
+    samplerCI.addressModeS = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeT = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeR = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.compareOp = GraphicsAPI::CompareOp::NEVER;
+    m_sampler = m_graphicsAPI->CreateSampler(samplerCI);
+    m_uniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(ReprojectionUniforms), nullptr});
+
+    m_reprojectionPass = std::make_unique<FullscreenPass>(m_graphicsAPI, reprojectionFragmentShaderSource, std::vector<int64_t>{diffuseFormat},
+                                                          std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                   {1, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                   {2, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                   {3, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}});
+
+    for (FrameQueries &frameQueries : m_frameQueries) {
+        for (void *&query : frameQueries.queries) {
+            query = m_graphicsAPI->CreateTimestampQuery();
+        }
+    }
+}
+
+StereoShadingReuse::~StereoShadingReuse() {
+    for (FrameQueries &frameQueries : m_frameQueries) {
+        for (void *&query : frameQueries.queries) {
+            m_graphicsAPI->DestroyTimestampQuery(query);
+        }
+    }
+    m_reprojectionPass.reset();
+    m_graphicsAPI->DestroyBuffer(m_uniformBuffer);
+    m_graphicsAPI->DestroySampler(m_sampler);
+    m_graphicsAPI->DestroyImageView(m_reusedImageView);
+    m_graphicsAPI->DestroyImage(m_reusedImage);
+    m_graphicsAPI->DestroyImageView(m_diffuseImageView);
+    m_graphicsAPI->DestroyImage(m_diffuseImage);
+}
+
+void StereoShadingReuse::BeginFrame() {
+    // The oldest frame's queries are reused this frame. Read their results first, if the GPU has finished them.
+    m_frameQueryIndex = (m_frameQueryIndex + 1) % frameQueryCount;
+    FrameQueries &frameQueries = m_frameQueries[m_frameQueryIndex];
+
+    // The plain per-eye pass has no reprojection.
+    uint64_t timestamps[TIMESTAMP_COUNT] = {};
+    bool available = true;
+    for (uint32_t i = 0; i < TIMESTAMP_COUNT && available; i++) {
+        if (!frameQueries.enabled && (i == REPROJECT_BEGIN || i == REPROJECT_END)) {
+            continue;
+        }
+        available = frameQueries.written[i] && m_graphicsAPI->GetTimestamp(frameQueries.queries[i], timestamps[i]);
+    }
+    if (available) {
+        const float sourceMs = (float)(timestamps[SOURCE_END] - timestamps[SOURCE_BEGIN]) / 1e6f;
+        const float reprojectMs = (float)(timestamps[REPROJECT_END] - timestamps[REPROJECT_BEGIN]) / 1e6f;
+        const float targetMs = (float)(timestamps[TARGET_END] - timestamps[TARGET_BEGIN]) / 1e6f;
+        Accumulate(m_statistics.sourceViewMs, sourceMs);
+        if (frameQueries.enabled) {
+            Accumulate(m_statistics.reprojectMs, reprojectMs);
+            Accumulate(m_statistics.targetViewReuseMs, targetMs);
+            m_reuseMeasured = true;
+        } else {
+            Accumulate(m_statistics.targetViewPlainMs, targetMs);
+            m_plainMeasured = true;
+        }
+        if (m_reuseMeasured && m_plainMeasured) {
+            m_statistics.savedVsPlainMs = m_statistics.targetViewPlainMs - (m_statistics.targetViewReuseMs + m_statistics.reprojectMs);
+        }
+    }
+
+    for (bool &written : frameQueries.written) {
+        written = false;
+    }
+    frameQueries.enabled = m_enabled;
+}
+
+void StereoShadingReuse::BeginSourceView() {
+    WriteTimestamp(SOURCE_BEGIN);
+}
+
+void StereoShadingReuse::EndSourceView() {
+    WriteTimestamp(SOURCE_END);
+}
+
+void StereoShadingReuse::BeginTargetView() {
+    WriteTimestamp(TARGET_BEGIN);
+}
+
+void StereoShadingReuse::EndTargetView() {
+    WriteTimestamp(TARGET_END);
+}
+
+void StereoShadingReuse::Reproject(void *sourceDepthImage, void *targetDepthImage, const XrMatrix4x4f &sourceViewProjection, const XrMatrix4x4f &targetViewProjection) {
+    if (!m_enabled) {
+        return;
+    }
+    WriteTimestamp(REPROJECT_BEGIN);
+
+    ReprojectionUniforms uniforms{};
+    XrMatrix4x4f_Invert(&uniforms.targetInverseViewProjection, &targetViewProjection);
+    uniforms.sourceViewProjection = sourceViewProjection;
+    XrMatrix4x4f_Invert(&uniforms.sourceInverseViewProjection, &sourceViewProjection);
+    // Positions may differ by 1% of the view depth before the surface counts as disoccluded.
+    uniforms.depthTolerance = 0.01f;
+    m_graphicsAPI->SetBufferData(m_uniformBuffer, 0, sizeof(ReprojectionUniforms), &uniforms);
+
+    m_graphicsAPI->SetRenderAttachments(&m_reusedImageView, 1, nullptr, m_width, m_height, m_reprojectionPass->GetPipeline());
+    GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)m_width, (float)m_height, 0.0f, 1.0f};
+    GraphicsAPI::Rect2D scissor = {{0, 0}, {m_width, m_height}};
+    m_graphicsAPI->SetViewports(&viewport, 1);
+    m_graphicsAPI->SetScissors(&scissor, 1);
+
+    m_graphicsAPI->SetPipeline(m_reprojectionPass->GetPipeline());
+    void *images[3] = {m_diffuseImage, sourceDepthImage, targetDepthImage};
+    for (uint32_t i = 0; i < 3; i++) {
+        m_graphicsAPI->SetDescriptor({i, images[i], GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+        m_graphicsAPI->SetDescriptor({i, m_sampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    }
+    m_graphicsAPI->SetDescriptor({3, m_uniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT, false, 0, sizeof(ReprojectionUniforms)});
+    m_graphicsAPI->UpdateDescriptors();
+    m_reprojectionPass->Draw();
+
+    WriteTimestamp(REPROJECT_END);
+}
+
+const char *StereoShadingReuse::GetGLSLSource() {
+    return stereoReuseGLSLSource;
+}
+
+void StereoShadingReuse::WriteTimestamp(Timestamp timestamp) {
+    FrameQueries &frameQueries = m_frameQueries[m_frameQueryIndex];
+    m_graphicsAPI->WriteTimestamp(frameQueries.queries[timestamp]);
+    frameQueries.written[timestamp] = true;
+}
+
+void StereoShadingReuse::Accumulate(float &average, float sample) {
+    average = average == 0.0f ? sample : average * 0.95f + sample * 0.05f;
+}
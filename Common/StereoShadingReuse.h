@@ -0,0 +1,113 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <FullscreenPass.h>
+#include <xr_linear_algebra.h>
+
+// Stereo shading reuse: View independent lighting terms, e.g. diffuse and lightmaps, are shaded once in the source view
+// and reprojected into the target view, which then only shades its view dependent terms, e.g. specular.
+//
+// Per frame:
+//  1. Source view: Render with a second color attachment, GetDiffuseImageView(), which receives the view independent terms.
+//  2. Target view: Render a depth prepass.
+//  3. Reproject(): Writes the source view's diffuse into GetReusedImage() for every target pixel that is visible in the
+//     source view. Disoccluded pixels are marked invalid.
+//  4. Target view: Render with StereoReuseFetchDiffuse() (see GetGLSLSource()), which returns the reused diffuse where valid.
+//     Pixels without a valid reuse shade the diffuse term themselves.
+//
+// While disabled, Reproject() does nothing and the target view is rendered as a plain per-eye pass: With the shaders
+// that shade every term themselves, without StereoReuseFetchDiffuse() and without GetReusedImage() bound. Its GPU time,
+// measured with timestamp queries, is the baseline for GetStatistics().savedVsPlainMs.
+class StereoShadingReuse {
+public:
+    struct Statistics {
+        // Exponential moving averages in milliseconds.
+        float sourceViewMs;
+        float reprojectMs;
+        float targetViewReuseMs;  // Target view time, while enabled.
+        float targetViewPlainMs;  // Target view time of the plain per-eye pass, while disabled.
+        // The plain target view time minus the target view and reprojection times while enabled. Zero until the
+        // target view has been measured both while enabled and while disabled.
+        float savedVsPlainMs;
+    };
+
+    // diffuseFormat is an API specific format with at least three channels, e.g. GL_RGBA16F. Both views have the same resolution.
+    StereoShadingReuse(GraphicsAPI* graphicsAPI, uint32_t width, uint32_t height, int64_t diffuseFormat);
+    ~StereoShadingReuse();
+
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    bool IsEnabled() const { return m_enabled; }
+
+    void* GetDiffuseImageView() { return m_diffuseImageView; }
+    void* GetReusedImage() { return m_reusedImage; }
+
+    // Reads back the timestamps of older frames. Call once per frame, before any other call.
+    void BeginFrame();
+
+    // Bracket the GPU work of the source view and the target view.
+    void BeginSourceView();
+    void EndSourceView();
+    void BeginTargetView();
+    void EndTargetView();
+
+    // Call outside of the target view's render pass. sourceDepthImage and targetDepthImage are the views' depth images.
+    // Does nothing while disabled.
+    void Reproject(void* sourceDepthImage, void* targetDepthImage, const XrMatrix4x4f& sourceViewProjection, const XrMatrix4x4f& targetViewProjection);
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+    // GLSL 4.50. Define STEREO_REUSE_BINDING as the binding of GetReusedImage() before this source.
+    static const char* GetGLSLSource();
+
+private:
+    struct ReprojectionUniforms {
+        XrMatrix4x4f targetInverseViewProjection;
+        XrMatrix4x4f sourceViewProjection;
+        XrMatrix4x4f sourceInverseViewProjection;
+        float depthTolerance;
+        float pad[3];
+    };
+
+    enum Timestamp : uint32_t {
+        SOURCE_BEGIN,
+        SOURCE_END,
+        REPROJECT_BEGIN,
+        REPROJECT_END,
+        TARGET_BEGIN,
+        TARGET_END,
+        TIMESTAMP_COUNT
+    };
+    struct FrameQueries {
+        void* queries[TIMESTAMP_COUNT];
+        bool written[TIMESTAMP_COUNT];
+        bool enabled;
+    };
+
+    void WriteTimestamp(Timestamp timestamp);
+    static void Accumulate(float& average, float sample);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    bool m_enabled = true;
+    Statistics m_statistics{};
+    bool m_reuseMeasured = false;
+    bool m_plainMeasured = false;
+
+    void* m_diffuseImage = nullptr;
+    void* m_diffuseImageView = nullptr;
+    void* m_reusedImage = nullptr;
+    void* m_reusedImageView = nullptr;
+    void* m_sampler = nullptr;
+    void* m_uniformBuffer = nullptr;
+    std::unique_ptr<FullscreenPass> m_reprojectionPass;
+
+    // Timestamps are read a few frames later, so that reading them never stalls.
+    static constexpr uint32_t frameQueryCount = 3;
+    FrameQueries m_frameQueries[frameQueryCount] = {};
+    uint32_t m_frameQueryIndex = 0;
+};
@@ -0,0 +1,431 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <StressScene.h>
+
+#include <BatchRenderer.h>
+#include <chrono>
+
+static const char *stressSceneVertexShaderSource = R"(
+#version 450
+layout(std140, binding = 0) uniform SceneUniforms {
+    mat4 viewProjection;
+    vec4 lightPositions[64];
+    vec4 lightColors[64];
+    uvec4 lightCount;
+};
+layout(std140, binding = 1) uniform ObjectUniforms {
+    mat4 model;
+    vec4 tint;
+};
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 0) out vec3 o_WorldPosition;
+layout(location = 1) out vec3 o_Normal;
+layout(location = 2) out vec2 o_TexCoord;
+void main() {
+    vec4 worldPosition = model * vec4(a_Position, 1.0);
+    o_WorldPosition = worldPosition.xyz;
+    o_Normal = mat3(model) * a_Normal;
+    o_TexCoord = a_TexCoord;
+    gl_Position = viewProjection * worldPosition;
+}
+)";
+
+// Preceded by #version and the MATERIAL_VARIANT define, which selects one of shadingVariantCount shading models.
+static const char *stressSceneFragmentShaderSource = R"(
+layout(std140, binding = 0) uniform SceneUniforms {
+    mat4 viewProjection;
+    vec4 lightPositions[64];
+    vec4 lightColors[64];
+    uvec4 lightCount;
+};
+layout(std140, binding = 1) uniform ObjectUniforms {
+    mat4 model;
+    vec4 tint;
+};
+layout(binding = 2) uniform sampler2D u_Texture;
+layout(location = 0) in vec3 i_WorldPosition;
+layout(location = 1) in vec3 i_Normal;
+layout(location = 2) in vec2 i_TexCoord;
+layout(location = 0) out vec4 o_Color;
+void main() {
+    vec3 normal = normalize(i_Normal);
+    vec3 albedo = texture(u_Texture, i_TexCoord).rgb * tint.rgb;
+    vec3 color = 0.05 * albedo;
+    for (uint i = 0; i < lightCount.x; i++) {
+        vec3 toLight = lightPositions[i].xyz - i_WorldPosition;
+        float distanceSquared = dot(toLight, toLight);
+        float radius = lightPositions[i].w;
+        float attenuation = radius * radius / (distanceSquared + radius * radius);
+        float NdotL = dot(normal, toLight * inversesqrt(distanceSquared));
+#if MATERIAL_VARIANT == 0
+        float diffuse = max(NdotL, 0.0);
+#elif MATERIAL_VARIANT == 1
+        float diffuse = floor(max(NdotL, 0.0) * 4.0) / 4.0;
+#elif MATERIAL_VARIANT == 2
+        float diffuse = NdotL * 0.5 + 0.5;
+#else
+        float diffuse = max(NdotL, 0.0) + pow(1.0 - abs(normal.z), 4.0) * 0.5;
+#endif
+        color += albedo * lightColors[i].rgb * diffuse * attenuation;
+    }
+    o_Color = vec4(color, 1.0);
+}
+)";
+
+static constexpr uint32_t shadingVariantCount = 4;
+
+uint64_t StressScene::Random::Next() {
+    // splitmix64
+    uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+StressScene::StressScene(GraphicsAPI *graphicsAPI, const CreateInfo &createInfo)
+    : m_graphicsAPI(graphicsAPI), m_createInfo(createInfo) {
+    if (m_createInfo.meshCount == 0 || m_createInfo.materialCount == 0) {
+        std::cout << "ERROR: StressScene: meshCount and materialCount must not be 0." << std::endl;
+        return;
+    }
+    if (m_createInfo.lightCount > maxLights) {
+        std::cout << "WARNING: StressScene: lightCount is limited to " << maxLights << "." << std::endl;
+        m_createInfo.lightCount = maxLights;
+    }
+    Random random(m_createInfo.seed);
+
+    m_vertexShader = m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::VERTEX, stressSceneVertexShaderSource, strlen(stressSceneVertexShaderSource)});
+    for (uint32_t variant = 0; variant < std::min(m_createInfo.materialCount, shadingVariantCount); variant++) {
+        const std::string source = "#version 450\n#define MATERIAL_VARIANT " + std::to_string(variant) + "\n" + stressSceneFragmentShaderSource;
+        m_fragmentShaders.push_back(m_graphicsAPI->CreateShader({GraphicsAPI::ShaderCreateInfo::Type::FRAGMENT, source.c_str(), source.size()}));
+    }
+
+    GraphicsAPI::SamplerCreateInfo samplerCI{};
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.mipmapMode = GraphicsAPI::SamplerCreateInfo::MipmapMode::NOOP;
+    samplerCI.addressModeS = GraphicsAPI::SamplerCreateInfo::AddressMode::REPEAT;
+    samplerCI.addressModeT = GraphicsAPI::SamplerCreateInfo::AddressMode::REPEAT;
+    samplerCI.addressModeR = GraphicsAPI::SamplerCreateInfo::AddressMode::REPEAT;
+    samplerCI.compareOp = GraphicsAPI::CompareOp::NEVER;
+    m_sampler = m_graphicsAPI->CreateSampler(samplerCI);
+
+    // Meshes and materials. The materials' square RGBA8 textures have the largest power of two size that fits all of
+    // them into the texture footprint.
+    for (uint32_t i = 0; i < m_createInfo.meshCount; i++) {
+        CreateMesh(random);
+    }
+    uint32_t textureSize = 1;
+    while (textureSize < 4096 && (size_t)m_createInfo.materialCount * (textureSize * 2) * (textureSize * 2) * 4 <= m_createInfo.textureFootprint) {
+        textureSize *= 2;
+    }
+    void *stagingBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STAGING, 0, (size_t)textureSize * textureSize * 4, nullptr});
+    for (uint32_t i = 0; i < m_createInfo.materialCount; i++) {
+        CreateMaterial(random, textureSize, stagingBuffer);
+    }
+    m_graphicsAPI->DestroyBuffer(stagingBuffer);
+
+    // Lights.
+    const float extent = m_createInfo.extent;
+    m_sceneUniforms.lightCount[0] = m_createInfo.lightCount;
+    for (uint32_t i = 0; i < m_createInfo.lightCount; i++) {
+        m_sceneUniforms.lightPositions[i] = {random.Range(-extent, extent), random.Range(-extent, extent), random.Range(-extent, extent), extent * random.Range(0.25f, 0.75f)};
+        m_sceneUniforms.lightColors[i] = {random.Range(0.5f, 4.0f), random.Range(0.5f, 4.0f), random.Range(0.5f, 4.0f), 1.0f};
+    }
+    m_sceneUniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(SceneUniforms), nullptr});
+
+    // Objects, with their uniforms in the draw order.
+    std::vector<std::pair<Object, ObjectUniforms>> objects(m_createInfo.objectCount);
+    for (std::pair<Object, ObjectUniforms> &object : objects) {
+        object.first.mesh = random.Index(m_createInfo.meshCount);
+        object.first.material = random.Index(m_createInfo.materialCount);
+
+        XrVector3f axis = {random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f)};
+        XrVector3f_Normalize(&axis);
+        XrPosef pose;
+        XrQuaternionf_CreateFromAxisAngle(&pose.orientation, &axis, random.Range(0.0f, 6.2831853f));
+        pose.position = {random.Range(-extent, extent), random.Range(-extent, extent), random.Range(-extent, extent)};
+        const float scale = random.Range(0.5f, 2.0f);
+        const XrVector3f scale3 = {scale, scale, scale};
+        XrMatrix4x4f_CreateTranslationRotationScale(&object.second.model, &pose.position, &pose.orientation, &scale3);
+        object.second.tint = {random.Range(0.5f, 1.0f), random.Range(0.5f, 1.0f), random.Range(0.5f, 1.0f), 1.0f};
+    }
+    if (m_createInfo.sortByState) {
+        std::stable_sort(objects.begin(), objects.end(), [](const std::pair<Object, ObjectUniforms> &a, const std::pair<Object, ObjectUniforms> &b) {
+            return a.first.material != b.first.material ? a.first.material < b.first.material : a.first.mesh < b.first.mesh;
+        });
+    }
+    std::vector<uint8_t> objectUniforms(std::max<size_t>(objects.size(), 1) * objectUniformStride);
+    for (size_t i = 0; i < objects.size(); i++) {
+        m_objects.push_back(objects[i].first);
+        memcpy(objectUniforms.data() + i * objectUniformStride, &objects[i].second, sizeof(ObjectUniforms));
+    }
+    m_objectUniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, objectUniforms.size(), objectUniforms.data()});
+}
+
+StressScene::~StressScene() {
+    for (Material &material : m_materials) {
+        m_graphicsAPI->DestroyPipeline(material.pipeline);
+        m_graphicsAPI->DestroyImage(material.image);
+    }
+    for (Mesh &mesh : m_meshes) {
+        m_graphicsAPI->DestroyBuffer(mesh.vertexBuffer);
+        m_graphicsAPI->DestroyBuffer(mesh.indexBuffer);
+    }
+    for (void *&fragmentShader : m_fragmentShaders) {
+        m_graphicsAPI->DestroyShader(fragmentShader);
+    }
+    if (m_vertexShader) {
+        m_graphicsAPI->DestroyShader(m_vertexShader);
+    }
+    if (m_sampler) {
+        m_graphicsAPI->DestroySampler(m_sampler);
+    }
+    if (m_sceneUniformBuffer) {
+        m_graphicsAPI->DestroyBuffer(m_sceneUniformBuffer);
+    }
+    if (m_objectUniformBuffer) {
+        m_graphicsAPI->DestroyBuffer(m_objectUniformBuffer);
+    }
+}
+
+void StressScene::CreateMesh(Random &random) {
+    // A sphere of unit diameter with a random tessellation, radially displaced by a random wave.
+    const uint32_t rings = 4 + random.Index(29);
+    const uint32_t segments = rings * 2;
+    const float amplitude = random.Range(0.0f, 0.3f);
+    const float ringFrequency = static_cast<float>(1 + random.Index(6));
+    const float segmentFrequency = static_cast<float>(1 + random.Index(6));
+    const float phase = random.Range(0.0f, 6.2831853f);
+
+    std::vector<Vertex> vertices;
+    for (uint32_t r = 0; r <= rings; r++) {
+        const float theta = 3.14159265f * static_cast<float>(r) / static_cast<float>(rings);
+        for (uint32_t s = 0; s <= segments; s++) {
+            const float phi = 6.2831853f * static_cast<float>(s) / static_cast<float>(segments);
+            const XrVector3f direction = {sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)};
+            const float radius = 0.5f * (1.0f + amplitude * sinf(ringFrequency * theta + phase) * cosf(segmentFrequency * phi));
+            Vertex vertex;
+            vertex.position[0] = direction.x * radius;
+            vertex.position[1] = direction.y * radius;
+            vertex.position[2] = direction.z * radius;
+            vertex.normal[0] = direction.x;
+            vertex.normal[1] = direction.y;
+            vertex.normal[2] = direction.z;
+            vertex.texCoord[0] = static_cast<float>(s) / static_cast<float>(segments);
+            vertex.texCoord[1] = static_cast<float>(r) / static_cast<float>(rings);
+            vertices.push_back(vertex);
+        }
+    }
+    // Counter-clockwise seen from outside.
+    std::vector<uint32_t> indices;
+    for (uint32_t r = 0; r < rings; r++) {
+        for (uint32_t s = 0; s < segments; s++) {
+            const uint32_t i0 = r * (segments + 1) + s;
+            const uint32_t i1 = i0 + segments + 1;
+            indices.insert(indices.end(), {i0, i0 + 1, i1, i0 + 1, i1 + 1, i1});
+        }
+    }
+
+    Mesh mesh;
+    mesh.vertexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::VERTEX, sizeof(Vertex), vertices.size() * sizeof(Vertex), vertices.data()});
+    mesh.indexBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::INDEX, sizeof(uint32_t), indices.size() * sizeof(uint32_t), indices.data()});
+    mesh.indexCount = static_cast<uint32_t>(indices.size());
+    m_meshes.push_back(mesh);
+    m_statistics.meshBytes += vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t);
+}
+
+void StressScene::CreateMaterial(Random &random, uint32_t textureSize, void *stagingBuffer) {
+    const uint32_t index = static_cast<uint32_t>(m_materials.size());
+
+    GraphicsAPI::PipelineCreateInfo pipelineCI{};
+    pipelineCI.shaders = {m_vertexShader, m_fragmentShaders[index % m_fragmentShaders.size()]};
+    pipelineCI.vertexInputState.attributes = {{0, 0, GraphicsAPI::VertexType::VEC3, offsetof(Vertex, position), "TEXCOORD"},
+                                              {1, 0, GraphicsAPI::VertexType::VEC3, offsetof(Vertex, normal), "TEXCOORD"},
+                                              {2, 0, GraphicsAPI::VertexType::VEC2, offsetof(Vertex, texCoord), "TEXCOORD"}};
+    pipelineCI.vertexInputState.bindings = {{0, 0, sizeof(Vertex)}};
+    pipelineCI.inputAssemblyState = {GraphicsAPI::PrimitiveTopology::TRIANGLE_LIST, false};
+    pipelineCI.rasterisationState = {false, false, GraphicsAPI::PolygonMode::FILL, GraphicsAPI::CullMode::BACK, GraphicsAPI::FrontFace::COUNTER_CLOCKWISE, false, 0.0f, 0.0f, 0.0f, 1.0f};
+    pipelineCI.multisampleState = {1, false, 1.0f, 0, false, false};
+    pipelineCI.depthStencilState = {true, true, GraphicsAPI::CompareOp::LESS_OR_EQUAL, false, false, {}, {}, 0.0f, 1.0f};
+    pipelineCI.colorBlendState = {false, GraphicsAPI::LogicOp::NO_OP, {{false, GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ZERO, GraphicsAPI::BlendOp::ADD, GraphicsAPI::BlendFactor::ONE, GraphicsAPI::BlendFactor::ZERO, GraphicsAPI::BlendOp::ADD, (GraphicsAPI::ColorComponentBit)15}}, {0.0f, 0.0f, 0.0f, 0.0f}};
+    pipelineCI.colorFormats = {m_createInfo.colorFormat};
+    pipelineCI.depthFormat = m_createInfo.depthFormat;
+    pipelineCI.layout = {{0, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX},
+                         {1, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX},
+                         {2, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                         {2, nullptr, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}};
+
+    // A checkerboard of two random colors with a random cell count.
+    const uint32_t cells = 1u << random.Index(6);
+    const uint32_t cellSize = std::max(textureSize / cells, 1u);
+    const uint8_t colors[2][4] = {{(uint8_t)random.Index(256), (uint8_t)random.Index(256), (uint8_t)random.Index(256), 255},
+                                  {(uint8_t)random.Index(256), (uint8_t)random.Index(256), (uint8_t)random.Index(256), 255}};
+    std::vector<uint8_t> texels((size_t)textureSize * textureSize * 4);
+    for (uint32_t y = 0; y < textureSize; y++) {
+        for (uint32_t x = 0; x < textureSize; x++) {
+            memcpy(&texels[((size_t)y * textureSize + x) * 4], colors[((x / cellSize) + (y / cellSize)) & 1], 4);
+        }
+    }
+
+    Material material;
+    material.pipeline = m_graphicsAPI->CreatePipeline(pipelineCI);
+    material.image = m_graphicsAPI->CreateImage({2, textureSize, textureSize, 1, 1, 1, 1, m_createInfo.colorFormat, false, false, false, true});
+    m_graphicsAPI->SetBufferData(stagingBuffer, 0, texels.size(), texels.data());
+    GraphicsAPI::BufferImageCopy region{};
+    region.imageSubresource = {0, 0, 1};
+    region.imageExtent = {textureSize, textureSize, 1};
+    m_graphicsAPI->CopyBufferToImage(stagingBuffer, material.image, region);
+    m_materials.push_back(material);
+    m_statistics.textureBytes += texels.size();
+}
+
+void StressScene::Draw(const XrMatrix4x4f &viewProjection, void *colorImageView, void *depthImageView, uint32_t width, uint32_t height) {
+    m_statistics.draws = 0;
+    m_statistics.pipelineChanges = 0;
+    m_statistics.meshChanges = 0;
+    m_statistics.textureChanges = 0;
+    m_statistics.triangles = 0;
+    if (m_materials.empty()) {
+        return;
+    }
+
+    m_sceneUniforms.viewProjection = viewProjection;
+    m_graphicsAPI->SetBufferData(m_sceneUniformBuffer, 0, sizeof(SceneUniforms), &m_sceneUniforms);
+
+    m_graphicsAPI->SetRenderAttachments(&colorImageView, 1, depthImageView, width, height, m_materials[0].pipeline);
+    GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f};
+    GraphicsAPI::Rect2D scissor = {{0, 0}, {width, height}};
+    m_graphicsAPI->SetViewports(&viewport, 1);
+    m_graphicsAPI->SetScissors(&scissor, 1);
+
+    uint32_t currentMaterial = ~0u;
+    uint32_t currentMesh = ~0u;
+    for (size_t i = 0; i < m_objects.size(); i++) {
+        const Object &object = m_objects[i];
+        if (object.material != currentMaterial) {
+            const Material &material = m_materials[object.material];
+            m_graphicsAPI->SetPipeline(material.pipeline);
+            m_graphicsAPI->SetDescriptor({0, m_sceneUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, 0, sizeof(SceneUniforms)});
+            m_graphicsAPI->SetDescriptor({2, material.image, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+            m_graphicsAPI->SetDescriptor({2, m_sampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+            currentMaterial = object.material;
+            m_statistics.pipelineChanges++;
+            m_statistics.textureChanges++;
+        }
+        const Mesh &mesh = m_meshes[object.mesh];
+        if (object.mesh != currentMesh) {
+            m_graphicsAPI->SetVertexBuffers(const_cast<void **>(&mesh.vertexBuffer), 1);
+            m_graphicsAPI->SetIndexBuffer(mesh.indexBuffer);
+            currentMesh = object.mesh;
+            m_statistics.meshChanges++;
+        }
+        m_graphicsAPI->SetDescriptor({1, m_objectUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::VERTEX, false, i * objectUniformStride, sizeof(ObjectUniforms)});
+        m_graphicsAPI->UpdateDescriptors();
+        m_graphicsAPI->DrawIndexed(mesh.indexCount);
+        m_statistics.draws++;
+        m_statistics.triangles += mesh.indexCount / 3;
+    }
+}
+
+std::vector<StressScene::ScalingResult> StressScene::RunScalingBenchmark(GraphicsAPI *graphicsAPI, const CreateInfo &createInfo, const std::vector<uint32_t> &objectCounts,
+                                                                         uint32_t viewCount, const std::string &reportPath) {
+    std::vector<ScalingResult> results;
+    if (viewCount == 0) {
+        return results;
+    }
+
+    // Views orbiting the scene, looking at its center.
+    std::vector<XrView> views(viewCount, {XR_TYPE_VIEW});
+    const XrVector3f up = {0.0f, 1.0f, 0.0f};
+    for (uint32_t i = 0; i < viewCount; i++) {
+        const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(viewCount);
+        XrQuaternionf_CreateFromAxisAngle(&views[i].pose.orientation, &up, angle);
+        views[i].pose.position = {sinf(angle) * createInfo.extent * 2.5f, 0.0f, cosf(angle) * createInfo.extent * 2.5f};
+        views[i].fov = {-0.4f, 0.4f, 0.4f, -0.4f};
+    }
+
+    BatchRenderer::CreateInfo batchRendererCI;
+    batchRendererCI.colorFormat = createInfo.colorFormat;
+    batchRendererCI.depthFormat = createInfo.depthFormat;
+    batchRendererCI.farZ = createInfo.extent * 5.0f;
+    const std::vector<XrView> warmUpViews(views.begin(), views.begin() + std::min(batchRendererCI.viewsPerBatch, viewCount));
+
+    for (uint32_t objectCount : objectCounts) {
+        CreateInfo sceneCI = createInfo;
+        sceneCI.objectCount = objectCount;
+        StressScene scene(graphicsAPI, sceneCI);
+
+        // Each view's draws are bracketed with timestamps, which are read once all views have completed.
+        std::vector<void *> queries;
+        for (uint32_t i = 0; i < viewCount * 2; i++) {
+            queries.push_back(graphicsAPI->CreateTimestampQuery());
+        }
+        bool measure = false;
+        uint32_t viewIndex = 0;
+        double cpuSeconds = 0.0;
+        {
+            BatchRenderer batchRenderer(graphicsAPI, batchRendererCI, [&](const XrView &, const XrMatrix4x4f &viewProjection, void *colorImageView, void *depthImageView, uint32_t width, uint32_t height) {
+                if (measure) {
+                    graphicsAPI->WriteTimestamp(queries[viewIndex * 2]);
+                }
+                const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                scene.Draw(viewProjection, colorImageView, depthImageView, width, height);
+                if (measure) {
+                    cpuSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                    graphicsAPI->WriteTimestamp(queries[viewIndex * 2 + 1]);
+                    viewIndex++;
+                }
+            });
+            if (!batchRenderer.IsValid()) {
+                break;
+            }
+            // The first submission after creating the scene includes uploads and shader compilation.
+            batchRenderer.Render(warmUpViews);
+            measure = true;
+            batchRenderer.Render(views);
+        }
+
+        uint64_t gpuNanoseconds = 0;
+        for (uint32_t i = 0; i < viewCount; i++) {
+            uint64_t begin = 0;
+            uint64_t end = 0;
+            if (graphicsAPI->GetTimestamp(queries[i * 2], begin) && graphicsAPI->GetTimestamp(queries[i * 2 + 1], end) && end > begin) {
+                gpuNanoseconds += end - begin;
+            }
+        }
+        for (void *&query : queries) {
+            graphicsAPI->DestroyTimestampQuery(query);
+        }
+
+        ScalingResult result;
+        result.objectCount = objectCount;
+        result.statistics = scene.GetStatistics();
+        result.cpuMs = static_cast<float>(cpuSeconds * 1000.0 / viewCount);
+        result.gpuMs = static_cast<float>(static_cast<double>(gpuNanoseconds) * 1e-6 / viewCount);
+        results.push_back(result);
+        std::cout << "StressScene: " << objectCount << " objects: " << result.statistics.draws << " draws, " << result.statistics.pipelineChanges << " pipeline changes, "
+                  << result.statistics.meshChanges << " mesh changes, CPU " << result.cpuMs << " ms, GPU " << result.gpuMs << " ms." << std::endl;
+    }
+
+    if (!reportPath.empty()) {
+        std::ofstream report(reportPath);
+        if (!report.is_open()) {
+            std::cout << "ERROR: StressScene: Failed to create " << reportPath << "." << std::endl;
+            return results;
+        }
+        report << "objects,draws,pipelineChanges,meshChanges,textureChanges,stateChanges,triangles,cpuMs,gpuMs\n";
+        for (const ScalingResult &result : results) {
+            const Statistics &statistics = result.statistics;
+            report << result.objectCount << "," << statistics.draws << "," << statistics.pipelineChanges << "," << statistics.meshChanges << "," << statistics.textureChanges << ","
+                   << statistics.pipelineChanges + statistics.meshChanges + statistics.textureChanges << "," << statistics.triangles << "," << result.cpuMs << "," << result.gpuMs << "\n";
+        }
+    }
+    return results;
+}
@@ -0,0 +1,136 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+#include <xr_linear_algebra.h>
+
+// A procedurally generated scene for scaling benchmarks. From a seed, it creates objectCount objects, which instance
+// meshCount unique meshes with materialCount materials, lit by lightCount point lights. Each material has its own
+// pipeline and texture. The textures share textureFootprint bytes. The same seed and counts always generate the same
+// scene, so that measurements before and after an optimization are comparable.
+//
+// Each object is one draw. Draw() counts the draws and the state changes between them, which are the pipeline, the
+// vertex and index buffers and the texture. Objects are drawn in the order of their material and mesh if sortByState is
+// set, and in generation order otherwise.
+class StressScene {
+public:
+    struct CreateInfo {
+        uint64_t seed = 1;
+        uint32_t objectCount = 1000;
+        uint32_t meshCount = 16;
+        uint32_t materialCount = 8;
+        uint32_t lightCount = 8;  // At most maxLights.
+        size_t textureFootprint = 64 * 1024 * 1024;
+        // Objects are placed within a cube of this half size around the origin.
+        float extent = 20.0f;
+        bool sortByState = true;
+        // API specific formats of the render targets. colorFormat must have four channels with eight bits each, e.g.
+        // GL_RGBA8, as it is also used for the textures.
+        int64_t colorFormat;
+        int64_t depthFormat;
+    };
+
+    struct Statistics {
+        uint32_t draws;
+        uint32_t pipelineChanges;
+        uint32_t meshChanges;
+        uint32_t textureChanges;
+        uint64_t triangles;
+        size_t meshBytes;
+        size_t textureBytes;
+    };
+
+    // One row of the scaling report. The times are averages per view.
+    struct ScalingResult {
+        uint32_t objectCount;
+        Statistics statistics;
+        float cpuMs;
+        float gpuMs;
+    };
+
+    static constexpr uint32_t maxLights = 64;
+
+    StressScene(GraphicsAPI* graphicsAPI, const CreateInfo& createInfo);
+    ~StressScene();
+
+    // Draws all objects into the attachments. Statistics are for the last call.
+    void Draw(const XrMatrix4x4f& viewProjection, void* colorImageView, void* depthImageView, uint32_t width, uint32_t height);
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+    // Renders viewCount views orbiting the scene for each of the objectCounts, on the BatchRenderer and without OpenXR,
+    // and measures the CPU time of recording the draws and their GPU time. The results are printed and, if reportPath is
+    // not empty, written as CSV.
+    static std::vector<ScalingResult> RunScalingBenchmark(GraphicsAPI* graphicsAPI, const CreateInfo& createInfo, const std::vector<uint32_t>& objectCounts,
+                                                          uint32_t viewCount, const std::string& reportPath);
+
+private:
+    struct Vertex {
+        float position[3];
+        float normal[3];
+        float texCoord[2];
+    };
+    struct Mesh {
+        void* vertexBuffer;
+        void* indexBuffer;
+        uint32_t indexCount;
+    };
+    struct Material {
+        void* pipeline;
+        void* image;
+    };
+    struct Object {
+        uint32_t mesh;
+        uint32_t material;
+    };
+
+    // Matches the std140 uniform blocks in the shaders.
+    struct SceneUniforms {
+        XrMatrix4x4f viewProjection;
+        XrVector4f lightPositions[maxLights];  // xyz: Position, w: Radius.
+        XrVector4f lightColors[maxLights];
+        uint32_t lightCount[4];
+    };
+    struct ObjectUniforms {
+        XrMatrix4x4f model;
+        XrVector4f tint;
+    };
+    // Per object uniforms are bound at offsets in one buffer, which must be multiples of the uniform buffer offset
+    // alignment. 256 bytes satisfies all common implementations.
+    static constexpr size_t objectUniformStride = 256;
+
+    // A portable generator, so that a seed generates the same scene with all standard libraries.
+    class Random {
+    public:
+        Random(uint64_t seed) : m_state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+        uint64_t Next();
+        float Float() { return static_cast<float>(Next() >> 40) / static_cast<float>(1 << 24); }
+        float Range(float min, float max) { return min + (max - min) * Float(); }
+        uint32_t Index(uint32_t count) { return static_cast<uint32_t>(Next() % count); }
+
+    private:
+        uint64_t m_state;
+    };
+
+    void CreateMesh(Random& random);
+    void CreateMaterial(Random& random, uint32_t textureSize, void* stagingBuffer);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    CreateInfo m_createInfo;
+    Statistics m_statistics{};
+
+    void* m_vertexShader = nullptr;
+    std::vector<void*> m_fragmentShaders;  // Per shading variant.
+    void* m_sampler = nullptr;
+    void* m_sceneUniformBuffer = nullptr;
+    void* m_objectUniformBuffer = nullptr;
+    SceneUniforms m_sceneUniforms{};
+
+    std::vector<Mesh> m_meshes;
+    std::vector<Material> m_materials;
+    std::vector<Object> m_objects;
+};
@@ -0,0 +1,371 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <TemporalUpscaler.h>
+
+// GLSL 4.50 fragment shaders.
+static const char *motionVectorShaderSource = R"(
+#version 450
+layout(location = 0) in vec2 i_TexCoord;
+layout(location = 0) out vec2 o_MotionVector;
+
+layout(binding = 0) uniform sampler2D depthImage;
+layout(std140, binding = 1) uniform MotionVectorUniforms {
+    mat4 inverseJitteredViewProjection;
+    mat4 viewProjection;
+    mat4 previousViewProjection;
+};
+
+void main() {
+    float depth = texelFetch(depthImage, ivec2(gl_FragCoord.xy), 0).r;
+    vec4 position = inverseJitteredViewProjection * vec4(vec3(i_TexCoord, depth) * 2.0 - 1.0, 1.0);
+    position /= position.w;
+    vec4 current = viewProjection * position;
+    vec4 previous = previousViewProjection * position;
+    o_MotionVector = (current.xy / current.w - previous.xy / previous.w) * 0.5;
+}
+)";
+
+static const char *resolveShaderSource = R"(
+#version 450
+layout(location = 0) in vec2 i_TexCoord;
+layout(location = 0) out vec4 o_Color;
+layout(location = 1) out vec4 o_History;
+
+layout(binding = 0) uniform sampler2D currentColor;
+layout(binding = 1) uniform sampler2D motionVectors;
+layout(binding = 2) uniform sampler2D depthImage;
+layout(binding = 3) uniform sampler2D historyColor;
+layout(std140, binding = 4) uniform ResolveUniforms {
+    vec2 jitter;
+    vec2 renderSize;
+    float blendFactor;
+    float historyValid;
+};
+
+vec3 RGBToYCoCg(vec3 c) {
+    return vec3(dot(c, vec3(0.25, 0.5, 0.25)), dot(c, vec3(0.5, 0.0, -0.5)), dot(c, vec3(-0.25, 0.5, -0.25)));
+}
+
+vec3 YCoCgToRGB(vec3 c) {
+    return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+void main() {
+    // The scene point of this output pixel was rendered jitter render pixels away from its unjittered position.
+    vec2 renderPosition = i_TexCoord * renderSize + jitter;
+    vec4 current = textureLod(currentColor, renderPosition / renderSize, 0.0);
+
+    // The color bounds of the 3x3 neighborhood, and the motion of its closest surface, so that the history of
+    // foreground edges follows the foreground.
+    ivec2 maxTexel = ivec2(renderSize) - 1;
+    ivec2 center = clamp(ivec2(renderPosition), ivec2(0), maxTexel);
+    vec3 minColor = vec3(1e30);
+    vec3 maxColor = vec3(-1e30);
+    float closestDepth = 2.0;
+    ivec2 closestTexel = center;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            ivec2 texel = clamp(center + ivec2(x, y), ivec2(0), maxTexel);
+            vec3 color = RGBToYCoCg(texelFetch(currentColor, texel, 0).rgb);
+            minColor = min(minColor, color);
+            maxColor = max(maxColor, color);
+            float depth = texelFetch(depthImage, texel, 0).r;
+            if (depth < closestDepth) {
+                closestDepth = depth;
+                closestTexel = texel;
+            }
+        }
+    }
+
+    vec3 result = current.rgb;
+    vec2 historyTexCoord = i_TexCoord - texelFetch(motionVectors, closestTexel, 0).xy;
+    if (historyValid > 0.5 && all(greaterThanEqual(historyTexCoord, vec2(0.0))) && all(lessThanEqual(historyTexCoord, vec2(1.0)))) {
+        // Clamping rejects history that no longer matches the current neighborhood, e.g. after disocclusion.
+        vec3 history = clamp(RGBToYCoCg(textureLod(historyColor, historyTexCoord, 0.0).rgb), minColor, maxColor);
+        result = mix(YCoCgToRGB(history), current.rgb, blendFactor);
+    }
+    o_Color = vec4(result, current.a);
+    o_History = o_Color;
+}
+)";
+
+// A checkerboard that scrolls with offset, for CheckDeterminism().
+static const char *checkPatternShaderSource = R"(
+#version 450
+layout(location = 0) in vec2 i_TexCoord;
+layout(location = 0) out vec4 o_Color;
+layout(std140, binding = 0) uniform PatternUniforms {
+    vec4 offset;
+};
+void main() {
+    vec2 cell = floor((i_TexCoord + offset.xy) * 16.0);
+    o_Color = vec4(mod(cell.x + cell.y, 2.0), i_TexCoord, 1.0);
+    gl_FragDepth = 0.5;
+}
+)";
+
+static const char *motionVectorGLSLSource = R"(
+vec2 TemporalUpscalerMotionVector(vec4 clipPosition, vec4 previousClipPosition) {
+    return (clipPosition.xy / clipPosition.w - previousClipPosition.xy / previousClipPosition.w) * 0.5;
+}
+)";
+
+TemporalUpscaler::TemporalUpscaler(GraphicsAPI *graphicsAPI, uint32_t viewCount, uint32_t outputWidth, uint32_t outputHeight, float renderScale,
+                                   int64_t colorFormat, int64_t depthFormat, int64_t motionVectorFormat)
+    : m_graphicsAPI(graphicsAPI), m_outputWidth(outputWidth), m_outputHeight(outputHeight) {
+    m_renderWidth = std::max(static_cast<uint32_t>(static_cast<float>(outputWidth) * renderScale + 0.5f), 1u);
+    m_renderHeight = std::max(static_cast<uint32_t>(static_cast<float>(outputHeight) * renderScale + 0.5f), 1u);
+
+    m_views.resize(viewCount);
+    for (ViewTargets &view : m_views) {
+        view.colorImage = m_graphicsAPI->CreateImage({2, m_renderWidth, m_renderHeight, 1, 1, 1, 1, colorFormat, false, true, false, true});
+        view.colorImageView = m_graphicsAPI->CreateImageView({view.colorImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+        view.depthImage = m_graphicsAPI->CreateImage({2, m_renderWidth, m_renderHeight, 1, 1, 1, 1, depthFormat, false, false, true, true});
+        view.depthImageView = m_graphicsAPI->CreateImageView({view.depthImage, GraphicsAPI::ImageViewCreateInfo::Type::DSV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, depthFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::DEPTH_BIT, 0, 1, 0, 1});
+        view.motionVectorImage = m_graphicsAPI->CreateImage({2, m_renderWidth, m_renderHeight, 1, 1, 1, 1, motionVectorFormat, false, true, false, true});
+        view.motionVectorImageView = m_graphicsAPI->CreateImageView({view.motionVectorImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, motionVectorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+        for (uint32_t i = 0; i < 2; i++) {
+            view.historyImages[i] = m_graphicsAPI->CreateImage({2, m_outputWidth, m_outputHeight, 1, 1, 1, 1, colorFormat, false, true, false, true});
+            view.historyImageViews[i] = m_graphicsAPI->CreateImageView({view.historyImages[i], GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+        }
+    }
+
+    GraphicsAPI::SamplerCreateInfo samplerCI{};
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.mipmapMode = GraphicsAPI::SamplerCreateInfo::MipmapMode::NOOP;
+    samplerCI.addressModeS = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeT = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeR = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.compareOp = GraphicsAPI::CompareOp::NEVER;
+    m_linearSampler = m_graphicsAPI->CreateSampler(samplerCI);
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    m_nearestSampler = m_graphicsAPI->CreateSampler(samplerCI);
+    m_motionVectorUniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(MotionVectorUniforms), nullptr});
+    m_resolveUniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(ResolveUniforms), nullptr});
+
+    m_motionVectorPass = std::make_unique<FullscreenPass>(m_graphicsAPI, motionVectorShaderSource, std::vector<int64_t>{motionVectorFormat},
+                                                          std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                   {1, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}});
+    m_resolvePass = std::make_unique<FullscreenPass>(m_graphicsAPI, resolveShaderSource, std::vector<int64_t>{colorFormat, colorFormat},
+                                                     std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                              {1, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                              {2, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                              {3, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                              {4, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}});
+}
+
+TemporalUpscaler::~TemporalUpscaler() {
+    m_resolvePass.reset();
+    m_motionVectorPass.reset();
+    m_graphicsAPI->DestroyBuffer(m_resolveUniformBuffer);
+    m_graphicsAPI->DestroyBuffer(m_motionVectorUniformBuffer);
+    m_graphicsAPI->DestroySampler(m_nearestSampler);
+    m_graphicsAPI->DestroySampler(m_linearSampler);
+    for (ViewTargets &view : m_views) {
+        for (uint32_t i = 0; i < 2; i++) {
+            m_graphicsAPI->DestroyImageView(view.historyImageViews[i]);
+            m_graphicsAPI->DestroyImage(view.historyImages[i]);
+        }
+        m_graphicsAPI->DestroyImageView(view.motionVectorImageView);
+        m_graphicsAPI->DestroyImage(view.motionVectorImage);
+        m_graphicsAPI->DestroyImageView(view.depthImageView);
+        m_graphicsAPI->DestroyImage(view.depthImage);
+        m_graphicsAPI->DestroyImageView(view.colorImageView);
+        m_graphicsAPI->DestroyImage(view.colorImage);
+    }
+}
+
+void TemporalUpscaler::ResetHistory() {
+    for (ViewTargets &view : m_views) {
+        view.historyValid = false;
+        view.previousValid = false;
+    }
+}
+
+void TemporalUpscaler::BeginFrame() {
+    // An 8 sample Halton(2, 3) sequence covers the pixel evenly. Index 0 is skipped, as it is (0, 0) in both bases.
+    const uint32_t sampleIndex = (m_frameIndex % 8) + 1;
+    m_jitter[0] = Halton(sampleIndex, 2) - 0.5f;
+    m_jitter[1] = Halton(sampleIndex, 3) - 0.5f;
+    m_frameIndex++;
+}
+
+void TemporalUpscaler::SetView(uint32_t viewIndex, const XrView &xrView, float nearZ, float farZ) {
+    ViewTargets &view = m_views[viewIndex];
+
+    XrMatrix4x4f projection;
+    XrMatrix4x4f_CreateProjectionFov(&projection, OPENGL, xrView.fov, nearZ, farZ);
+    XrMatrix4x4f toView;
+    XrMatrix4x4f_CreateFromRigidTransform(&toView, &xrView.pose);
+    XrMatrix4x4f viewMatrix;
+    XrMatrix4x4f_InvertRigidBody(&viewMatrix, &toView);
+
+    view.previousViewProjection = view.viewProjection;
+    XrMatrix4x4f_Multiply(&view.viewProjection, &projection, &viewMatrix);
+    if (!view.previousValid) {
+        view.previousViewProjection = view.viewProjection;
+        view.previousValid = true;
+    }
+
+    // Offsetting the projection's z column shifts the image by the jitter, in normalized device coordinates.
+    projection.m[8] -= 2.0f * m_jitter[0] / static_cast<float>(m_renderWidth);
+    projection.m[9] -= 2.0f * m_jitter[1] / static_cast<float>(m_renderHeight);
+    XrMatrix4x4f_Multiply(&view.jitteredViewProjection, &projection, &viewMatrix);
+}
+
+void TemporalUpscaler::GenerateMotionVectors(uint32_t viewIndex) {
+    ViewTargets &view = m_views[viewIndex];
+
+    MotionVectorUniforms uniforms;
+    XrMatrix4x4f_Invert(&uniforms.inverseJitteredViewProjection, &view.jitteredViewProjection);
+    uniforms.viewProjection = view.viewProjection;
+    uniforms.previousViewProjection = view.previousViewProjection;
+    m_graphicsAPI->SetBufferData(m_motionVectorUniformBuffer, 0, sizeof(MotionVectorUniforms), &uniforms);
+
+    m_graphicsAPI->SetRenderAttachments(&view.motionVectorImageView, 1, nullptr, m_renderWidth, m_renderHeight, m_motionVectorPass->GetPipeline());
+    SetRenderTargetState(m_renderWidth, m_renderHeight);
+    m_graphicsAPI->SetPipeline(m_motionVectorPass->GetPipeline());
+    m_graphicsAPI->SetDescriptor({0, view.depthImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({0, m_nearestSampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({1, m_motionVectorUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT, false, 0, sizeof(MotionVectorUniforms)});
+    m_graphicsAPI->UpdateDescriptors();
+    m_motionVectorPass->Draw();
+
+    // Moving objects are drawn over the camera motion, depth tested against the opaque content.
+    m_graphicsAPI->SetRenderAttachments(&view.motionVectorImageView, 1, view.depthImageView, m_renderWidth, m_renderHeight, nullptr);
+    SetRenderTargetState(m_renderWidth, m_renderHeight);
+}
+
+void TemporalUpscaler::Resolve(uint32_t viewIndex, void *outputColorImageView) {
+    ViewTargets &view = m_views[viewIndex];
+    const uint32_t nextHistoryIndex = view.historyIndex ^ 1;
+
+    // A blend factor of 0.1 averages roughly the last 10 frames, which covers the jitter sequence.
+    ResolveUniforms uniforms = {{m_jitter[0], m_jitter[1]}, {static_cast<float>(m_renderWidth), static_cast<float>(m_renderHeight)}, 0.1f, view.historyValid ? 1.0f : 0.0f, {0.0f, 0.0f}};
+    m_graphicsAPI->SetBufferData(m_resolveUniformBuffer, 0, sizeof(ResolveUniforms), &uniforms);
+
+    void *colorViews[2] = {outputColorImageView, view.historyImageViews[nextHistoryIndex]};
+    m_graphicsAPI->SetRenderAttachments(colorViews, 2, nullptr, m_outputWidth, m_outputHeight, m_resolvePass->GetPipeline());
+    SetRenderTargetState(m_outputWidth, m_outputHeight);
+    m_graphicsAPI->SetPipeline(m_resolvePass->GetPipeline());
+    m_graphicsAPI->SetDescriptor({0, view.colorImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({0, m_linearSampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({1, view.motionVectorImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({1, m_nearestSampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({2, view.depthImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({2, m_nearestSampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({3, view.historyImages[view.historyIndex], GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({3, m_linearSampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({4, m_resolveUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT, false, 0, sizeof(ResolveUniforms)});
+    m_graphicsAPI->UpdateDescriptors();
+    m_resolvePass->Draw();
+
+    view.historyIndex = nextHistoryIndex;
+    view.historyValid = true;
+}
+
+const char *TemporalUpscaler::GetGLSLSource() {
+    return motionVectorGLSLSource;
+}
+
+bool TemporalUpscaler::CheckDeterminism(GraphicsAPI *graphicsAPI, int64_t colorFormat, int64_t depthFormat, int64_t motionVectorFormat) {
+    // The samples 1 to 8 of Halton(2) and Halton(3).
+    const float expectedJitter[8][2] = {{1.0f / 2.0f, 1.0f / 3.0f}, {1.0f / 4.0f, 2.0f / 3.0f}, {3.0f / 4.0f, 1.0f / 9.0f}, {1.0f / 8.0f, 4.0f / 9.0f},
+                                        {5.0f / 8.0f, 7.0f / 9.0f}, {3.0f / 8.0f, 2.0f / 9.0f}, {7.0f / 8.0f, 5.0f / 9.0f}, {1.0f / 16.0f, 8.0f / 9.0f}};
+    const uint32_t outputSize = 64;
+    const uint32_t frameCount = 16;
+    const size_t outputBytes = (size_t)outputSize * outputSize * 4;
+
+    void *patternUniformBuffer = graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(float) * 4, nullptr});
+    std::unique_ptr<FullscreenPass> patternPass = std::make_unique<FullscreenPass>(graphicsAPI, checkPatternShaderSource, std::vector<int64_t>{colorFormat},
+                                                                                   std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}}, nullptr, depthFormat);
+    void *outputImage = graphicsAPI->CreateImage({2, outputSize, outputSize, 1, 1, 1, 1, colorFormat, false, true, false, false});
+    void *outputImageView = graphicsAPI->CreateImageView({outputImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, colorFormat, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+    void *readbackBuffer = graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::READBACK, 0, outputBytes, nullptr});
+
+    bool passed = true;
+    std::vector<uint8_t> outputs[2];
+    for (uint32_t run = 0; run < 2 && passed; run++) {
+        TemporalUpscaler upscaler(graphicsAPI, 1, outputSize, outputSize, 0.5f, colorFormat, depthFormat, motionVectorFormat);
+        for (uint32_t frame = 0; frame < frameCount && passed; frame++) {
+            upscaler.BeginFrame();
+            for (uint32_t axis = 0; axis < 2; axis++) {
+                const float expected = expectedJitter[frame % 8][axis] - 0.5f;
+                if (std::fabs(upscaler.m_jitter[axis] - expected) > 1e-6f) {
+                    std::cout << "ERROR: TemporalUpscaler: Jitter " << axis << " of frame " << frame << " is " << upscaler.m_jitter[axis] << " instead of " << expected << "." << std::endl;
+                    passed = false;
+                }
+            }
+
+            // A slowly turning view, so that the history is reprojected with non-zero motion vectors.
+            XrView view{XR_TYPE_VIEW};
+            const float angle = 0.01f * (float)frame;
+            view.pose = {{0.0f, std::sin(angle * 0.5f), 0.0f, std::cos(angle * 0.5f)}, {0.0f, 0.0f, 0.0f}};
+            view.fov = {-0.785f, 0.785f, 0.785f, -0.785f};
+            upscaler.SetView(0, view, 0.05f, 100.0f);
+
+            graphicsAPI->BeginRendering();
+            float offset[4] = {0.02f * (float)frame, 0.0f, 0.0f, 0.0f};
+            graphicsAPI->SetBufferData(patternUniformBuffer, 0, sizeof(offset), offset);
+            void *colorImageView = upscaler.GetColorImageView(0);
+            graphicsAPI->SetRenderAttachments(&colorImageView, 1, upscaler.GetDepthImageView(0), upscaler.GetRenderWidth(), upscaler.GetRenderHeight(), patternPass->GetPipeline());
+            upscaler.SetRenderTargetState(upscaler.GetRenderWidth(), upscaler.GetRenderHeight());
+            graphicsAPI->SetPipeline(patternPass->GetPipeline());
+            graphicsAPI->SetDescriptor({0, patternUniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT, false, 0, sizeof(offset)});
+            graphicsAPI->UpdateDescriptors();
+            patternPass->Draw();
+            upscaler.GenerateMotionVectors(0);
+            upscaler.Resolve(0, outputImageView);
+            graphicsAPI->EndRendering();
+        }
+
+        GraphicsAPI::BufferImageCopy region{};
+        region.imageSubresource = {0, 0, 1};
+        region.imageExtent = {outputSize, outputSize, 1};
+        graphicsAPI->CopyImageToBuffer(outputImage, readbackBuffer, region);
+        void *fence = graphicsAPI->CreateFence();
+        graphicsAPI->WaitForFence(fence, ~0ull);
+        graphicsAPI->DestroyFence(fence);
+        const uint8_t *data = (const uint8_t *)graphicsAPI->MapBuffer(readbackBuffer);
+        if (data) {
+            outputs[run].assign(data, data + outputBytes);
+        }
+        graphicsAPI->UnmapBuffer(readbackBuffer);
+    }
+
+    if (passed && (outputs[0].size() != outputBytes || outputs[0] != outputs[1])) {
+        std::cout << "ERROR: TemporalUpscaler: Resolving the same frames twice gave different output." << std::endl;
+        passed = false;
+    }
+
+    graphicsAPI->DestroyBuffer(readbackBuffer);
+    graphicsAPI->DestroyImageView(outputImageView);
+    graphicsAPI->DestroyImage(outputImage);
+    patternPass.reset();
+    graphicsAPI->DestroyBuffer(patternUniformBuffer);
+    return passed;
+}
+
+float TemporalUpscaler::Halton(uint32_t index, uint32_t base) {
+    float result = 0.0f;
+    float fraction = 1.0f;
+    while (index > 0) {
+        fraction /= static_cast<float>(base);
+        result += fraction * static_cast<float>(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+void TemporalUpscaler::SetRenderTargetState(uint32_t width, uint32_t height) {
+    GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f};
+    GraphicsAPI::Rect2D scissor = {{0, 0}, {width, height}};
+    m_graphicsAPI->SetViewports(&viewport, 1);
+    m_graphicsAPI->SetScissors(&scissor, 1);
+}
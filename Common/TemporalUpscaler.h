@@ -0,0 +1,109 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <FullscreenPass.h>
+#include <xr_linear_algebra.h>
+
+// Temporal upscaling: Each view is rendered at renderScale of the output resolution, with a projection that is offset
+// by a different sub-pixel jitter every frame. Resolve() reprojects the view's history, i.e. the previous output, with
+// motion vectors, clamps it to the neighborhood of the current pixel to reject stale history, and blends the current
+// frame into it. Over a few frames the jitter samples accumulate detail beyond the render resolution.
+//
+// Per frame:
+//  1. BeginFrame(): Advances the jitter sequence.
+// Per view:
+//  2. SetView(): Computes the view's jittered projection. Render the view into GetColorImageView() and GetDepthImageView()
+//     with GetViewProjection().
+//  3. GenerateMotionVectors(): Writes the motion of static content from the depth and the view's previous pose, then sets
+//     the motion vector image and the depth as attachments, so that moving objects can overwrite their motion vectors.
+//  4. Resolve(): Writes the upscaled view into the output image and the view's history.
+//
+// The jitter only depends on the frame count, and there is no other source of randomness, so the output is deterministic
+// for a given sequence of frames, e.g. with a software rasterizer in tests.
+class TemporalUpscaler {
+public:
+    // colorFormat is also used for the history. motionVectorFormat is a two channel float format, see GraphicsAPI::GetMotionVectorFormat().
+    TemporalUpscaler(GraphicsAPI* graphicsAPI, uint32_t viewCount, uint32_t outputWidth, uint32_t outputHeight, float renderScale,
+                     int64_t colorFormat, int64_t depthFormat, int64_t motionVectorFormat);
+    ~TemporalUpscaler();
+
+    uint32_t GetRenderWidth() const { return m_renderWidth; }
+    uint32_t GetRenderHeight() const { return m_renderHeight; }
+
+    // Discards the history of all views, e.g. after a teleport or a change of scene.
+    void ResetHistory();
+
+    void BeginFrame();
+    void SetView(uint32_t viewIndex, const XrView& view, float nearZ, float farZ);
+    void GenerateMotionVectors(uint32_t viewIndex);
+    void Resolve(uint32_t viewIndex, void* outputColorImageView);
+
+    // The jittered view projection of the current frame. Use it for all draws of the view.
+    const XrMatrix4x4f& GetViewProjection(uint32_t viewIndex) const { return m_views[viewIndex].jitteredViewProjection; }
+    void* GetColorImage(uint32_t viewIndex) { return m_views[viewIndex].colorImage; }
+    void* GetColorImageView(uint32_t viewIndex) { return m_views[viewIndex].colorImageView; }
+    void* GetDepthImage(uint32_t viewIndex) { return m_views[viewIndex].depthImage; }
+    void* GetDepthImageView(uint32_t viewIndex) { return m_views[viewIndex].depthImageView; }
+
+    // Checks that the jitter sequence is Halton(2, 3) and repeats every 8 frames, and that resolving the same frames with
+    // two upscalers gives identical output. colorFormat has four bytes per texel, e.g. GL_RGBA8. Prints the first mismatch.
+    static bool CheckDeterminism(GraphicsAPI* graphicsAPI, int64_t colorFormat, int64_t depthFormat, int64_t motionVectorFormat);
+
+    // GLSL 4.50. Returns the motion vector, in texture coordinates from the previous to the current frame, which moving
+    // objects write into the motion vector image after GenerateMotionVectors(). Both positions are in unjittered clip space.
+    static const char* GetGLSLSource();
+
+private:
+    struct MotionVectorUniforms {
+        XrMatrix4x4f inverseJitteredViewProjection;
+        XrMatrix4x4f viewProjection;
+        XrMatrix4x4f previousViewProjection;
+    };
+    struct ResolveUniforms {
+        float jitter[2];      // In render pixels.
+        float renderSize[2];
+        float blendFactor;
+        float historyValid;
+        float pad[2];
+    };
+    struct ViewTargets {
+        void* colorImage;
+        void* colorImageView;
+        void* depthImage;
+        void* depthImageView;
+        void* motionVectorImage;
+        void* motionVectorImageView;
+        void* historyImages[2];
+        void* historyImageViews[2];
+        uint32_t historyIndex;
+        bool historyValid;
+        bool previousValid;
+        XrMatrix4x4f viewProjection;
+        XrMatrix4x4f previousViewProjection;
+        XrMatrix4x4f jitteredViewProjection;
+    };
+
+    static float Halton(uint32_t index, uint32_t base);
+    void SetRenderTargetState(uint32_t width, uint32_t height);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    uint32_t m_outputWidth = 0;
+    uint32_t m_outputHeight = 0;
+    uint32_t m_renderWidth = 0;
+    uint32_t m_renderHeight = 0;
+
+    uint32_t m_frameIndex = 0;
+    float m_jitter[2] = {0.0f, 0.0f};
+
+    std::vector<ViewTargets> m_views;
+    void* m_linearSampler = nullptr;
+    void* m_nearestSampler = nullptr;
+    void* m_motionVectorUniformBuffer = nullptr;
+    void* m_resolveUniformBuffer = nullptr;
+    std::unique_ptr<FullscreenPass> m_motionVectorPass;
+    std::unique_ptr<FullscreenPass> m_resolvePass;
+};
@@ -0,0 +1,98 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <TextureArrayPacker.h>
+
+TextureArrayPacker::TextureArrayPacker(GraphicsAPI *graphicsAPI, uint32_t layersPerArray)
+    : m_graphicsAPI(graphicsAPI), m_layersPerArray(std::max(layersPerArray, 2u)) {
+}
+
+TextureArrayPacker::~TextureArrayPacker() {
+    for (std::pair<const ArrayKey, std::vector<ArrayImage>> &arrays : m_arrays) {
+        for (ArrayImage &arrayImage : arrays.second) {
+            m_graphicsAPI->DestroyImage(arrayImage.image);
+        }
+    }
+    if (m_stagingBuffer) {
+        m_graphicsAPI->DestroyBuffer(m_stagingBuffer);
+    }
+}
+
+TextureArrayPacker::PackedTexture TextureArrayPacker::AddTexture(const TextureInfo &textureInfo, const void *data) {
+    // Find an array image with a free layer, or create one.
+    std::vector<ArrayImage> &arrays = m_arrays[ArrayKey(textureInfo.format, textureInfo.width, textureInfo.height, textureInfo.mipLevels)];
+    ArrayImage *arrayImage = nullptr;
+    for (ArrayImage &candidate : arrays) {
+        if (!candidate.freeLayers.empty()) {
+            arrayImage = &candidate;
+            break;
+        }
+    }
+    if (!arrayImage) {
+        ArrayImage newArrayImage;
+        newArrayImage.image = m_graphicsAPI->CreateImage({2, textureInfo.width, textureInfo.height, 1, textureInfo.mipLevels, m_layersPerArray, 1, textureInfo.format, false, false, false, true});
+        for (uint32_t layer = m_layersPerArray; layer > 0; layer--) {
+            newArrayImage.freeLayers.push_back(layer - 1);
+        }
+        arrays.push_back(std::move(newArrayImage));
+        arrayImage = &arrays.back();
+    }
+    const uint32_t layer = arrayImage->freeLayers.back();
+    arrayImage->freeLayers.pop_back();
+
+    // Upload all mip levels through the staging buffer into the layer.
+    const size_t textureSize = GetTextureSize(textureInfo);
+    if (textureSize > m_stagingBufferSize) {
+        if (m_stagingBuffer) {
+            m_graphicsAPI->DestroyBuffer(m_stagingBuffer);
+        }
+        m_stagingBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STAGING, 0, textureSize, nullptr});
+        m_stagingBufferSize = textureSize;
+    }
+    m_graphicsAPI->SetBufferData(m_stagingBuffer, 0, textureSize, const_cast<void *>(data));
+
+    size_t offset = 0;
+    for (uint32_t mip = 0; mip < textureInfo.mipLevels; mip++) {
+        const uint32_t mipWidth = std::max(textureInfo.width >> mip, 1u);
+        const uint32_t mipHeight = std::max(textureInfo.height >> mip, 1u);
+        GraphicsAPI::BufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource = {mip, layer, 1};
+        region.imageExtent = {mipWidth, mipHeight, 1};
+        m_graphicsAPI->CopyBufferToImage(m_stagingBuffer, arrayImage->image, region);
+        offset += (size_t)mipWidth * mipHeight * textureInfo.bytesPerTexel;
+    }
+
+    return {arrayImage->image, layer};
+}
+
+void TextureArrayPacker::RemoveTexture(const PackedTexture &packedTexture) {
+    for (std::pair<const ArrayKey, std::vector<ArrayImage>> &arrays : m_arrays) {
+        for (ArrayImage &arrayImage : arrays.second) {
+            if (arrayImage.image == packedTexture.image) {
+                arrayImage.freeLayers.push_back(packedTexture.layer);
+                return;
+            }
+        }
+    }
+    std::cout << "ERROR: TextureArrayPacker: Texture was not added to this packer." << std::endl;
+}
+
+uint32_t TextureArrayPacker::GetArrayImageCount() const {
+    uint32_t count = 0;
+    for (const std::pair<const ArrayKey, std::vector<ArrayImage>> &arrays : m_arrays) {
+        count += static_cast<uint32_t>(arrays.second.size());
+    }
+    return count;
+}
+
+size_t TextureArrayPacker::GetTextureSize(const TextureInfo &textureInfo) {
+    size_t size = 0;
+    for (uint32_t mip = 0; mip < textureInfo.mipLevels; mip++) {
+        size += (size_t)std::max(textureInfo.width >> mip, 1u) * std::max(textureInfo.height >> mip, 1u) * textureInfo.bytesPerTexel;
+    }
+    return size;
+}
@@ -0,0 +1,63 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+
+#include <map>
+#include <tuple>
+
+// Packs textures of the same format, size and mip count into the layers of shared 2D array images.
+// Materials store the returned image and layer index instead of owning a texture, so that draws with different
+// materials bind the same image once and pass the layer per draw or per instance, e.g. in a uniform or through
+// gl_BaseInstance. Shaders sample with a sampler2DArray: texture(textures, vec3(uv, layer)).
+class TextureArrayPacker {
+public:
+    // Uncompressed formats only. Texture data is tightly packed, mip level 0 first.
+    struct TextureInfo {
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels;
+        int64_t format;
+        uint32_t bytesPerTexel;
+    };
+
+    struct PackedTexture {
+        void* image;
+        uint32_t layer;
+    };
+
+    // layersPerArray must be at least 2 and no more than the API's limit, e.g. GL_MAX_ARRAY_TEXTURE_LAYERS.
+    TextureArrayPacker(GraphicsAPI* graphicsAPI, uint32_t layersPerArray = 64);
+    ~TextureArrayPacker();
+
+    // Uploads the texture into a free layer of a matching array image, creating a new image if all are full.
+    PackedTexture AddTexture(const TextureInfo& textureInfo, const void* data);
+
+    // Frees the layer for reuse. The array image is kept.
+    void RemoveTexture(const PackedTexture& packedTexture);
+
+    // The number of array images. Draws are batched per image, so fewer is better.
+    uint32_t GetArrayImageCount() const;
+
+private:
+    // Textures are compatible when their format, width, height and mip levels match.
+    typedef std::tuple<int64_t, uint32_t, uint32_t, uint32_t> ArrayKey;
+    struct ArrayImage {
+        void* image;
+        std::vector<uint32_t> freeLayers;
+    };
+
+    static size_t GetTextureSize(const TextureInfo& textureInfo);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    uint32_t m_layersPerArray = 0;
+    std::map<ArrayKey, std::vector<ArrayImage>> m_arrays;
+
+    // Grown to the largest texture uploaded so far.
+    void* m_stagingBuffer = nullptr;
+    size_t m_stagingBufferSize = 0;
+};
@@ -0,0 +1,358 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <VideoLayer.h>
+
+#include <chrono>
+
+// GLSL 4.50 fragment shader.
+static const char *videoConversionShaderSource = R"(
+#version 450
+layout(location = 0) in vec2 i_TexCoord;
+layout(location = 0) out vec4 o_Color;
+
+layout(binding = 0) uniform sampler2D lumaPlane;
+layout(binding = 1) uniform sampler2D chromaPlane;
+layout(std140, binding = 2) uniform VideoUniforms {
+    mat4 yuvToRgb;
+};
+
+void main() {
+    // The planes are stored top row first, and the first texel of the attachment is its bottom left one.
+    vec2 uv = vec2(i_TexCoord.x, 1.0 - i_TexCoord.y);
+    vec3 yuv = vec3(textureLod(lumaPlane, uv, 0.0).r, textureLod(chromaPlane, uv, 0.0).rg);
+    vec3 rgb = clamp((yuvToRgb * vec4(yuv, 1.0)).rgb, 0.0, 1.0);
+
+    // Video is gamma encoded. The compositor expects linear light, which sRGB attachments encode again.
+    rgb = mix(rgb / 12.92, pow((rgb + 0.055) / 1.055, vec3(2.4)), greaterThan(rgb, vec3(0.04045)));
+    o_Color = vec4(rgb, 1.0);
+}
+)";
+
+Y4MDecoder::Y4MDecoder(const std::string &path)
+    : m_file(path, std::ios::binary) {
+    if (!m_file.is_open()) {
+        std::cout << "ERROR: Y4MDecoder: Failed to open " << path << "." << std::endl;
+        return;
+    }
+
+    // "YUV4MPEG2" followed by space separated parameters, each starting with a letter.
+    std::string header;
+    std::getline(m_file, header);
+    std::stringstream stream(header);
+    std::string parameter;
+    stream >> parameter;
+    if (parameter != "YUV4MPEG2") {
+        std::cout << "ERROR: Y4MDecoder: " << path << " is not a YUV4MPEG2 file." << std::endl;
+        return;
+    }
+    std::string chroma = "420jpeg";
+    uint32_t frameRateNumerator = 0;
+    uint32_t frameRateDenominator = 1;
+    while (stream >> parameter) {
+        const std::string value = parameter.substr(1);
+        switch (parameter[0]) {
+        case 'W':
+            m_format.width = (uint32_t)strtoul(value.c_str(), nullptr, 10);
+            break;
+        case 'H':
+            m_format.height = (uint32_t)strtoul(value.c_str(), nullptr, 10);
+            break;
+        case 'F':
+            sscanf(value.c_str(), "%u:%u", &frameRateNumerator, &frameRateDenominator);
+            break;
+        case 'C':
+            chroma = value;
+            break;
+        case 'X':
+            m_format.fullRange = value == "COLORRANGE=FULL";
+            break;
+        default:
+            break;
+        }
+    }
+    if (chroma != "420jpeg" && chroma != "420paldv" && chroma != "420mpeg2" && chroma != "420") {
+        std::cout << "ERROR: Y4MDecoder: " << path << ": Unsupported chroma format " << chroma << ". Only 8-bit 4:2:0 is supported." << std::endl;
+        return;
+    }
+    if (m_format.width == 0 || m_format.height == 0 || frameRateNumerator == 0 || frameRateDenominator == 0) {
+        std::cout << "ERROR: Y4MDecoder: " << path << ": Missing size or frame rate." << std::endl;
+        return;
+    }
+    m_format.frameRate = (double)frameRateNumerator / (double)frameRateDenominator;
+    // The matrix is not stored. Follow the common convention of BT.709 for HD and larger.
+    m_format.colorSpace = m_format.height >= 720 ? ColorSpace::BT709 : ColorSpace::BT601;
+
+    m_chromaPlanes.resize((size_t)((m_format.width + 1) / 2) * ((m_format.height + 1) / 2) * 2);
+    m_firstFrame = m_file.tellg();
+    m_valid = true;
+}
+
+bool Y4MDecoder::DecodeFrame(uint8_t *y, uint8_t *cbcr) {
+    if (!m_valid) {
+        return false;
+    }
+    // "FRAME" followed by optional parameters.
+    std::string frameHeader;
+    if (!std::getline(m_file, frameHeader) || frameHeader.compare(0, 5, "FRAME") != 0) {
+        return false;
+    }
+    const size_t chromaPlaneSize = m_chromaPlanes.size() / 2;
+    m_file.read((char *)y, (std::streamsize)((size_t)m_format.width * m_format.height));
+    m_file.read((char *)m_chromaPlanes.data(), (std::streamsize)m_chromaPlanes.size());
+    if (!m_file) {
+        return false;
+    }
+
+    // The planar Cb and Cr are interleaved for a two channel image.
+    const uint8_t *cb = m_chromaPlanes.data();
+    const uint8_t *cr = cb + chromaPlaneSize;
+    for (size_t i = 0; i < chromaPlaneSize; i++) {
+        cbcr[i * 2 + 0] = cb[i];
+        cbcr[i * 2 + 1] = cr[i];
+    }
+    return true;
+}
+
+bool Y4MDecoder::Rewind() {
+    if (!m_valid) {
+        return false;
+    }
+    m_file.clear();
+    m_file.seekg(m_firstFrame);
+    return m_file.good();
+}
+
+VideoLayer::VideoLayer(GraphicsAPI *graphicsAPI, const CreateInfo &createInfo, std::unique_ptr<VideoDecoder> decoder)
+    : m_graphicsAPI(graphicsAPI), m_createInfo(createInfo), m_decoder(std::move(decoder)) {
+    if (!m_decoder || m_createInfo.stagingBufferCount == 0) {
+        std::cout << "ERROR: VideoLayer: A decoder and at least one staging buffer are required." << std::endl;
+        return;
+    }
+    m_format = m_decoder->GetFormat();
+    if (m_format.width == 0 || m_format.height == 0 || m_format.frameRate <= 0.0) {
+        std::cout << "ERROR: VideoLayer: Invalid video format." << std::endl;
+        return;
+    }
+    const uint32_t chromaWidth = (m_format.width + 1) / 2;
+    const uint32_t chromaHeight = (m_format.height + 1) / 2;
+    m_lumaSize = (size_t)m_format.width * m_format.height;
+    m_chromaSize = (size_t)chromaWidth * chromaHeight * 2;
+
+    m_lumaImage = m_graphicsAPI->CreateImage({2, m_format.width, m_format.height, 1, 1, 1, 1, m_createInfo.lumaFormat, false, false, false, true});
+    m_chromaImage = m_graphicsAPI->CreateImage({2, chromaWidth, chromaHeight, 1, 1, 1, 1, m_createInfo.chromaFormat, false, false, false, true});
+
+    // Bilinear filtering upsamples the chroma plane, with its texels centered between the luma texels.
+    GraphicsAPI::SamplerCreateInfo samplerCI{};
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.mipmapMode = GraphicsAPI::SamplerCreateInfo::MipmapMode::NOOP;
+    samplerCI.addressModeS = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeT = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeR = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.compareOp = GraphicsAPI::CompareOp::NEVER;
+    m_sampler = m_graphicsAPI->CreateSampler(samplerCI);
+
+    // The conversion from Y'CbCr, with the offsets and the range expansion, to R'G'B' as one affine transform.
+    const bool bt709 = m_format.colorSpace == VideoDecoder::ColorSpace::BT709;
+    const float kr = bt709 ? 0.2126f : 0.299f;
+    const float kb = bt709 ? 0.0722f : 0.114f;
+    const float kg = 1.0f - kr - kb;
+    const float lumaScale = m_format.fullRange ? 1.0f : 255.0f / 219.0f;
+    const float chromaScale = m_format.fullRange ? 1.0f : 255.0f / 224.0f;
+    const float lumaOffset = m_format.fullRange ? 0.0f : 16.0f / 255.0f;
+    const float chromaOffset = 128.0f / 255.0f;
+    const float rows[3][3] = {
+        {lumaScale, 0.0f, 2.0f * (1.0f - kr) * chromaScale},
+        {lumaScale, -2.0f * (1.0f - kb) * kb / kg * chromaScale, -2.0f * (1.0f - kr) * kr / kg * chromaScale},
+        {lumaScale, 2.0f * (1.0f - kb) * chromaScale, 0.0f}};
+    VideoUniforms uniforms{};
+    XrMatrix4x4f_CreateIdentity(&uniforms.yuvToRgb);
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            uniforms.yuvToRgb.m[column * 4 + row] = rows[row][column];
+        }
+        uniforms.yuvToRgb.m[12 + row] = -(rows[row][0] * lumaOffset + (rows[row][1] + rows[row][2]) * chromaOffset);
+    }
+    m_uniformBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::UNIFORM, 0, sizeof(VideoUniforms), &uniforms});
+
+    m_conversionPass = std::make_unique<FullscreenPass>(m_graphicsAPI, videoConversionShaderSource, std::vector<int64_t>{m_createInfo.colorFormat},
+                                                        std::vector<GraphicsAPI::DescriptorInfo>{{0, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                 {1, nullptr, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT},
+                                                                                                 {2, nullptr, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT}});
+
+    for (uint32_t i = 0; i < m_createInfo.stagingBufferCount; i++) {
+        m_stagingBuffers.push_back(std::make_unique<StagingBuffer>());
+        m_stagingBuffers.back()->buffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STAGING, 0, m_lumaSize + m_chromaSize, nullptr});
+    }
+
+    // Start decoding ahead of the first Update().
+    m_decodeJobs = std::make_unique<JobSystem>(1);
+    SubmitDecodes();
+}
+
+VideoLayer::~VideoLayer() {
+    // Finish the queued decodes, which write into the mapped staging buffers.
+    m_decodeJobs.reset();
+
+    for (std::unique_ptr<StagingBuffer> &stagingBuffer : m_stagingBuffers) {
+        if (stagingBuffer->mapped) {
+            m_graphicsAPI->UnmapBuffer(stagingBuffer->buffer);
+        }
+        if (stagingBuffer->fence) {
+            m_graphicsAPI->DestroyFence(stagingBuffer->fence);
+        }
+        m_graphicsAPI->DestroyBuffer(stagingBuffer->buffer);
+    }
+    m_conversionPass.reset();
+    if (m_uniformBuffer) {
+        m_graphicsAPI->DestroyBuffer(m_uniformBuffer);
+    }
+    if (m_sampler) {
+        m_graphicsAPI->DestroySampler(m_sampler);
+    }
+    if (m_chromaImage) {
+        m_graphicsAPI->DestroyImage(m_chromaImage);
+    }
+    if (m_lumaImage) {
+        m_graphicsAPI->DestroyImage(m_lumaImage);
+    }
+}
+
+bool VideoLayer::Update(XrTime displayTime) {
+    if (!IsValid()) {
+        return false;
+    }
+    if (m_startTime == 0) {
+        m_startTime = displayTime;
+    }
+    const double seconds = std::max((double)(displayTime - m_startTime) * 1e-9, 0.0);
+    const uint64_t dueFrame = (uint64_t)(seconds * m_format.frameRate);
+
+    // Take the latest decoded frame that is due. The frames passed over go straight back to decoding.
+    StagingBuffer *latest = nullptr;
+    uint64_t dropped = 0;
+    bool late = false;
+    const uint32_t count = (uint32_t)m_stagingBuffers.size();
+    for (uint32_t i = 0; i < count; i++) {
+        StagingBuffer &stagingBuffer = *m_stagingBuffers[m_nextUpload];
+        if (stagingBuffer.state != StagingState::DECODED || stagingBuffer.frameIndex > dueFrame) {
+            late = !latest && stagingBuffer.state == StagingState::DECODING && stagingBuffer.frameIndex <= dueFrame;
+            break;
+        }
+        if (latest) {
+            latest->state = StagingState::IDLE;
+            dropped++;
+        }
+        latest = &stagingBuffer;
+        m_nextUpload = (m_nextUpload + 1) % count;
+    }
+    if (latest) {
+        Upload(*latest);
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_statisticsMutex);
+        m_statistics.framesDropped += dropped;
+        m_statistics.lateUpdates += late ? 1 : 0;
+    }
+
+    SubmitDecodes();
+    return latest != nullptr;
+}
+
+void VideoLayer::Convert(void *colorImageView) {
+    if (!IsValid()) {
+        return;
+    }
+    m_graphicsAPI->SetRenderAttachments(&colorImageView, 1, nullptr, m_format.width, m_format.height, m_conversionPass->GetPipeline());
+    GraphicsAPI::Viewport viewport = {0.0f, 0.0f, (float)m_format.width, (float)m_format.height, 0.0f, 1.0f};
+    GraphicsAPI::Rect2D scissor = {{0, 0}, {m_format.width, m_format.height}};
+    m_graphicsAPI->SetViewports(&viewport, 1);
+    m_graphicsAPI->SetScissors(&scissor, 1);
+
+    m_graphicsAPI->SetPipeline(m_conversionPass->GetPipeline());
+    m_graphicsAPI->SetDescriptor({0, m_lumaImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({0, m_sampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({1, m_chromaImage, GraphicsAPI::DescriptorInfo::Type::IMAGE, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({1, m_sampler, GraphicsAPI::DescriptorInfo::Type::SAMPLER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT});
+    m_graphicsAPI->SetDescriptor({2, m_uniformBuffer, GraphicsAPI::DescriptorInfo::Type::BUFFER, GraphicsAPI::DescriptorInfo::Stage::FRAGMENT, false, 0, sizeof(VideoUniforms)});
+    m_graphicsAPI->UpdateDescriptors();
+    m_conversionPass->Draw();
+}
+
+VideoLayer::Statistics VideoLayer::GetStatistics() {
+    std::unique_lock<std::mutex> lock(m_statisticsMutex);
+    Statistics statistics = m_statistics;
+    statistics.decodeMs = statistics.framesDecoded ? (float)(m_decodeSeconds * 1000.0 / (double)statistics.framesDecoded) : 0.0f;
+    return statistics;
+}
+
+void VideoLayer::SubmitDecodes() {
+    // Refill the staging buffers in ring order, once the copies out of them have completed.
+    const uint32_t count = (uint32_t)m_stagingBuffers.size();
+    for (uint32_t i = 0; i < count; i++) {
+        StagingBuffer &stagingBuffer = *m_stagingBuffers[m_nextDecode];
+        if (stagingBuffer.state != StagingState::IDLE) {
+            break;
+        }
+        if (stagingBuffer.fence) {
+            if (!m_graphicsAPI->WaitForFence(stagingBuffer.fence, 0)) {
+                break;
+            }
+            m_graphicsAPI->DestroyFence(stagingBuffer.fence);
+        }
+        // A buffer passed over in Update() is still mapped.
+        if (!stagingBuffer.mapped) {
+            stagingBuffer.mapped = (uint8_t *)m_graphicsAPI->MapBuffer(stagingBuffer.buffer);
+            if (!stagingBuffer.mapped) {
+                std::cout << "ERROR: VideoLayer: Failed to map a staging buffer." << std::endl;
+                break;
+            }
+        }
+
+        stagingBuffer.frameIndex = m_nextFrameIndex++;
+        stagingBuffer.state = StagingState::DECODING;
+        StagingBuffer *decodeTarget = &stagingBuffer;
+        m_decodeJobs->Submit([this, decodeTarget]() {
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            uint8_t *y = decodeTarget->mapped;
+            uint8_t *cbcr = decodeTarget->mapped + m_lumaSize;
+            bool decoded = m_decoder->DecodeFrame(y, cbcr);
+            if (!decoded && m_createInfo.loop) {
+                decoded = m_decoder->Rewind() && m_decoder->DecodeFrame(y, cbcr);
+            }
+            {
+                std::unique_lock<std::mutex> lock(m_statisticsMutex);
+                m_statistics.framesDecoded += decoded ? 1 : 0;
+                m_decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            }
+            // After the end of the stream, the ring stops at this buffer and the last frame stays.
+            decodeTarget->state = decoded ? StagingState::DECODED : StagingState::FAILED;
+        });
+        m_nextDecode = (m_nextDecode + 1) % count;
+    }
+}
+
+void VideoLayer::Upload(StagingBuffer &stagingBuffer) {
+    m_graphicsAPI->UnmapBuffer(stagingBuffer.buffer);
+    stagingBuffer.mapped = nullptr;
+
+    // Both copies are asynchronous to the CPU, reading from the staging buffer as a pixel unpack buffer.
+    GraphicsAPI::BufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.imageSubresource = {0, 0, 1};
+    region.imageExtent = {m_format.width, m_format.height, 1};
+    m_graphicsAPI->CopyBufferToImage(stagingBuffer.buffer, m_lumaImage, region);
+    region.bufferOffset = m_lumaSize;
+    region.imageExtent = {(m_format.width + 1) / 2, (m_format.height + 1) / 2, 1};
+    m_graphicsAPI->CopyBufferToImage(stagingBuffer.buffer, m_chromaImage, region);
+    stagingBuffer.fence = m_graphicsAPI->CreateFence();
+    stagingBuffer.state = StagingState::IDLE;
+
+    std::unique_lock<std::mutex> lock(m_statisticsMutex);
+    m_statistics.framesShown++;
+    m_statistics.bytesUploaded += m_lumaSize + m_chromaSize;
+}
@@ -0,0 +1,162 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <FullscreenPass.h>
+#include <JobSystem.h>
+#include <xr_linear_algebra.h>
+
+// A source of 8-bit YUV 4:2:0 video frames. A decoder is called from one thread at a time, which need not be the thread
+// that created it.
+class VideoDecoder {
+public:
+    enum class ColorSpace : uint8_t {
+        BT601,
+        BT709
+    };
+
+    struct Format {
+        uint32_t width;
+        uint32_t height;
+        double frameRate;
+        ColorSpace colorSpace;
+        // Samples span 0 to 255, instead of 16 to 235 for luma and 16 to 240 for chroma.
+        bool fullRange;
+    };
+
+    virtual ~VideoDecoder() = default;
+
+    virtual const Format& GetFormat() const = 0;
+
+    // Writes the next frame's luma plane of width x height bytes into y, and its chroma plane of ((width + 1) / 2) x
+    // ((height + 1) / 2) interleaved Cb Cr pairs into cbcr. Both are tightly packed, top row first. Returns false at the
+    // end of the stream or on an error.
+    virtual bool DecodeFrame(uint8_t* y, uint8_t* cbcr) = 0;
+
+    // Continues with the first frame.
+    virtual bool Rewind() = 0;
+};
+
+// Reads uncompressed YUV4MPEG2 files with 4:2:0 chroma, e.g. as written by "ffmpeg -i video.mp4 -pix_fmt yuv420p video.y4m".
+class Y4MDecoder : public VideoDecoder {
+public:
+    Y4MDecoder(const std::string& path);
+
+    bool IsValid() const { return m_valid; }
+
+    const Format& GetFormat() const override { return m_format; }
+    bool DecodeFrame(uint8_t* y, uint8_t* cbcr) override;
+    bool Rewind() override;
+
+private:
+    std::ifstream m_file;
+    std::streampos m_firstFrame;
+    Format m_format{};
+    std::vector<uint8_t> m_chromaPlanes;  // The Cb and Cr planes as stored in the file, before interleaving.
+    bool m_valid = false;
+};
+
+// Plays a video into the swapchain of a composition layer, e.g. an XrCompositionLayerEquirect2KHR for 360 degree video
+// or an XrCompositionLayerQuad.
+//
+// Frames stay in YUV 4:2:0 up to the GPU, at 1.5 bytes per texel instead of 4 for RGBA8, in a pipeline across threads:
+//  1. A decode thread writes the luma and chroma planes of each frame straight into a mapped staging buffer of a ring.
+//  2. Update(), on the rendering thread, unmaps the staging buffer of the latest frame due at the display time and copies
+//     its planes into an R8 luma and an RG8 chroma image. A fence guards the reuse of the staging buffer for decoding.
+//  3. Convert() converts the planes into an RGB swapchain image with a fullscreen pass.
+// While one frame is converted, the next can be in transfer while the frames after it are decoded.
+class VideoLayer {
+public:
+    struct CreateInfo {
+        // API specific formats: A one and a two channel eight bit format for the planes, see
+        // GraphicsAPI::GetVideoLumaFormat() and GetVideoChromaFormat(), and the format of the swapchain images.
+        int64_t lumaFormat;
+        int64_t chromaFormat;
+        int64_t colorFormat;
+        // The number of staging buffers, which bounds the number of frames decoded ahead.
+        uint32_t stagingBufferCount = 3;
+        // Continue with the first frame after the last.
+        bool loop = true;
+    };
+
+    struct Statistics {
+        uint64_t framesDecoded;
+        uint64_t framesShown;
+        uint64_t framesDropped;  // Decoded frames that were replaced by a later frame before they were shown.
+        uint64_t lateUpdates;    // Updates at which the frame due was still being decoded.
+        uint64_t bytesUploaded;
+        float decodeMs;          // The average per frame, on the decode thread.
+    };
+
+    VideoLayer(GraphicsAPI* graphicsAPI, const CreateInfo& createInfo, std::unique_ptr<VideoDecoder> decoder);
+    ~VideoLayer();
+
+    bool IsValid() const { return m_lumaImage != nullptr; }
+
+    uint32_t GetWidth() const { return m_format.width; }
+    uint32_t GetHeight() const { return m_format.height; }
+
+    // Playback starts at the first call. Uploads the latest decoded frame that is due at displayTime, and returns true if
+    // it replaced the current frame, so that Convert() needs to be called.
+    bool Update(XrTime displayTime);
+
+    // Converts the current frame into colorImageView, which is GetWidth() x GetHeight(). Call between BeginRendering()
+    // and EndRendering().
+    void Convert(void* colorImageView);
+
+    Statistics GetStatistics();
+
+private:
+    enum class StagingState : uint8_t {
+        IDLE,
+        DECODING,
+        DECODED,
+        FAILED
+    };
+
+    struct StagingBuffer {
+        void* buffer = nullptr;
+        void* fence = nullptr;  // Signalled once the last copy out of the buffer has completed.
+        uint8_t* mapped = nullptr;
+        uint64_t frameIndex = 0;
+        std::atomic<StagingState> state{StagingState::IDLE};
+    };
+
+    // Matches the std140 uniform block VideoUniforms in the shader.
+    struct VideoUniforms {
+        XrMatrix4x4f yuvToRgb;
+    };
+
+    void SubmitDecodes();
+    void Upload(StagingBuffer& stagingBuffer);
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    CreateInfo m_createInfo;
+    std::unique_ptr<VideoDecoder> m_decoder = nullptr;
+    VideoDecoder::Format m_format{};
+    size_t m_lumaSize = 0;
+    size_t m_chromaSize = 0;
+
+    void* m_lumaImage = nullptr;
+    void* m_chromaImage = nullptr;
+    void* m_sampler = nullptr;
+    void* m_uniformBuffer = nullptr;
+    std::unique_ptr<FullscreenPass> m_conversionPass = nullptr;
+
+    // Decoded and uploaded in ring order.
+    std::vector<std::unique_ptr<StagingBuffer>> m_stagingBuffers;
+    uint32_t m_nextDecode = 0;
+    uint32_t m_nextUpload = 0;
+    uint64_t m_nextFrameIndex = 0;
+    XrTime m_startTime = 0;
+
+    // A single decode thread, as decoders are sequential.
+    std::unique_ptr<JobSystem> m_decodeJobs = nullptr;
+
+    std::mutex m_statisticsMutex;
+    Statistics m_statistics{};
+    double m_decodeSeconds = 0.0;
+};
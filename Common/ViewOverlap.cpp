@@ -0,0 +1,73 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <ViewOverlap.h>
+
+// Allows for rounding in the runtime's field of view angles.
+static constexpr float tangentTolerance = 1e-4f;
+
+bool IsViewContained(const XrView &outer, const XrView &inner, float positionTolerance) {
+    XrVector3f offset;
+    XrVector3f_Sub(&offset, &inner.pose.position, &outer.pose.position);
+    if (XrVector3f_Length(&offset) > positionTolerance) {
+        return false;
+    }
+
+    // Both frusta share their apex, so the inner frustum is contained if its four edge directions are.
+    XrQuaternionf outerInverse;
+    XrQuaternionf_Invert(&outerInverse, &outer.pose.orientation);
+    const float innerLeft = tanf(inner.fov.angleLeft);
+    const float innerRight = tanf(inner.fov.angleRight);
+    const float innerDown = tanf(inner.fov.angleDown);
+    const float innerUp = tanf(inner.fov.angleUp);
+    const float outerLeft = tanf(outer.fov.angleLeft) - tangentTolerance;
+    const float outerRight = tanf(outer.fov.angleRight) + tangentTolerance;
+    const float outerDown = tanf(outer.fov.angleDown) - tangentTolerance;
+    const float outerUp = tanf(outer.fov.angleUp) + tangentTolerance;
+    const XrVector3f edges[4] = {{innerLeft, innerDown, -1.0f}, {innerRight, innerDown, -1.0f}, {innerLeft, innerUp, -1.0f}, {innerRight, innerUp, -1.0f}};
+    for (const XrVector3f &edge : edges) {
+        // From the inner view's space to the outer view's space.
+        XrVector3f world, local;
+        XrQuaternionf_RotateVector3f(&world, &inner.pose.orientation, &edge);
+        XrQuaternionf_RotateVector3f(&local, &outerInverse, &world);
+        if (local.z >= 0.0f) {
+            return false;
+        }
+        const float x = local.x / -local.z;
+        const float y = local.y / -local.z;
+        if (x < outerLeft || x > outerRight || y < outerDown || y > outerUp) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FindCullingViews(const XrView *views, uint32_t viewCount, std::vector<uint32_t> &cullingViews, float positionTolerance) {
+    cullingViews.resize(viewCount);
+    for (uint32_t i = 0; i < viewCount; i++) {
+        cullingViews[i] = i;
+        for (uint32_t j = 0; j < viewCount; j++) {
+            if (j == i || !IsViewContained(views[j], views[i], positionTolerance)) {
+                continue;
+            }
+            // Of two identical views, the later one is contained in the earlier one.
+            if (IsViewContained(views[i], views[j], positionTolerance) && j > i) {
+                continue;
+            }
+            cullingViews[i] = j;
+            break;
+        }
+    }
+
+    // Containment is transitive, so following the chain ends at a view that is not contained in any other view.
+    for (uint32_t i = 0; i < viewCount; i++) {
+        uint32_t view = cullingViews[i];
+        for (uint32_t steps = 0; cullingViews[view] != view && steps < viewCount; steps++) {
+            view = cullingViews[view];
+        }
+        cullingViews[i] = view;
+    }
+}
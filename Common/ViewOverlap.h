@@ -0,0 +1,21 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <xr_linear_algebra.h>
+
+// Finds views whose frustum lies entirely within another view's frustum, e.g. the high resolution inset views of a quad
+// view configuration within the peripheral views of the same eye. Objects visible in a contained view are also visible
+// in the containing view, so culling only needs to run for the containing views, and its results are reused for the
+// views contained in them.
+//
+// cullingViews[i] is the index of the view whose culling results view i uses: its own index, or the index of a view that
+// contains it and is not itself contained in another view. Views with the same position, within positionTolerance meters,
+// and nested fields of view are contained. Of identical views, the first one is culled.
+void FindCullingViews(const XrView* views, uint32_t viewCount, std::vector<uint32_t>& cullingViews, float positionTolerance = 0.001f);
+
+// Returns true if the frustum of inner lies within the frustum of outer, ignoring the near and far planes.
+bool IsViewContained(const XrView& outer, const XrView& inner, float positionTolerance = 0.001f);
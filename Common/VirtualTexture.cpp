@@ -0,0 +1,577 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#include <VirtualTexture.h>
+
+// GLSL 4.50 functions.
+static const char *virtualTextureGLSLSource = R"(
+layout(std140, binding = VIRTUAL_TEXTURE_INFO_BINDING) uniform VirtualTextureInfo {
+    vec2 vtVirtualSize;
+    float vtPageSize;
+    float vtMipCount;
+    vec2 vtPhysicalPageCount;
+    float vtFeedbackDivisor;
+    float vtPad;
+};
+layout(binding = VIRTUAL_TEXTURE_PAGE_TABLE_BINDING) uniform sampler2D vtPageTable;
+layout(binding = VIRTUAL_TEXTURE_PHYSICAL_CACHE_BINDING) uniform sampler2D vtPhysicalCache;
+
+// The mip level of the virtual texture for uv, from the screen space derivatives.
+float VirtualTextureMipLevel(vec2 uv, float lodBias) {
+    vec2 texel = uv * vtVirtualSize;
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8)) + lodBias;
+    return clamp(floor(lod), 0.0, vtMipCount - 1.0);
+}
+
+// The continuous page coordinate of uv at a mip level. Below one page per axis, the texels only fill part of the page.
+vec2 VirtualTexturePageCoord(vec2 uv, float mip) {
+    return uv * vtVirtualSize / (exp2(mip) * vtPageSize);
+}
+
+ivec2 VirtualTexturePage(vec2 uv, float mip) {
+    vec2 pageCount = max(vtVirtualSize / (exp2(mip) * vtPageSize), vec2(1.0));
+    return ivec2(min(floor(VirtualTexturePageCoord(uv, mip)), pageCount - 1.0));
+}
+
+vec4 VirtualTextureSample(vec2 uv) {
+    uv = clamp(uv, vec2(0.0), vec2(1.0));
+    float mip = VirtualTextureMipLevel(uv, 0.0);
+
+    // The page table entry points at the page in the physical cache, which is either the requested page or its nearest resident ancestor.
+    vec4 entry = floor(texelFetch(vtPageTable, VirtualTexturePage(uv, mip), int(mip)) * 255.0 + 0.5);
+    float residentMip = entry.z;
+    vec2 pageCoord = VirtualTexturePageCoord(uv, residentMip);
+    vec2 inPage = pageCoord - vec2(VirtualTexturePage(uv, residentMip));
+
+    // Pages have no border, so stay half a texel inside the page to not filter with its neighbor in the cache.
+    inPage = clamp(inPage, vec2(0.5 / vtPageSize), vec2(1.0 - 0.5 / vtPageSize));
+    return textureLod(vtPhysicalCache, (entry.xy + inPage) / vtPhysicalPageCount, 0.0);
+}
+
+// Output of the feedback pass, which is rendered at 1 / vtFeedbackDivisor of the view resolution.
+// Encodes the page as (x & 255, y & 255, (x >> 8) | (y >> 8) << 4, mip + 1).
+vec4 VirtualTextureFeedback(vec2 uv) {
+    uv = clamp(uv, vec2(0.0), vec2(1.0));
+    float mip = VirtualTextureMipLevel(uv, -log2(vtFeedbackDivisor));
+    uvec2 page = uvec2(VirtualTexturePage(uv, mip));
+    return vec4(float(page.x & 255u), float(page.y & 255u), float((page.x >> 8u) | ((page.y >> 8u) << 4u)), mip + 1.0) / 255.0;
+}
+)";
+
+static bool IsPowerOfTwo(uint32_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+static uint32_t Log2(uint32_t value) {
+    uint32_t result = 0;
+    while (value > 1) {
+        value >>= 1;
+        result++;
+    }
+    return result;
+}
+
+static uint32_t PackPageTableEntry(uint32_t slotX, uint32_t slotY, uint32_t mip) {
+    return slotX | (slotY << 8) | (mip << 16) | (255u << 24);
+}
+
+VirtualTexture::VirtualTexture(GraphicsAPI *graphicsAPI, const CreateInfo &createInfo)
+    : m_graphicsAPI(graphicsAPI), m_createInfo(createInfo) {
+    std::ifstream file(m_createInfo.pageFilePath, std::ios::binary);
+    if (!file.read((char *)&m_header, sizeof(PageFileHeader)) || memcmp(m_header.magic, "XRVT", 4) != 0) {
+        std::cout << "ERROR: VirtualTexture: Unable to read page file " << m_createInfo.pageFilePath << "." << std::endl;
+        return;
+    }
+    if (m_createInfo.physicalPageCountX > 256 || m_createInfo.physicalPageCountY > 256 || m_header.width / m_header.pageSize > 4096 || m_header.height / m_header.pageSize > 4096) {
+        std::cout << "ERROR: VirtualTexture: Page counts exceed the page table and feedback encodings." << std::endl;
+        return;
+    }
+
+    m_pageCountX = m_header.width / m_header.pageSize;
+    m_pageCountY = m_header.height / m_header.pageSize;
+    m_pageBytes = (size_t)m_header.pageSize * m_header.pageSize * 4;
+    size_t pageCount = 0;
+    for (uint32_t mip = 0; mip < m_header.mipCount; mip++) {
+        m_mipFirstPage.push_back(pageCount);
+        pageCount += (size_t)PageCountX(mip) * PageCountY(mip);
+    }
+
+    m_feedbackWidth = std::max(m_createInfo.viewWidth / m_createInfo.feedbackDivisor, 1u);
+    m_feedbackHeight = std::max(m_createInfo.viewHeight / m_createInfo.feedbackDivisor, 1u);
+    m_shaderInfo = {{(float)m_header.width, (float)m_header.height}, (float)m_header.pageSize, (float)m_header.mipCount,
+                    {(float)m_createInfo.physicalPageCountX, (float)m_createInfo.physicalPageCountY}, (float)m_createInfo.feedbackDivisor, 0.0f};
+
+    // The coarsest mip level is a single page, which is loaded now, before any resources are created, so that a broken page file leaves the texture invalid.
+    const uint32_t topKey = PageKey(m_header.mipCount - 1, 0, 0);
+    std::vector<uint8_t> topPage;
+    if (!ReadPage(file, topKey, topPage)) {
+        std::cout << "ERROR: VirtualTexture: Unable to read the coarsest mip level." << std::endl;
+        return;
+    }
+
+    // Images and samplers.
+    m_pageTableImage = m_graphicsAPI->CreateImage({2, m_pageCountX, m_pageCountY, 1, m_header.mipCount, 1, 1, m_createInfo.format, false, false, false, true});
+    m_physicalCacheImage = m_graphicsAPI->CreateImage({2, m_header.pageSize * m_createInfo.physicalPageCountX, m_header.pageSize * m_createInfo.physicalPageCountY, 1, 1, 1, 1, m_createInfo.format, false, false, false, true});
+    m_feedbackImage = m_graphicsAPI->CreateImage({2, m_feedbackWidth, m_feedbackHeight, 1, 1, 1, 1, m_createInfo.format, false, true, false, false});
+    m_feedbackImageView = m_graphicsAPI->CreateImageView({m_feedbackImage, GraphicsAPI::ImageViewCreateInfo::Type::RTV, GraphicsAPI::ImageViewCreateInfo::View::TYPE_2D, m_createInfo.format, GraphicsAPI::ImageViewCreateInfo::Aspect::COLOR_BIT, 0, 1, 0, 1});
+
+    GraphicsAPI::SamplerCreateInfo samplerCI{};
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::NEAREST;
+    samplerCI.mipmapMode = GraphicsAPI::SamplerCreateInfo::MipmapMode::NOOP;
+    samplerCI.addressModeS = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeT = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.addressModeR = GraphicsAPI::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+    samplerCI.compareOp = GraphicsAPI::CompareOp::NEVER;
+    samplerCI.maxLod = (float)m_header.mipCount;
+    m_pageTableSampler = m_graphicsAPI->CreateSampler(samplerCI);
+    samplerCI.magFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.minFilter = GraphicsAPI::SamplerCreateInfo::Filter::LINEAR;
+    samplerCI.maxLod = 0.0f;
+    m_physicalCacheSampler = m_graphicsAPI->CreateSampler(samplerCI);
+
+    // Buffers: Staging for page and page table uploads, and a ring of buffers for the feedback readbacks.
+    size_t pageTableSize = 0;
+    for (uint32_t mip = 0; mip < m_header.mipCount; mip++) {
+        pageTableSize += (size_t)PageCountX(mip) * PageCountY(mip) * sizeof(uint32_t);
+    }
+    m_pageStagingBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STAGING, 0, m_pageBytes * m_createInfo.maxUploadsPerFrame, nullptr});
+    m_pageTableStagingBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::STAGING, 0, pageTableSize, nullptr});
+    for (void *&readbackBuffer : m_readbackBuffers) {
+        readbackBuffer = m_graphicsAPI->CreateBuffer({GraphicsAPI::BufferCreateInfo::Type::READBACK, 0, (size_t)m_feedbackWidth * m_feedbackHeight * 4, nullptr});
+    }
+
+    // Physical cache slots and page table.
+    const uint32_t slotCount = m_createInfo.physicalPageCountX * m_createInfo.physicalPageCountY;
+    m_slotPages.resize(slotCount, invalidPage);
+    m_slotLastUsed.resize(slotCount, 0);
+    for (uint32_t slot = slotCount; slot > 0; slot--) {
+        m_freeSlots.push_back(slot - 1);
+    }
+    m_pageTable.resize(m_header.mipCount);
+    m_dirtyRegions.resize(m_header.mipCount);
+    for (uint32_t mip = 0; mip < m_header.mipCount; mip++) {
+        m_pageTable[mip].resize((size_t)PageCountX(mip) * PageCountY(mip), 0);
+        m_dirtyRegions[mip] = {0, 0, PageCountX(mip), PageCountY(mip)};
+    }
+
+    // The coarsest mip level is pinned, so that every page has a resident fallback.
+    const uint32_t topSlot = AllocateSlot();
+    UploadPage(topSlot, topPage, 0);
+    m_slotPages[topSlot] = topKey;
+    m_slotLastUsed[topSlot] = UINT64_MAX;
+    m_residentPages[topKey] = topSlot;
+    UpdatePageTable();
+
+    m_ioJobs = std::make_unique<JobSystem>(m_createInfo.ioThreadCount);
+}
+
+VirtualTexture::~VirtualTexture() {
+    // Skip all queued loads and wait for the running ones.
+    m_cancelLoads = true;
+    m_ioJobs.reset();
+
+    for (uint32_t i = 0; i < readbackCount; i++) {
+        if (m_readbackFences[i]) {
+            m_graphicsAPI->DestroyFence(m_readbackFences[i]);
+        }
+        if (m_readbackBuffers[i]) {
+            m_graphicsAPI->DestroyBuffer(m_readbackBuffers[i]);
+        }
+    }
+    if (m_pageTableImage) {
+        m_graphicsAPI->DestroyBuffer(m_pageTableStagingBuffer);
+        m_graphicsAPI->DestroyBuffer(m_pageStagingBuffer);
+        m_graphicsAPI->DestroySampler(m_physicalCacheSampler);
+        m_graphicsAPI->DestroySampler(m_pageTableSampler);
+        m_graphicsAPI->DestroyImageView(m_feedbackImageView);
+        m_graphicsAPI->DestroyImage(m_feedbackImage);
+        m_graphicsAPI->DestroyImage(m_physicalCacheImage);
+        m_graphicsAPI->DestroyImage(m_pageTableImage);
+    }
+}
+
+void VirtualTexture::BeginFrame() {
+    if (!IsValid()) {
+        return;
+    }
+    m_statistics.uploadsLastFrame = 0;
+    m_statistics.evictionsLastFrame = 0;
+
+    // Consume the feedback readbacks that the GPU has completed, oldest first. Never wait for the GPU.
+    bool newFeedback = false;
+    for (uint32_t i = 0; i < readbackCount; i++) {
+        const uint32_t readback = (m_nextReadback + i) % readbackCount;
+        if (!m_readbackFences[readback] || !m_graphicsAPI->WaitForFence(m_readbackFences[readback], 0)) {
+            continue;
+        }
+        m_graphicsAPI->DestroyFence(m_readbackFences[readback]);
+        const uint8_t *feedback = (const uint8_t *)m_graphicsAPI->MapBuffer(m_readbackBuffers[readback]);
+        if (feedback) {
+            ProcessFeedback(feedback);
+            newFeedback = true;
+        }
+        m_graphicsAPI->UnmapBuffer(m_readbackBuffers[readback]);
+    }
+    if (newFeedback || !m_prefetchPages.empty()) {
+        RequestPages();
+    }
+
+    UploadPages();
+    UpdatePageTable();
+
+    m_statistics.residentPages = static_cast<uint32_t>(m_residentPages.size());
+    m_statistics.pendingLoads = static_cast<uint32_t>(m_pendingPages.size());
+    m_statistics.requestedPages = static_cast<uint32_t>(m_requestCounts.size());
+    m_statistics.queuedPrefetches = static_cast<uint32_t>(m_prefetchPages.size());
+}
+
+void VirtualTexture::Prefetch(float u0, float v0, float u1, float v1, uint32_t mip) {
+    if (!IsValid() || mip >= m_header.mipCount) {
+        return;
+    }
+    const uint32_t pageCountX = PageCountX(mip);
+    const uint32_t pageCountY = PageCountY(mip);
+    const uint32_t beginX = std::min(static_cast<uint32_t>(std::min(std::max(u0, 0.0f), 1.0f) * (float)pageCountX), pageCountX - 1);
+    const uint32_t beginY = std::min(static_cast<uint32_t>(std::min(std::max(v0, 0.0f), 1.0f) * (float)pageCountY), pageCountY - 1);
+    const uint32_t lastX = std::min(static_cast<uint32_t>(std::min(std::max(u1, 0.0f), 1.0f) * (float)pageCountX), pageCountX - 1);
+    const uint32_t lastY = std::min(static_cast<uint32_t>(std::min(std::max(v1, 0.0f), 1.0f) * (float)pageCountY), pageCountY - 1);
+    for (uint32_t y = beginY; y <= lastY; y++) {
+        for (uint32_t x = beginX; x <= lastX; x++) {
+            const uint32_t key = PageKey(mip, x, y);
+            if (m_residentPages.find(key) == m_residentPages.end() && m_pendingPages.find(key) == m_pendingPages.end()) {
+                m_prefetchPages.push_back(key);
+            }
+        }
+    }
+
+    // Predictions go stale quickly, so drop the oldest prefetches rather than letting the queue grow.
+    const size_t maxQueuedPrefetches = 4 * (size_t)m_createInfo.maxPendingLoads;
+    while (m_prefetchPages.size() > maxQueuedPrefetches) {
+        m_prefetchPages.pop_front();
+    }
+}
+
+void VirtualTexture::EndFrame() {
+    if (!IsValid()) {
+        return;
+    }
+
+    // If the GPU is more than readbackCount frames behind, skip this frame's feedback instead of stalling.
+    const uint32_t readback = m_nextReadback;
+    if (!m_readbackFences[readback]) {
+        GraphicsAPI::BufferImageCopy region{};
+        region.imageSubresource = {0, 0, 1};
+        region.imageExtent = {m_feedbackWidth, m_feedbackHeight, 1};
+        m_graphicsAPI->CopyImageToBuffer(m_feedbackImage, m_readbackBuffers[readback], region);
+        m_readbackFences[readback] = m_graphicsAPI->CreateFence();
+        m_nextReadback = (m_nextReadback + 1) % readbackCount;
+    }
+    m_frameIndex++;
+}
+
+const char *VirtualTexture::GetGLSLSource() {
+    return virtualTextureGLSLSource;
+}
+
+bool VirtualTexture::WritePageFile(const std::string &path, const uint8_t *rgba8, uint32_t width, uint32_t height, uint32_t pageSize) {
+    if (!IsPowerOfTwo(width) || !IsPowerOfTwo(height) || !IsPowerOfTwo(pageSize) || width < pageSize || height < pageSize) {
+        std::cout << "ERROR: VirtualTexture: width, height and pageSize must be powers of two, with width and height >= pageSize." << std::endl;
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "ERROR: VirtualTexture: Unable to create page file " << path << "." << std::endl;
+        return false;
+    }
+
+    PageFileHeader header{{'X', 'R', 'V', 'T'}, width, height, pageSize, Log2(std::max(width, height) / pageSize) + 1, 0};
+    for (uint32_t mip = 0; mip < header.mipCount; mip++) {
+        header.pageCount += std::max((width / pageSize) >> mip, 1u) * std::max((height / pageSize) >> mip, 1u);
+    }
+    file.write((const char *)&header, sizeof(PageFileHeader));
+
+    std::vector<uint8_t> level(rgba8, rgba8 + (size_t)width * height * 4);
+    std::vector<uint8_t> page((size_t)pageSize * pageSize * 4);
+    uint32_t levelWidth = width;
+    uint32_t levelHeight = height;
+    for (uint32_t mip = 0; mip < header.mipCount; mip++) {
+        // Pages are stored row major. Texels beyond the level's extent repeat its edge.
+        const uint32_t pageCountX = std::max((width / pageSize) >> mip, 1u);
+        const uint32_t pageCountY = std::max((height / pageSize) >> mip, 1u);
+        for (uint32_t pageY = 0; pageY < pageCountY; pageY++) {
+            for (uint32_t pageX = 0; pageX < pageCountX; pageX++) {
+                for (uint32_t y = 0; y < pageSize; y++) {
+                    for (uint32_t x = 0; x < pageSize; x++) {
+                        const uint32_t srcX = std::min(pageX * pageSize + x, levelWidth - 1);
+                        const uint32_t srcY = std::min(pageY * pageSize + y, levelHeight - 1);
+                        memcpy(&page[((size_t)y * pageSize + x) * 4], &level[((size_t)srcY * levelWidth + srcX) * 4], 4);
+                    }
+                }
+                file.write((const char *)page.data(), page.size());
+            }
+        }
+
+        // Box filter the next level.
+        const uint32_t nextWidth = std::max(levelWidth / 2, 1u);
+        const uint32_t nextHeight = std::max(levelHeight / 2, 1u);
+        std::vector<uint8_t> nextLevel((size_t)nextWidth * nextHeight * 4);
+        for (uint32_t y = 0; y < nextHeight; y++) {
+            for (uint32_t x = 0; x < nextWidth; x++) {
+                const uint32_t x0 = std::min(x * 2, levelWidth - 1), x1 = std::min(x * 2 + 1, levelWidth - 1);
+                const uint32_t y0 = std::min(y * 2, levelHeight - 1), y1 = std::min(y * 2 + 1, levelHeight - 1);
+                for (uint32_t c = 0; c < 4; c++) {
+                    const uint32_t sum = level[((size_t)y0 * levelWidth + x0) * 4 + c] + level[((size_t)y0 * levelWidth + x1) * 4 + c] + level[((size_t)y1 * levelWidth + x0) * 4 + c] + level[((size_t)y1 * levelWidth + x1) * 4 + c];
+                    nextLevel[((size_t)y * nextWidth + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+                }
+            }
+        }
+        level.swap(nextLevel);
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+    return (bool)file;
+}
+
+size_t VirtualTexture::PageFileOffset(uint32_t key) const {
+    const uint32_t mip = PageKeyMip(key);
+    const size_t pageIndex = m_mipFirstPage[mip] + (size_t)PageKeyY(key) * PageCountX(mip) + PageKeyX(key);
+    return sizeof(PageFileHeader) + pageIndex * m_pageBytes;
+}
+
+bool VirtualTexture::ReadPage(std::ifstream &file, uint32_t key, std::vector<uint8_t> &data) const {
+    data.resize(m_pageBytes);
+    file.seekg((std::streamoff)PageFileOffset(key));
+    if (!file.read((char *)data.data(), (std::streamsize)m_pageBytes)) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+void VirtualTexture::ProcessFeedback(const uint8_t *feedback) {
+    m_requestCounts.clear();
+    const size_t texelCount = (size_t)m_feedbackWidth * m_feedbackHeight;
+    for (size_t i = 0; i < texelCount; i++) {
+        const uint8_t *texel = &feedback[i * 4];
+        if (texel[3] == 0 || texel[3] > m_header.mipCount) {
+            continue;
+        }
+        const uint32_t mip = texel[3] - 1u;
+        const uint32_t x = texel[0] | ((texel[2] & 0xFu) << 8);
+        const uint32_t y = texel[1] | ((texel[2] >> 4) << 8);
+        if (x < PageCountX(mip) && y < PageCountY(mip)) {
+            m_requestCounts[PageKey(mip, x, y)]++;
+        }
+    }
+
+    // A requested page and all of its ancestors, which serve as its fallbacks, are in use and should not be evicted.
+    for (const std::pair<const uint32_t, uint32_t> &request : m_requestCounts) {
+        uint32_t x = PageKeyX(request.first);
+        uint32_t y = PageKeyY(request.first);
+        for (uint32_t mip = PageKeyMip(request.first); mip < m_header.mipCount; mip++, x >>= 1, y >>= 1) {
+            std::unordered_map<uint32_t, uint32_t>::iterator it = m_residentPages.find(PageKey(mip, x, y));
+            if (it != m_residentPages.end() && m_slotLastUsed[it->second] != UINT64_MAX) {
+                m_slotLastUsed[it->second] = m_frameIndex;
+            }
+        }
+    }
+}
+
+void VirtualTexture::RequestPages() {
+    // Missing pages inherit the request counts of their descendants, so that coarse fallbacks for large areas stream in first.
+    std::unordered_map<uint32_t, uint32_t> missingPages;
+    for (const std::pair<const uint32_t, uint32_t> &request : m_requestCounts) {
+        uint32_t x = PageKeyX(request.first);
+        uint32_t y = PageKeyY(request.first);
+        for (uint32_t mip = PageKeyMip(request.first); mip < m_header.mipCount; mip++, x >>= 1, y >>= 1) {
+            const uint32_t key = PageKey(mip, x, y);
+            if (m_residentPages.find(key) == m_residentPages.end() && m_pendingPages.find(key) == m_pendingPages.end()) {
+                missingPages[key] += request.second;
+            }
+        }
+    }
+
+    // Prioritize coarser mip levels, then pages covering more of the screen.
+    std::vector<std::pair<uint32_t, uint32_t>> candidates(missingPages.begin(), missingPages.end());
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b) {
+        if (PageKeyMip(a.first) != PageKeyMip(b.first)) {
+            return PageKeyMip(a.first) > PageKeyMip(b.first);
+        }
+        return a.second > b.second;
+    });
+
+    for (const std::pair<uint32_t, uint32_t> &candidate : candidates) {
+        if (m_pendingPages.size() >= m_createInfo.maxPendingLoads) {
+            break;
+        }
+        LoadPage(candidate.first);
+    }
+
+    // Prefetches leave half of the loads for pages that are visible now.
+    while (!m_prefetchPages.empty() && m_pendingPages.size() < m_createInfo.maxPendingLoads / 2) {
+        const uint32_t key = m_prefetchPages.front();
+        m_prefetchPages.pop_front();
+        if (m_residentPages.find(key) == m_residentPages.end() && m_pendingPages.find(key) == m_pendingPages.end()) {
+            LoadPage(key);
+        }
+    }
+}
+
+void VirtualTexture::LoadPage(uint32_t key) {
+    m_pendingPages.insert(key);
+    m_ioJobs->Submit([this, key]() {
+        if (m_cancelLoads) {
+            return;
+        }
+        LoadedPage loadedPage{key, {}};
+        std::ifstream file(m_createInfo.pageFilePath, std::ios::binary);
+        ReadPage(file, key, loadedPage.data);
+
+        std::unique_lock<std::mutex> lock(m_loadedPagesMutex);
+        m_loadedPages.push_back(std::move(loadedPage));
+    });
+}
+
+void VirtualTexture::UploadPages() {
+    std::vector<LoadedPage> loadedPages;
+    {
+        std::unique_lock<std::mutex> lock(m_loadedPagesMutex);
+        loadedPages.swap(m_loadedPages);
+    }
+    std::stable_sort(loadedPages.begin(), loadedPages.end(), [](const LoadedPage &a, const LoadedPage &b) { return PageKeyMip(a.key) > PageKeyMip(b.key); });
+
+    // Upload at most maxUploadsPerFrame pages, and keep the rest for the following frames.
+    uint32_t uploadCount = 0;
+    size_t i = 0;
+    for (; i < loadedPages.size() && uploadCount < m_createInfo.maxUploadsPerFrame; i++) {
+        LoadedPage &loadedPage = loadedPages[i];
+        if (loadedPage.data.empty()) {
+            std::cout << "ERROR: VirtualTexture: Unable to read page " << PageKeyX(loadedPage.key) << ", " << PageKeyY(loadedPage.key) << " of mip level " << PageKeyMip(loadedPage.key) << "." << std::endl;
+            m_pendingPages.erase(loadedPage.key);
+            continue;
+        }
+        const uint32_t slot = AllocateSlot();
+        if (slot == invalidPage) {
+            // Every slot holds a page in use: The cache is too small for the current view. Retry next frame.
+            break;
+        }
+        UploadPage(slot, loadedPage.data, uploadCount++);
+        m_slotPages[slot] = loadedPage.key;
+        m_slotLastUsed[slot] = m_frameIndex;
+        m_residentPages[loadedPage.key] = slot;
+        m_pendingPages.erase(loadedPage.key);
+        MarkPageTableDirty(loadedPage.key);
+    }
+    m_statistics.uploadsLastFrame = uploadCount;
+
+    if (i < loadedPages.size()) {
+        std::unique_lock<std::mutex> lock(m_loadedPagesMutex);
+        m_loadedPages.insert(m_loadedPages.end(), std::make_move_iterator(loadedPages.begin() + i), std::make_move_iterator(loadedPages.end()));
+    }
+}
+
+void VirtualTexture::UploadPage(uint32_t slot, const std::vector<uint8_t> &data, uint32_t stagingIndex) {
+    if (data.size() != m_pageBytes) {
+        return;
+    }
+    const size_t stagingOffset = m_pageBytes * stagingIndex;
+    m_graphicsAPI->SetBufferData(m_pageStagingBuffer, stagingOffset, m_pageBytes, (void *)data.data());
+
+    GraphicsAPI::BufferImageCopy region{};
+    region.bufferOffset = stagingOffset;
+    region.imageSubresource = {0, 0, 1};
+    region.imageOffset = {(int32_t)((slot % m_createInfo.physicalPageCountX) * m_header.pageSize), (int32_t)((slot / m_createInfo.physicalPageCountX) * m_header.pageSize), 0};
+    region.imageExtent = {m_header.pageSize, m_header.pageSize, 1};
+    m_graphicsAPI->CopyBufferToImage(m_pageStagingBuffer, m_physicalCacheImage, region);
+}
+
+uint32_t VirtualTexture::AllocateSlot() {
+    if (!m_freeSlots.empty()) {
+        const uint32_t slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slot;
+    }
+
+    // Evict the least recently requested page. Pages requested by the latest feedback and the pinned page are never evicted.
+    uint32_t evictSlot = invalidPage;
+    uint64_t oldestFrame = m_frameIndex;
+    for (uint32_t slot = 0; slot < (uint32_t)m_slotLastUsed.size(); slot++) {
+        if (m_slotLastUsed[slot] < oldestFrame) {
+            oldestFrame = m_slotLastUsed[slot];
+            evictSlot = slot;
+        }
+    }
+    if (evictSlot != invalidPage) {
+        m_residentPages.erase(m_slotPages[evictSlot]);
+        MarkPageTableDirty(m_slotPages[evictSlot]);
+        m_slotPages[evictSlot] = invalidPage;
+        m_statistics.evictionsLastFrame++;
+    }
+    return evictSlot;
+}
+
+void VirtualTexture::MarkPageTableDirty(uint32_t key) {
+    // A page's entry is inherited by all of its non resident descendants, so its whole subtree has to be updated.
+    const uint32_t pageMip = PageKeyMip(key);
+    for (uint32_t mip = 0; mip <= pageMip; mip++) {
+        const uint32_t shift = pageMip - mip;
+        DirtyRegion &region = m_dirtyRegions[mip];
+        const uint32_t beginX = PageKeyX(key) << shift;
+        const uint32_t beginY = PageKeyY(key) << shift;
+        const uint32_t endX = std::min((PageKeyX(key) + 1) << shift, PageCountX(mip));
+        const uint32_t endY = std::min((PageKeyY(key) + 1) << shift, PageCountY(mip));
+        if (region.beginX >= region.endX || region.beginY >= region.endY) {
+            region = {beginX, beginY, endX, endY};
+        } else {
+            region = {std::min(region.beginX, beginX), std::min(region.beginY, beginY), std::max(region.endX, endX), std::max(region.endY, endY)};
+        }
+    }
+}
+
+void VirtualTexture::UpdatePageTable() {
+    // Resolve the dirty regions from the coarsest mip level down, so that non resident pages can copy their parent's entry.
+    size_t stagingOffset = 0;
+    for (uint32_t mip = m_header.mipCount; mip > 0; mip--) {
+        const uint32_t level = mip - 1;
+        DirtyRegion &region = m_dirtyRegions[level];
+        if (region.beginX >= region.endX || region.beginY >= region.endY) {
+            continue;
+        }
+
+        const uint32_t pageCountX = PageCountX(level);
+        const uint32_t regionWidth = region.endX - region.beginX;
+        const uint32_t regionHeight = region.endY - region.beginY;
+        std::vector<uint32_t> entries((size_t)regionWidth * regionHeight);
+        for (uint32_t y = region.beginY; y < region.endY; y++) {
+            for (uint32_t x = region.beginX; x < region.endX; x++) {
+                uint32_t entry = 0;
+                std::unordered_map<uint32_t, uint32_t>::iterator it = m_residentPages.find(PageKey(level, x, y));
+                if (it != m_residentPages.end()) {
+                    entry = PackPageTableEntry(it->second % m_createInfo.physicalPageCountX, it->second / m_createInfo.physicalPageCountX, level);
+                } else if (level + 1 < m_header.mipCount) {
+                    entry = m_pageTable[level + 1][(size_t)(y >> 1) * PageCountX(level + 1) + (x >> 1)];
+                }
+                m_pageTable[level][(size_t)y * pageCountX + x] = entry;
+                entries[(size_t)(y - region.beginY) * regionWidth + (x - region.beginX)] = entry;
+            }
+        }
+
+        const size_t size = entries.size() * sizeof(uint32_t);
+        m_graphicsAPI->SetBufferData(m_pageTableStagingBuffer, stagingOffset, size, entries.data());
+        GraphicsAPI::BufferImageCopy copy{};
+        copy.bufferOffset = stagingOffset;
+        copy.imageSubresource = {level, 0, 1};
+        copy.imageOffset = {(int32_t)region.beginX, (int32_t)region.beginY, 0};
+        copy.imageExtent = {regionWidth, regionHeight, 1};
+        m_graphicsAPI->CopyBufferToImage(m_pageTableStagingBuffer, m_pageTableImage, copy);
+        stagingOffset += size;
+
+        region = {};
+    }
+}
@@ -0,0 +1,185 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+#pragma once
+#include <GraphicsAPI.h>
+#include <JobSystem.h>
+
+// Virtual texturing: A texture far larger than GPU memory is split into square pages, which are stored on disk in a page file.
+// Only the pages that are currently needed are resident in a fixed size physical page cache texture, so GPU memory use is
+// independent of the virtual texture's size.
+//
+// Each frame:
+//  1. BeginFrame() consumes completed feedback readbacks, queues page loads on the I/O threads, uploads loaded pages within
+//     the per frame budget and updates the page table.
+//  2. The application renders a low resolution feedback pass into GetFeedbackImageView() with VirtualTextureFeedback(), and
+//     its main passes with VirtualTextureSample(). See GetGLSLSource().
+//  3. EndFrame() queues an asynchronous readback of the feedback image, which is consumed a few frames later.
+//
+// Pages that are not resident fall back to their nearest resident ancestor, so sampling never misses. The coarsest mip
+// level fits into a single page, which is loaded at creation and never evicted.
+class VirtualTexture {
+public:
+    struct CreateInfo {
+        std::string pageFilePath;
+        // An API specific four channel, eight bits per channel format, e.g. GL_RGBA8. Used for all images.
+        int64_t format;
+        // The physical page cache holds physicalPageCountX * physicalPageCountY pages.
+        uint32_t physicalPageCountX = 32;
+        uint32_t physicalPageCountY = 32;
+        // The resolution of the main views. The feedback pass is rendered at 1 / feedbackDivisor of it.
+        uint32_t viewWidth;
+        uint32_t viewHeight;
+        uint32_t feedbackDivisor = 8;
+        // The maximum number of pages copied into the physical page cache per frame.
+        uint32_t maxUploadsPerFrame = 8;
+        // The maximum number of pages being read from disk at once.
+        uint32_t maxPendingLoads = 64;
+        uint32_t ioThreadCount = 2;
+    };
+
+    // Matches the std140 uniform block VirtualTextureInfo in GetGLSLSource().
+    struct ShaderInfo {
+        float virtualSize[2];
+        float pageSize;
+        float mipCount;
+        float physicalPageCount[2];
+        float feedbackDivisor;
+        float pad;
+    };
+
+    struct Statistics {
+        uint32_t residentPages;
+        uint32_t pendingLoads;
+        uint32_t requestedPages;
+        uint32_t queuedPrefetches;
+        uint32_t uploadsLastFrame;
+        uint32_t evictionsLastFrame;
+    };
+
+    VirtualTexture(GraphicsAPI* graphicsAPI, const CreateInfo& createInfo);
+    ~VirtualTexture();
+
+    bool IsValid() const { return m_pageTableImage != nullptr; }
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Queues loads of the pages of a mip level that cover [u0, u1] x [v0, v1] in texture coordinates, e.g. for content that
+    // is predicted to become visible. Prefetches have a lower priority than the pages requested by the feedback, and only
+    // use up to half of maxPendingLoads.
+    void Prefetch(float u0, float v0, float u1, float v1, uint32_t mip);
+
+    // Bind as IMAGE descriptors together with the matching samplers.
+    void* GetPageTableImage() { return m_pageTableImage; }
+    void* GetPhysicalCacheImage() { return m_physicalCacheImage; }
+    void* GetFeedbackImageView() { return m_feedbackImageView; }
+    void* GetPageTableSampler() { return m_pageTableSampler; }
+    void* GetPhysicalCacheSampler() { return m_physicalCacheSampler; }
+    uint32_t GetFeedbackWidth() const { return m_feedbackWidth; }
+    uint32_t GetFeedbackHeight() const { return m_feedbackHeight; }
+    const ShaderInfo& GetShaderInfo() const { return m_shaderInfo; }
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+    // GLSL 4.50 functions for sampling the virtual texture and writing feedback. Define VIRTUAL_TEXTURE_INFO_BINDING,
+    // VIRTUAL_TEXTURE_PAGE_TABLE_BINDING and VIRTUAL_TEXTURE_PHYSICAL_CACHE_BINDING before this source.
+    // The feedback image must be cleared to (0, 0, 0, 0) before the feedback pass.
+    static const char* GetGLSLSource();
+
+    // Writes an RGBA8 image of width x height texels as a page file. width, height and pageSize must be powers of two,
+    // with width and height no smaller than pageSize. Lower mip levels are generated with a box filter.
+    static bool WritePageFile(const std::string& path, const uint8_t* rgba8, uint32_t width, uint32_t height, uint32_t pageSize);
+
+private:
+    struct PageFileHeader {
+        char magic[4];
+        uint32_t width;
+        uint32_t height;
+        uint32_t pageSize;
+        uint32_t mipCount;
+        uint32_t pageCount;
+    };
+
+    // Pages are identified by a key of (mip << 24 | y << 12 | x).
+    static uint32_t PageKey(uint32_t mip, uint32_t x, uint32_t y) { return (mip << 24) | (y << 12) | x; }
+    static uint32_t PageKeyMip(uint32_t key) { return key >> 24; }
+    static uint32_t PageKeyX(uint32_t key) { return key & 0xFFF; }
+    static uint32_t PageKeyY(uint32_t key) { return (key >> 12) & 0xFFF; }
+    uint32_t PageCountX(uint32_t mip) const { return std::max(m_pageCountX >> mip, 1u); }
+    uint32_t PageCountY(uint32_t mip) const { return std::max(m_pageCountY >> mip, 1u); }
+    size_t PageFileOffset(uint32_t key) const;
+
+    struct LoadedPage {
+        uint32_t key;
+        std::vector<uint8_t> data;
+    };
+    bool ReadPage(std::ifstream& file, uint32_t key, std::vector<uint8_t>& data) const;
+    void ProcessFeedback(const uint8_t* feedback);
+    void RequestPages();
+    void LoadPage(uint32_t key);
+    void UploadPages();
+    void UploadPage(uint32_t slot, const std::vector<uint8_t>& data, uint32_t stagingIndex);
+    uint32_t AllocateSlot();
+    void MarkPageTableDirty(uint32_t key);
+    void UpdatePageTable();
+
+    GraphicsAPI* m_graphicsAPI = nullptr;
+    CreateInfo m_createInfo;
+    PageFileHeader m_header{};
+    std::vector<size_t> m_mipFirstPage;
+    uint32_t m_pageCountX = 0;
+    uint32_t m_pageCountY = 0;
+    size_t m_pageBytes = 0;
+    uint32_t m_feedbackWidth = 0;
+    uint32_t m_feedbackHeight = 0;
+    ShaderInfo m_shaderInfo{};
+    Statistics m_statistics{};
+    uint64_t m_frameIndex = 0;
+
+    void* m_pageTableImage = nullptr;
+    void* m_physicalCacheImage = nullptr;
+    void* m_feedbackImage = nullptr;
+    void* m_feedbackImageView = nullptr;
+    void* m_pageTableSampler = nullptr;
+    void* m_physicalCacheSampler = nullptr;
+    void* m_pageStagingBuffer = nullptr;
+    void* m_pageTableStagingBuffer = nullptr;
+
+    // Feedback readbacks in flight. A slot is free when its fence is nullptr.
+    static constexpr uint32_t readbackCount = 3;
+    void* m_readbackBuffers[readbackCount] = {};
+    void* m_readbackFences[readbackCount] = {};
+    uint32_t m_nextReadback = 0;
+
+    // Physical cache slots: The page in each slot, the frame it was last requested in and the key to slot mapping.
+    static constexpr uint32_t invalidPage = ~0u;
+    std::vector<uint32_t> m_slotPages;
+    std::vector<uint64_t> m_slotLastUsed;
+    std::vector<uint32_t> m_freeSlots;
+    std::unordered_map<uint32_t, uint32_t> m_residentPages;
+
+    // Page table entries for all mip levels, packed as RGBA8 (slot x, slot y, resident mip, 255), and the page rectangle
+    // [begin, end) of each mip level that has to be updated.
+    struct DirtyRegion {
+        uint32_t beginX;
+        uint32_t beginY;
+        uint32_t endX;
+        uint32_t endY;
+    };
+    std::vector<std::vector<uint32_t>> m_pageTable;
+    std::vector<DirtyRegion> m_dirtyRegions;
+
+    // Pages requested by the last processed feedback and their request counts.
+    std::unordered_map<uint32_t, uint32_t> m_requestCounts;
+    std::unordered_set<uint32_t> m_pendingPages;
+    std::deque<uint32_t> m_prefetchPages;
+    std::mutex m_loadedPagesMutex;
+    std::vector<LoadedPage> m_loadedPages;
+    std::atomic<bool> m_cancelLoads{false};
+
+    // Declared last, so that it is destroyed first and no load job outlives the members it uses.
+    std::unique_ptr<JobSystem> m_ioJobs;
+};
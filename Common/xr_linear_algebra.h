@@ -0,0 +1,362 @@
+// Copyright 2023, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// OpenXR Tutorial for Khronos Group
+
+// Linear algebra helpers for the OpenXR types, modelled on the OpenXR SDK's xr_linear.h.
+// xr_linear.h declares an enum named GraphicsAPI, which collides with the GraphicsAPI class, so this header uses GraphicsAPI_Type instead.
+// All matrices are column-major, i.e. m[column * 4 + row].
+
+#pragma once
+#include <GraphicsAPI.h>
+
+#include <cmath>
+
+#define MATH_PI 3.14159265358979323846f
+
+// XR_DOCS_TAG_BEGIN_XrMatrix4x4f
+typedef struct XrMatrix4x4f {
+    float m[16];
+} XrMatrix4x4f;
+// XR_DOCS_TAG_END_XrMatrix4x4f
+
+#pragma region XrVector3f
+inline void XrVector3f_Set(XrVector3f* v, const float value) {
+    v->x = value;
+    v->y = value;
+    v->z = value;
+}
+
+inline void XrVector3f_Add(XrVector3f* result, const XrVector3f* a, const XrVector3f* b) {
+    result->x = a->x + b->x;
+    result->y = a->y + b->y;
+    result->z = a->z + b->z;
+}
+
+inline void XrVector3f_Sub(XrVector3f* result, const XrVector3f* a, const XrVector3f* b) {
+    result->x = a->x - b->x;
+    result->y = a->y - b->y;
+    result->z = a->z - b->z;
+}
+
+inline void XrVector3f_Scale(XrVector3f* result, const XrVector3f* a, const float scaleFactor) {
+    result->x = a->x * scaleFactor;
+    result->y = a->y * scaleFactor;
+    result->z = a->z * scaleFactor;
+}
+
+inline void XrVector3f_Lerp(XrVector3f* result, const XrVector3f* a, const XrVector3f* b, const float fraction) {
+    result->x = a->x + fraction * (b->x - a->x);
+    result->y = a->y + fraction * (b->y - a->y);
+    result->z = a->z + fraction * (b->z - a->z);
+}
+
+inline float XrVector3f_Dot(const XrVector3f* a, const XrVector3f* b) {
+    return a->x * b->x + a->y * b->y + a->z * b->z;
+}
+
+inline void XrVector3f_Cross(XrVector3f* result, const XrVector3f* a, const XrVector3f* b) {
+    result->x = a->y * b->z - a->z * b->y;
+    result->y = a->z * b->x - a->x * b->z;
+    result->z = a->x * b->y - a->y * b->x;
+}
+
+inline float XrVector3f_Length(const XrVector3f* v) {
+    return sqrtf(v->x * v->x + v->y * v->y + v->z * v->z);
+}
+
+inline void XrVector3f_Normalize(XrVector3f* v) {
+    const float length = XrVector3f_Length(v);
+    if (length > 0.0f) {
+        XrVector3f_Scale(v, v, 1.0f / length);
+    }
+}
+#pragma endregion
+
+#pragma region XrQuaternionf
+inline void XrQuaternionf_CreateIdentity(XrQuaternionf* q) {
+    q->x = 0.0f;
+    q->y = 0.0f;
+    q->z = 0.0f;
+    q->w = 1.0f;
+}
+
+inline void XrQuaternionf_CreateFromAxisAngle(XrQuaternionf* result, const XrVector3f* axis, const float angleInRadians) {
+    XrVector3f normalizedAxis = *axis;
+    XrVector3f_Normalize(&normalizedAxis);
+    const float s = sinf(angleInRadians / 2.0f);
+    result->x = s * normalizedAxis.x;
+    result->y = s * normalizedAxis.y;
+    result->z = s * normalizedAxis.z;
+    result->w = cosf(angleInRadians / 2.0f);
+}
+
+inline void XrQuaternionf_Multiply(XrQuaternionf* result, const XrQuaternionf* a, const XrQuaternionf* b) {
+    const XrQuaternionf r = {
+        (b->w * a->x) + (b->x * a->w) + (b->y * a->z) - (b->z * a->y),
+        (b->w * a->y) - (b->x * a->z) + (b->y * a->w) + (b->z * a->x),
+        (b->w * a->z) + (b->x * a->y) - (b->y * a->x) + (b->z * a->w),
+        (b->w * a->w) - (b->x * a->x) - (b->y * a->y) - (b->z * a->z)};
+    *result = r;
+}
+
+inline void XrQuaternionf_Invert(XrQuaternionf* result, const XrQuaternionf* q) {
+    result->x = -q->x;
+    result->y = -q->y;
+    result->z = -q->z;
+    result->w = q->w;
+}
+
+inline void XrQuaternionf_Normalize(XrQuaternionf* q) {
+    const float length = sqrtf(q->x * q->x + q->y * q->y + q->z * q->z + q->w * q->w);
+    if (length > 0.0f) {
+        q->x /= length;
+        q->y /= length;
+        q->z /= length;
+        q->w /= length;
+    }
+}
+
+// Normalized linear interpolation, taking the shortest path.
+inline void XrQuaternionf_Lerp(XrQuaternionf* result, const XrQuaternionf* a, const XrQuaternionf* b, const float fraction) {
+    const float s = a->x * b->x + a->y * b->y + a->z * b->z + a->w * b->w;
+    const float fa = 1.0f - fraction;
+    const float fb = (s < 0.0f) ? -fraction : fraction;
+    result->x = fa * a->x + fb * b->x;
+    result->y = fa * a->y + fb * b->y;
+    result->z = fa * a->z + fb * b->z;
+    result->w = fa * a->w + fb * b->w;
+    XrQuaternionf_Normalize(result);
+}
+
+inline void XrQuaternionf_RotateVector3f(XrVector3f* result, const XrQuaternionf* q, const XrVector3f* v) {
+    // v' = v + 2w(q x v) + 2(q x (q x v))
+    const XrVector3f u = {q->x, q->y, q->z};
+    XrVector3f uv, uuv;
+    XrVector3f_Cross(&uv, &u, v);
+    XrVector3f_Cross(&uuv, &u, &uv);
+    result->x = v->x + 2.0f * (q->w * uv.x + uuv.x);
+    result->y = v->y + 2.0f * (q->w * uv.y + uuv.y);
+    result->z = v->z + 2.0f * (q->w * uv.z + uuv.z);
+}
+#pragma endregion
+
+#pragma region XrMatrix4x4f
+inline void XrMatrix4x4f_CreateIdentity(XrMatrix4x4f* result) {
+    for (int i = 0; i < 16; i++) {
+        result->m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+inline void XrMatrix4x4f_CreateTranslation(XrMatrix4x4f* result, const float x, const float y, const float z) {
+    XrMatrix4x4f_CreateIdentity(result);
+    result->m[12] = x;
+    result->m[13] = y;
+    result->m[14] = z;
+}
+
+inline void XrMatrix4x4f_CreateScale(XrMatrix4x4f* result, const float x, const float y, const float z) {
+    XrMatrix4x4f_CreateIdentity(result);
+    result->m[0] = x;
+    result->m[5] = y;
+    result->m[10] = z;
+}
+
+inline void XrMatrix4x4f_CreateFromQuaternion(XrMatrix4x4f* result, const XrQuaternionf* q) {
+    const float x2 = q->x + q->x;
+    const float y2 = q->y + q->y;
+    const float z2 = q->z + q->z;
+
+    const float xx2 = q->x * x2;
+    const float yy2 = q->y * y2;
+    const float zz2 = q->z * z2;
+
+    const float yz2 = q->y * z2;
+    const float wx2 = q->w * x2;
+    const float xy2 = q->x * y2;
+    const float wz2 = q->w * z2;
+    const float xz2 = q->x * z2;
+    const float wy2 = q->w * y2;
+
+    result->m[0] = 1.0f - yy2 - zz2;
+    result->m[1] = xy2 + wz2;
+    result->m[2] = xz2 - wy2;
+    result->m[3] = 0.0f;
+
+    result->m[4] = xy2 - wz2;
+    result->m[5] = 1.0f - xx2 - zz2;
+    result->m[6] = yz2 + wx2;
+    result->m[7] = 0.0f;
+
+    result->m[8] = xz2 + wy2;
+    result->m[9] = yz2 - wx2;
+    result->m[10] = 1.0f - xx2 - yy2;
+    result->m[11] = 0.0f;
+
+    result->m[12] = 0.0f;
+    result->m[13] = 0.0f;
+    result->m[14] = 0.0f;
+    result->m[15] = 1.0f;
+}
+
+inline void XrMatrix4x4f_Multiply(XrMatrix4x4f* result, const XrMatrix4x4f* a, const XrMatrix4x4f* b) {
+    XrMatrix4x4f r;
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            r.m[column * 4 + row] = a->m[0 * 4 + row] * b->m[column * 4 + 0] +
+                                    a->m[1 * 4 + row] * b->m[column * 4 + 1] +
+                                    a->m[2 * 4 + row] * b->m[column * 4 + 2] +
+                                    a->m[3 * 4 + row] * b->m[column * 4 + 3];
+        }
+    }
+    *result = r;
+}
+
+inline void XrMatrix4x4f_CreateTranslationRotationScale(XrMatrix4x4f* result, const XrVector3f* translation, const XrQuaternionf* rotation, const XrVector3f* scale) {
+    XrMatrix4x4f scaleMatrix;
+    XrMatrix4x4f_CreateScale(&scaleMatrix, scale->x, scale->y, scale->z);
+
+    XrMatrix4x4f rotationMatrix;
+    XrMatrix4x4f_CreateFromQuaternion(&rotationMatrix, rotation);
+
+    XrMatrix4x4f translationMatrix;
+    XrMatrix4x4f_CreateTranslation(&translationMatrix, translation->x, translation->y, translation->z);
+
+    XrMatrix4x4f combinedMatrix;
+    XrMatrix4x4f_Multiply(&combinedMatrix, &rotationMatrix, &scaleMatrix);
+    XrMatrix4x4f_Multiply(result, &translationMatrix, &combinedMatrix);
+}
+
+inline void XrMatrix4x4f_CreateFromRigidTransform(XrMatrix4x4f* result, const XrPosef* pose) {
+    const XrVector3f identityScale = {1.0f, 1.0f, 1.0f};
+    XrMatrix4x4f_CreateTranslationRotationScale(result, &pose->position, &pose->orientation, &identityScale);
+}
+
+// Inverts a matrix that only contains a rotation and translation.
+inline void XrMatrix4x4f_InvertRigidBody(XrMatrix4x4f* result, const XrMatrix4x4f* src) {
+    result->m[0] = src->m[0];
+    result->m[1] = src->m[4];
+    result->m[2] = src->m[8];
+    result->m[3] = 0.0f;
+    result->m[4] = src->m[1];
+    result->m[5] = src->m[5];
+    result->m[6] = src->m[9];
+    result->m[7] = 0.0f;
+    result->m[8] = src->m[2];
+    result->m[9] = src->m[6];
+    result->m[10] = src->m[10];
+    result->m[11] = 0.0f;
+    result->m[12] = -(src->m[0] * src->m[12] + src->m[1] * src->m[13] + src->m[2] * src->m[14]);
+    result->m[13] = -(src->m[4] * src->m[12] + src->m[5] * src->m[13] + src->m[6] * src->m[14]);
+    result->m[14] = -(src->m[8] * src->m[12] + src->m[9] * src->m[13] + src->m[10] * src->m[14]);
+    result->m[15] = 1.0f;
+}
+
+// General 4x4 inverse using cofactors.
+inline void XrMatrix4x4f_Invert(XrMatrix4x4f* result, const XrMatrix4x4f* src) {
+    const float* m = src->m;
+    float inv[16];
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float determinant = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    float invDeterminant = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+    for (int i = 0; i < 16; i++) {
+        result->m[i] = inv[i] * invDeterminant;
+    }
+}
+
+// Transforms a point, including the perspective divide.
+inline void XrMatrix4x4f_TransformVector3f(XrVector3f* result, const XrMatrix4x4f* m, const XrVector3f* v) {
+    const float w = m->m[3] * v->x + m->m[7] * v->y + m->m[11] * v->z + m->m[15];
+    const float rcpW = w != 0.0f ? 1.0f / w : 1.0f;
+    result->x = (m->m[0] * v->x + m->m[4] * v->y + m->m[8] * v->z + m->m[12]) * rcpW;
+    result->y = (m->m[1] * v->x + m->m[5] * v->y + m->m[9] * v->z + m->m[13]) * rcpW;
+    result->z = (m->m[2] * v->x + m->m[6] * v->y + m->m[10] * v->z + m->m[14]) * rcpW;
+}
+
+// XR_DOCS_TAG_BEGIN_XrMatrix4x4f_CreateProjectionFov
+// Creates a projection matrix based on the specified FOV.
+// A farZ less than or equal to nearZ creates an infinite projection matrix.
+inline void XrMatrix4x4f_CreateProjectionFov(XrMatrix4x4f* result, GraphicsAPI_Type graphicsApi, const XrFovf fov, const float nearZ, const float farZ) {
+    const float tanAngleLeft = tanf(fov.angleLeft);
+    const float tanAngleRight = tanf(fov.angleRight);
+    const float tanAngleDown = tanf(fov.angleDown);
+    const float tanAngleUp = tanf(fov.angleUp);
+
+    const float tanAngleWidth = tanAngleRight - tanAngleLeft;
+
+    // Set to tanAngleDown - tanAngleUp for a clip space with positive Y down (Vulkan).
+    // Set to tanAngleUp - tanAngleDown for a clip space with positive Y up (OpenGL / D3D).
+    const float tanAngleHeight = graphicsApi == VULKAN ? (tanAngleDown - tanAngleUp) : (tanAngleUp - tanAngleDown);
+
+    // Set to nearZ for a [-1,1] Z clip space (OpenGL / OpenGL ES).
+    // Set to zero for a [0,1] Z clip space (Vulkan / D3D).
+    const float offsetZ = (graphicsApi == OPENGL || graphicsApi == OPENGL_ES) ? nearZ : 0;
+
+    result->m[0] = 2.0f / tanAngleWidth;
+    result->m[4] = 0.0f;
+    result->m[8] = (tanAngleRight + tanAngleLeft) / tanAngleWidth;
+    result->m[12] = 0.0f;
+
+    result->m[1] = 0.0f;
+    result->m[5] = 2.0f / tanAngleHeight;
+    result->m[9] = (tanAngleUp + tanAngleDown) / tanAngleHeight;
+    result->m[13] = 0.0f;
+
+    result->m[2] = 0.0f;
+    result->m[6] = 0.0f;
+    if (farZ <= nearZ) {
+        // Place the far plane at infinity.
+        result->m[10] = -1.0f;
+        result->m[14] = -(nearZ + offsetZ);
+    } else {
+        // Normal projection.
+        result->m[10] = -(farZ + offsetZ) / (farZ - nearZ);
+        result->m[14] = -(farZ * (nearZ + offsetZ)) / (farZ - nearZ);
+    }
+
+    result->m[3] = 0.0f;
+    result->m[7] = 0.0f;
+    result->m[11] = -1.0f;
+    result->m[15] = 0.0f;
+}
+// XR_DOCS_TAG_END_XrMatrix4x4f_CreateProjectionFov
+
+// Extracts the six normalized frustum planes (left, right, bottom, top, near, far) from a view-projection matrix.
+// Each plane is stored as (a, b, c, d) such that a point p is inside when dot(abc, p) + d >= 0.
+// The near plane assumes a [-1,1] Z clip space (OpenGL / OpenGL ES).
+inline void XrMatrix4x4f_GetFrustumPlanes(float planes[6][4], const XrMatrix4x4f* viewProjection) {
+    const float* m = viewProjection->m;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            // Row 3 +/- row i.
+            planes[i * 2 + 0][j] = m[j * 4 + 3] + m[j * 4 + i];
+            planes[i * 2 + 1][j] = m[j * 4 + 3] - m[j * 4 + i];
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        const float length = sqrtf(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+        if (length > 0.0f) {
+            for (int j = 0; j < 4; j++) {
+                planes[i][j] /= length;
+            }
+        }
+    }
+}
+#pragma endregion